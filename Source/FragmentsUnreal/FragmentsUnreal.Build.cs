@@ -48,6 +48,8 @@ public class FragmentsUnreal : ModuleRules
 				"InputCore",
 				"CoreUObject",
 				"Engine",
+				"RenderCore",
+				"PhysicsCore",
 				"Slate",
 				"SlateCore"
 				// ... add private dependencies that you statically link with here ...	
@@ -65,17 +67,6 @@ public class FragmentsUnreal : ModuleRules
 		// Zlib (Unreal dependency)
         AddEngineThirdPartyPrivateStaticDependencies(Target, "zlib");
 
-		// Platform-specific libtess2 static libs
-        string TessLibPath_Win64 = Path.Combine(ModuleDirectory, "../../ThirdParty/libtess2/Lib/Win64");
-        string TessLibPath_Android = Path.Combine(ModuleDirectory, "../../ThirdParty/libtess2/Lib/Android/ARM64");
-		
-		if (Target.Platform == UnrealTargetPlatform.Win64)
-		{
-			PublicAdditionalLibraries.Add(Path.Combine(TessLibPath_Win64, "tess2.lib"));
-		}
-		else if (Target.Platform == UnrealTargetPlatform.Android)
-		{
-			PublicAdditionalLibraries.Add(Path.Combine(TessLibPath_Android, "libtess2.a"));
-		}
+		// libtess2 is built from source for every platform (see Private/ThirdParty/LibTess2.c)
     }
 }
@@ -0,0 +1,259 @@
+#include "Importer/FragmentDerivedMeshCache.h"
+#include "Importer/FragmentMeshBuilder.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/Guid.h"
+#include "Misc/Crc.h"
+#include "EngineDefines.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFragmentMeshCache, Log, All);
+
+namespace
+{
+	/** "FDMC" */
+	constexpr uint32 CacheMagic = 0x434D4446;
+
+	/** Bump when the file layout or the builders' output changes */
+	constexpr uint32 CacheVersion = 2;
+
+	template <typename T>
+	void HashValue(uint32& Hash, const T& Value)
+	{
+		Hash = FCrc::MemCrc32(&Value, sizeof(Value), Hash);
+	}
+
+	void SerializeLods(FArchive& Ar, TArray<FFragmentMeshLodData>& Lods, FBox3f& Bounds)
+	{
+		int32 LodCount = Lods.Num();
+		Ar << LodCount;
+		if (Ar.IsLoading())
+		{
+			if (LodCount <= 0 || LodCount > MAX_STATIC_MESH_LODS)
+			{
+				Ar.SetError();
+				return;
+			}
+			Lods.SetNum(LodCount);
+		}
+
+		for (FFragmentMeshLodData& Lod : Lods)
+		{
+			Lod.Positions.BulkSerialize(Ar);
+			Lod.Normals.BulkSerialize(Ar);
+			Lod.Tangents.BulkSerialize(Ar);
+			Lod.Indices.BulkSerialize(Ar);
+			Ar << Lod.ScreenSize;
+		}
+
+		Ar << Bounds.Min << Bounds.Max << Bounds.IsValid;
+	}
+
+	/** Reject entries whose buffers do not describe a drawable mesh */
+	bool AreLodsConsistent(const TArray<FFragmentMeshLodData>& Lods)
+	{
+		for (const FFragmentMeshLodData& Lod : Lods)
+		{
+			const int32 VertexCount = Lod.Positions.Num();
+			if (!Lod.IsValid() || Lod.Indices.Num() % 3 != 0
+				|| Lod.Normals.Num() != VertexCount || Lod.Tangents.Num() != VertexCount)
+			{
+				return false;
+			}
+			for (uint32 Index : Lod.Indices)
+			{
+				if (Index >= static_cast<uint32>(VertexCount))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+}
+
+uint32 FFragmentDerivedMeshCache::HashOptions(const FFragmentMeshBuildOptions& Options)
+{
+	uint32 Hash = 0;
+	HashValue(Hash, CacheVersion);
+	HashValue(Hash, Options.Backend);
+	HashValue(Hash, Options.CircleExtrusionLodCount);
+	HashValue(Hash, Options.CircleTolerance);
+	HashValue(Hash, Options.LodPixelError);
+	HashValue(Hash, Options.ReferenceViewportHeight);
+	HashValue(Hash, Options.bGenerateShellLods);
+	if (Options.bGenerateShellLods)
+	{
+		HashValue(Hash, Options.ShellLodMinTriangles);
+		HashValue(Hash, Options.ShellLodCount);
+		HashValue(Hash, Options.ShellLodPixels);
+		HashValue(Hash, Options.ShellProxyPixels);
+	}
+	return Hash;
+}
+
+FString FFragmentDerivedMeshCache::GetModelDirectory(uint64 ModelHash)
+{
+	return FPaths::ProjectSavedDir() / TEXT("FragmentsMeshCache") / FString::Printf(TEXT("%016llx"), ModelHash);
+}
+
+FString FFragmentDerivedMeshCache::GetEntryFile(uint64 ModelHash, int32 RepresentationIndex, uint32 OptionsHash)
+{
+	return GetModelDirectory(ModelHash) / FString::Printf(TEXT("%d_%08x.bin"), RepresentationIndex, OptionsHash);
+}
+
+TSet<int32> FFragmentDerivedMeshCache::FindCachedRepresentations(uint64 ModelHash, uint32 OptionsHash)
+{
+	TSet<int32> Cached;
+
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(GetModelDirectory(ModelHash) / FString::Printf(TEXT("*_%08x.bin"), OptionsHash)), true, false);
+
+	for (const FString& FileName : Files)
+	{
+		FString IndexPart;
+		if (FileName.Split(TEXT("_"), &IndexPart, nullptr) && IndexPart.IsNumeric())
+		{
+			Cached.Add(FCString::Atoi(*IndexPart));
+		}
+	}
+	return Cached;
+}
+
+bool FFragmentDerivedMeshCache::Load(const FString& File, FFragmentMeshBuildData& OutData)
+{
+	OutData.Lods.Reset();
+	OutData.Bounds = FBox3f(ForceInit);
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*File, FILEREAD_Silent));
+	if (!Reader)
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	*Reader << Magic << Version;
+	if (Magic != CacheMagic || Version != CacheVersion)
+	{
+		UE_LOG(LogFragmentMeshCache, Warning, TEXT("Load: %s is not a current cache entry"), *File);
+		return false;
+	}
+
+	SerializeLods(*Reader, OutData.Lods, OutData.Bounds);
+	if (Reader->IsError() || !AreLodsConsistent(OutData.Lods))
+	{
+		UE_LOG(LogFragmentMeshCache, Warning, TEXT("Load: %s is damaged"), *File);
+		OutData.Lods.Reset();
+		return false;
+	}
+
+	return true;
+}
+
+bool FFragmentDerivedMeshCache::Store(const FString& File, const FFragmentMeshBuildData& Data)
+{
+	if (!Data.IsValid())
+	{
+		return false;
+	}
+
+	// Unique per writer: two workers may store the same representation
+	const FString TempFile = FString::Printf(TEXT("%s.%s.tmp"), *File, *FGuid::NewGuid().ToString());
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFile, FILEWRITE_Silent));
+		if (!Writer)
+		{
+			UE_LOG(LogFragmentMeshCache, Warning, TEXT("Store: Cannot write %s"), *TempFile);
+			return false;
+		}
+
+		uint32 Magic = CacheMagic;
+		uint32 Version = CacheVersion;
+		*Writer << Magic << Version;
+
+		// SerializeLods only reads from the data while saving
+		SerializeLods(*Writer, const_cast<TArray<FFragmentMeshLodData>&>(Data.Lods), const_cast<FBox3f&>(Data.Bounds));
+
+		if (!Writer->Close())
+		{
+			Writer.Reset();
+			IFileManager::Get().Delete(*TempFile, false, false, true);
+			return false;
+		}
+	}
+
+	if (!IFileManager::Get().Move(*File, *TempFile, /*bReplace=*/true, /*bEvenIfReadOnly=*/false, /*bAttributes=*/false, /*bDoNotRetryOrError=*/true))
+	{
+		IFileManager::Get().Delete(*TempFile, false, false, true);
+		return false;
+	}
+
+	return true;
+}
+
+int64 FFragmentDerivedMeshCache::Trim(int64 MaxBytes, const TSet<uint64>& KeepModelHashes)
+{
+	struct FModelDirectory
+	{
+		FString Path;
+		int64 Bytes = 0;
+		FDateTime LastWrite = FDateTime::MinValue();
+		bool bKeep = false;
+	};
+
+	const FString Root = FPaths::ProjectSavedDir() / TEXT("FragmentsMeshCache");
+	TArray<FString> DirectoryNames;
+	IFileManager::Get().FindFiles(DirectoryNames, *(Root / TEXT("*")), false, true);
+
+	TArray<FModelDirectory> Directories;
+	int64 TotalBytes = 0;
+	for (const FString& DirectoryName : DirectoryNames)
+	{
+		FModelDirectory& Directory = Directories.AddDefaulted_GetRef();
+		Directory.Path = Root / DirectoryName;
+		Directory.bKeep = KeepModelHashes.Contains(FCString::Strtoui64(*DirectoryName, nullptr, 16));
+
+		IFileManager::Get().IterateDirectoryStat(*Directory.Path,
+			[&Directory](const TCHAR*, const FFileStatData& Stat)
+			{
+				if (!Stat.bIsDirectory)
+				{
+					Directory.Bytes += Stat.FileSize;
+					Directory.LastWrite = FMath::Max(Directory.LastWrite, Stat.ModificationTime);
+				}
+				return true;
+			});
+		TotalBytes += Directory.Bytes;
+	}
+
+	if (TotalBytes <= MaxBytes)
+	{
+		return 0;
+	}
+
+	Directories.Sort([](const FModelDirectory& A, const FModelDirectory& B) { return A.LastWrite < B.LastWrite; });
+
+	int64 DeletedBytes = 0;
+	int32 DeletedDirectories = 0;
+	for (const FModelDirectory& Directory : Directories)
+	{
+		if (TotalBytes - DeletedBytes <= MaxBytes)
+		{
+			break;
+		}
+		if (Directory.bKeep)
+		{
+			continue;
+		}
+
+		if (IFileManager::Get().DeleteDirectory(*Directory.Path, false, true))
+		{
+			DeletedBytes += Directory.Bytes;
+			DeletedDirectories++;
+		}
+	}
+
+	UE_LOG(LogFragmentMeshCache, Log, TEXT("Trim: Deleted %d model directories (%lld MB), %lld MB kept (budget %lld MB)"),
+		DeletedDirectories, DeletedBytes / (1024 * 1024), (TotalBytes - DeletedBytes) / (1024 * 1024), MaxBytes / (1024 * 1024));
+	return DeletedBytes;
+}
@@ -0,0 +1,741 @@
+#include "Importer/FragmentMeshBuilder.h"
+#include "Importer/FragmentDerivedMeshCache.h"
+#include "Utils/FragmentsUtils.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshResources.h"
+#include "Async/Async.h"
+
+FFragmentMeshBuildData::FFragmentMeshBuildData() = default;
+FFragmentMeshBuildData::~FFragmentMeshBuildData() = default;
+
+namespace
+{
+	/** Upper bound for segments around a circle and along an arc */
+	constexpr int32 MaxCircleSegments = 32;
+
+	/** Segments needed so a chord of a circle of the given radius deviates at most Tolerance */
+	int32 SegmentsForTolerance(float Radius, float Tolerance, int32 MinSegments, int32 MaxSegments)
+	{
+		if (Tolerance >= Radius)
+		{
+			return MinSegments;
+		}
+		const float MaxStep = 2.0f * FMath::Acos(1.0f - Tolerance / Radius);
+		return FMath::Clamp(FMath::CeilToInt(2.0f * PI / MaxStep), MinSegments, MaxSegments);
+	}
+
+	/** Chord deviation of a circle of the given radius split into Segments over Angle radians */
+	float ChordError(float Radius, float Angle, int32 Segments)
+	{
+		return Radius * (1.0f - FMath::Cos(Angle / (2.0f * Segments)));
+	}
+
+	/**
+	 * Vertex normal of triangles wound CCW around WindingNormal (right-handed).
+	 * Every LOD goes through here so shading agrees across LOD switches: the engine
+	 * computes face normals as (P2 - P0) ^ (P1 - P0), the opposite of the right-handed one.
+	 */
+	FVector3f GetFaceNormal(const FVector3f& WindingNormal)
+	{
+		return -WindingNormal.GetSafeNormal();
+	}
+
+	/**
+	 * Append one flat-shaded triangle with its own three vertices.
+	 * @return false (nothing appended) if the triangle has no area
+	 */
+	bool AddFlatTriangle(FFragmentMeshLodData& OutLod, const FVector3f& P0, const FVector3f& P1, const FVector3f& P2)
+	{
+		const FVector3f Normal = GetFaceNormal(FVector3f::CrossProduct(P1 - P0, P2 - P0));
+		if (Normal.IsZero())
+		{
+			return false;
+		}
+		const FVector3f Tangent = (P1 - P0).GetSafeNormal();
+
+		const uint32 VertexBase = OutLod.Positions.Num();
+		for (const FVector3f& Position : { P0, P1, P2 })
+		{
+			OutLod.Positions.Add(Position);
+			OutLod.Normals.Add(Normal);
+			OutLod.Tangents.Add(Tangent);
+		}
+		OutLod.Indices.Add(VertexBase);
+		OutLod.Indices.Add(VertexBase + 1);
+		OutLod.Indices.Add(VertexBase + 2);
+		return true;
+	}
+
+	/**
+	 * Append the decimated LODs and the box proxy of a shell.
+	 * Everything is measured on the mesh itself (it is shared by every fragment using
+	 * the representation): a LOD's grid targets LodPixelError pixels when the mesh spans
+	 * its pixel budget, and it switches in where its measured deviation reaches LodPixelError.
+	 */
+	void BuildShellLods(const FFragmentMeshBuildOptions& Options, FFragmentMeshBuildData& OutData)
+	{
+		const float MeshSize = OutData.Bounds.GetSize().GetMax();
+		const float BoundsDiameter = 2.0f * OutData.Bounds.GetExtent().Size();
+		if (MeshSize <= KINDA_SMALL_NUMBER)
+		{
+			return;
+		}
+
+		float Pixels = Options.ShellLodPixels;
+		for (int32 i = 0; i < Options.ShellLodCount && OutData.Lods.Num() < MAX_STATIC_MESH_LODS - 1; i++, Pixels *= 0.5f)
+		{
+			if (Pixels <= Options.ShellProxyPixels)
+			{
+				break;
+			}
+
+			// Always simplify LOD0 so errors do not accumulate from LOD to LOD
+			FFragmentMeshLodData Lod;
+			float LodError = 0.0f;
+			const float CellSize = MeshSize * Options.LodPixelError / Pixels;
+			if (!FFragmentMeshBuilder::BuildDecimatedLod(OutData.Lods[0], CellSize, Lod, LodError))
+			{
+				break;
+			}
+
+			// A LOD must remove at least a quarter of the triangles to pay for itself;
+			// a coarser grid may still do so
+			const FFragmentMeshLodData& Previous = OutData.Lods.Last();
+			Lod.ScreenSize = FMath::Min(FFragmentMeshBuilder::ComputeLodScreenSize(LodError, BoundsDiameter, Options.LodPixelError, Options.ReferenceViewportHeight), 1.0f);
+			if (Lod.GetTriangleCount() * 4 > Previous.GetTriangleCount() * 3 || Lod.ScreenSize >= Previous.ScreenSize)
+			{
+				continue;
+			}
+
+			OutData.Lods.Add(MoveTemp(Lod));
+		}
+
+		if (Options.ShellProxyPixels > 0.0f && OutData.Lods.Last().GetTriangleCount() > 12)
+		{
+			// The box keeps nothing but the bounds: its deviation is taken as the whole mesh
+			// size, reaching ShellProxyPixels when the mesh spans that many pixels
+			FFragmentMeshLodData Proxy;
+			FFragmentMeshBuilder::BuildBoxProxyLod(OutData.Bounds, Proxy);
+			Proxy.ScreenSize = FMath::Min(FFragmentMeshBuilder::ComputeLodScreenSize(MeshSize, BoundsDiameter, Options.ShellProxyPixels, Options.ReferenceViewportHeight), 1.0f);
+			if (Proxy.IsValid() && Proxy.ScreenSize < OutData.Lods.Last().ScreenSize)
+			{
+				OutData.Lods.Add(MoveTemp(Proxy));
+			}
+		}
+	}
+
+	/**
+	 * Sweep a circle along a path and stitch consecutive rings.
+	 * The ring frame is parallel-transported so the tube does not twist, and
+	 * kept right-handed (X ^ Y == tangent) so triangles face outwards.
+	 */
+	void SweepCircle(const TArray<FVector>& Centers, const TArray<FVector>& Tangents, float Radius, int32 Segments, FFragmentMeshLodData& OutLod)
+	{
+		if (Centers.Num() < 2 || Radius <= 0.0f)
+		{
+			return;
+		}
+
+		FVector X, Y;
+		Tangents[0].FindBestAxisVectors(X, Y);
+
+		const uint32 VertexBase = OutLod.Positions.Num();
+		for (int32 k = 0; k < Centers.Num(); k++)
+		{
+			const FVector& Tangent = Tangents[k];
+			if (k > 0)
+			{
+				X = FQuat::FindBetweenNormals(Tangents[k - 1], Tangent).RotateVector(X);
+			}
+			X = (X - FVector::DotProduct(X, Tangent) * Tangent).GetSafeNormal();
+			Y = FVector::CrossProduct(Tangent, X);
+
+			for (int32 j = 0; j < Segments; j++)
+			{
+				const float Angle = 2.0f * PI * j / Segments;
+				const FVector Direction = FMath::Cos(Angle) * X + FMath::Sin(Angle) * Y;
+
+				OutLod.Positions.Add(FVector3f(Centers[k] + Direction * Radius));
+				OutLod.Normals.Add(FVector3f(Direction));
+				OutLod.Tangents.Add(FVector3f(Tangent));
+			}
+		}
+
+		for (int32 k = 0; k + 1 < Centers.Num(); k++)
+		{
+			const uint32 RingA = VertexBase + k * Segments;
+			const uint32 RingB = RingA + Segments;
+
+			for (int32 j = 0; j < Segments; j++)
+			{
+				const uint32 Next = (j + 1) % Segments;
+
+				OutLod.Indices.Add(RingA + j);
+				OutLod.Indices.Add(RingB + j);
+				OutLod.Indices.Add(RingA + Next);
+
+				OutLod.Indices.Add(RingA + Next);
+				OutLod.Indices.Add(RingB + j);
+				OutLod.Indices.Add(RingB + Next);
+			}
+		}
+	}
+}
+
+bool FFragmentMeshBuilder::BuildShellData(const FPreExtractedGeometry& Geometry, ETriangulationBackend Backend, FFragmentMeshLodData& OutLod)
+{
+	OutLod.Reset();
+
+	static const TArray<TArray<int32>> NoHoles;
+	static thread_local FTriangulationPolygon Polygon;
+
+	TArray<FVector> ProfileVertices;
+	TArray<int32> ProfileIndices;
+
+	for (int32 ProfileIdx = 0; ProfileIdx < Geometry.ProfileIndices.Num(); ProfileIdx++)
+	{
+		const TArray<int32>& Profile = Geometry.ProfileIndices[ProfileIdx];
+		if (Profile.Num() < 3)
+		{
+			continue;
+		}
+
+		const TArray<TArray<int32>>& Holes = Geometry.ProfileHoles.IsValidIndex(ProfileIdx) ? Geometry.ProfileHoles[ProfileIdx] : NoHoles;
+
+		// The projection plane is built once per profile and gives both the 2D
+		// frame for triangulation and the analytic face normal
+		if (!FTriangulation::PreparePolygon(Geometry.Vertices, Profile, Holes, Polygon))
+		{
+			continue;
+		}
+
+		ProfileVertices.Reset();
+		ProfileIndices.Reset();
+		if (!FTriangulation::TriangulatePrepared(Backend, Polygon, Geometry.Vertices, ProfileVertices, ProfileIndices))
+		{
+			continue;
+		}
+
+		// Triangles come out CCW around the plane normal; flip them if the
+		// profile was authored the other way round, so they keep the authored winding
+		const bool bFlip = Polygon.bOuterReversed;
+		const FVector WindingNormal = bFlip ? -Polygon.GetPlaneNormal() : Polygon.GetPlaneNormal();
+
+		// The vertex normal is the face normal of the emitted winding (the convention
+		// decimated LODs use too): it follows the winding, never the other way round
+		const FVector3f Normal = GetFaceNormal(FVector3f(WindingNormal));
+		const FVector3f Tangent = FVector3f(Polygon.Projection.AxisX);
+
+		// One vertex ring per profile, shared by all of its triangles
+		const uint32 VertexBase = OutLod.Positions.Num();
+		for (const FVector& Vertex : ProfileVertices)
+		{
+			OutLod.Positions.Add(FVector3f(Vertex));
+			OutLod.Normals.Add(Normal);
+			OutLod.Tangents.Add(Tangent);
+		}
+
+		for (int32 i = 0; i + 2 < ProfileIndices.Num(); i += 3)
+		{
+			OutLod.Indices.Add(VertexBase + ProfileIndices[i]);
+			OutLod.Indices.Add(VertexBase + ProfileIndices[bFlip ? i + 2 : i + 1]);
+			OutLod.Indices.Add(VertexBase + ProfileIndices[bFlip ? i + 1 : i + 2]);
+		}
+	}
+
+	return OutLod.IsValid();
+}
+
+bool FFragmentMeshBuilder::BuildCircleExtrusionData(const FPreExtractedGeometry& Geometry, float Tolerance, int32 MinSegments,
+	FFragmentMeshLodData& OutLod, float& OutMaxError)
+{
+	OutLod.Reset();
+	OutMaxError = 0.0f;
+
+	TArray<FVector> Centers;
+	TArray<FVector> Tangents;
+
+	for (const FPreExtractedExtrusionPart& Part : Geometry.ExtrusionParts)
+	{
+		Centers.Reset();
+		Tangents.Reset();
+
+		const int32 Segments = SegmentsForTolerance(Part.Radius, Tolerance, MinSegments, MaxCircleSegments);
+		OutMaxError = FMath::Max(OutMaxError, ChordError(Part.Radius, 2.0f * PI, Segments));
+
+		if (Part.Type == EExtrusionPartType::CircleCurve)
+		{
+			// The outer side of the bend deviates most
+			const float OuterRadius = Part.ArcRadius + Part.Radius;
+			const int32 FullCircleDivs = SegmentsForTolerance(OuterRadius, Tolerance, 1, MaxCircleSegments * 8);
+			const int32 ArcDivs = FMath::Clamp(FMath::CeilToInt(FullCircleDivs * Part.ArcAperture / (2.0f * PI)), 1, MaxCircleSegments);
+			OutMaxError = FMath::Max(OutMaxError, ChordError(OuterRadius, Part.ArcAperture, ArcDivs));
+
+			for (int32 j = 0; j <= ArcDivs; j++)
+			{
+				const float Angle = -Part.ArcAperture / 2.0f + Part.ArcAperture * j / ArcDivs;
+				const float Cos = FMath::Cos(Angle);
+				const float Sin = FMath::Sin(Angle);
+				Centers.Add(Part.ArcCenter + Part.ArcRadius * (Cos * Part.ArcXDirection + Sin * Part.ArcYDirection));
+				Tangents.Add((Cos * Part.ArcYDirection - Sin * Part.ArcXDirection).GetSafeNormal());
+			}
+		}
+		else
+		{
+			// Wires and wire sets: polyline without repeated points, central-difference tangents
+			for (const FVector& Point : Part.Points)
+			{
+				if (Centers.Num() == 0 || !Point.Equals(Centers.Last(), KINDA_SMALL_NUMBER))
+				{
+					Centers.Add(Point);
+				}
+			}
+			for (int32 k = 0; k < Centers.Num(); k++)
+			{
+				const FVector& Prev = Centers[FMath::Max(k - 1, 0)];
+				const FVector& Next = Centers[FMath::Min(k + 1, Centers.Num() - 1)];
+				Tangents.Add((Next - Prev).GetSafeNormal());
+			}
+		}
+
+		SweepCircle(Centers, Tangents, Part.Radius, Segments, OutLod);
+	}
+
+	return OutLod.IsValid();
+}
+
+bool FFragmentMeshBuilder::BuildDecimatedLod(const FFragmentMeshLodData& Source, float CellSize, FFragmentMeshLodData& OutLod, float& OutMaxError)
+{
+	OutLod.Reset();
+	OutMaxError = 0.0f;
+	if (!Source.IsValid() || CellSize <= KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	const FBox3f Bounds(Source.Positions);
+	const float InvCellSize = 1.0f / CellSize;
+
+	// Every vertex joins the cluster of its grid cell; clusters sit at the mean of their members
+	TMap<FIntVector, int32> CellToCluster;
+	TArray<FVector3f> ClusterPositions;
+	TArray<int32> ClusterSizes;
+	TArray<int32> VertexClusters;
+	VertexClusters.SetNumUninitialized(Source.Positions.Num());
+
+	for (int32 i = 0; i < Source.Positions.Num(); i++)
+	{
+		const FVector3f& Position = Source.Positions[i];
+		const FVector3f Local = (Position - Bounds.Min) * InvCellSize;
+		const FIntVector Cell(FMath::FloorToInt(Local.X), FMath::FloorToInt(Local.Y), FMath::FloorToInt(Local.Z));
+
+		int32 Cluster;
+		if (const int32* Existing = CellToCluster.Find(Cell))
+		{
+			Cluster = *Existing;
+		}
+		else
+		{
+			Cluster = CellToCluster.Add(Cell, ClusterPositions.Num());
+			ClusterPositions.Add(FVector3f::ZeroVector);
+			ClusterSizes.Add(0);
+		}
+
+		ClusterPositions[Cluster] += Position;
+		ClusterSizes[Cluster]++;
+		VertexClusters[i] = Cluster;
+	}
+
+	for (int32 c = 0; c < ClusterPositions.Num(); c++)
+	{
+		ClusterPositions[c] /= static_cast<float>(ClusterSizes[c]);
+	}
+
+	// Deviation: how far any source vertex moved onto its cluster
+	float MaxErrorSquared = 0.0f;
+	for (int32 i = 0; i < Source.Positions.Num(); i++)
+	{
+		MaxErrorSquared = FMath::Max(MaxErrorSquared, FVector3f::DistSquared(Source.Positions[i], ClusterPositions[VertexClusters[i]]));
+	}
+	OutMaxError = FMath::Sqrt(MaxErrorSquared);
+
+	// Triangles spanning three clusters survive, each oriented triangle once.
+	// Both sides of thin plates differ in orientation and are kept.
+	TSet<FIntVector> EmittedTriangles;
+	for (int32 i = 0; i + 2 < Source.Indices.Num(); i += 3)
+	{
+		int32 C0 = VertexClusters[Source.Indices[i]];
+		int32 C1 = VertexClusters[Source.Indices[i + 1]];
+		int32 C2 = VertexClusters[Source.Indices[i + 2]];
+		if (C0 == C1 || C1 == C2 || C0 == C2)
+		{
+			continue;
+		}
+
+		// Rotate the smallest cluster to the front: one key per orientation
+		while (C0 > C1 || C0 > C2)
+		{
+			const int32 First = C0;
+			C0 = C1;
+			C1 = C2;
+			C2 = First;
+		}
+
+		bool bAlreadyEmitted = false;
+		EmittedTriangles.Add(FIntVector(C0, C1, C2), &bAlreadyEmitted);
+		if (!bAlreadyEmitted)
+		{
+			AddFlatTriangle(OutLod, ClusterPositions[C0], ClusterPositions[C1], ClusterPositions[C2]);
+		}
+	}
+
+	return OutLod.IsValid();
+}
+
+void FFragmentMeshBuilder::BuildBoxProxyLod(const FBox3f& Bounds, FFragmentMeshLodData& OutLod)
+{
+	OutLod.Reset();
+
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		const int32 U = (Axis + 1) % 3;
+		const int32 V = (Axis + 2) % 3;
+
+		for (int32 Side = 0; Side < 2; Side++)
+		{
+			FVector3f Outward = FVector3f::ZeroVector;
+			Outward[Axis] = Side ? 1.0f : -1.0f;
+
+			FVector3f Quad[4];
+			for (int32 Corner = 0; Corner < 4; Corner++)
+			{
+				Quad[Corner][Axis] = Side ? Bounds.Max[Axis] : Bounds.Min[Axis];
+				Quad[Corner][U] = (Corner == 1 || Corner == 2) ? Bounds.Max[U] : Bounds.Min[U];
+				Quad[Corner][V] = (Corner >= 2) ? Bounds.Max[V] : Bounds.Min[V];
+			}
+
+			// Wind the quad so the engine face normal points out of the box
+			if (FVector3f::DotProduct(FVector3f::CrossProduct(Quad[2] - Quad[0], Quad[1] - Quad[0]), Outward) < 0.0f)
+			{
+				Swap(Quad[1], Quad[3]);
+			}
+
+			// Faces of a flat box have no area and are skipped
+			AddFlatTriangle(OutLod, Quad[0], Quad[1], Quad[2]);
+			AddFlatTriangle(OutLod, Quad[0], Quad[2], Quad[3]);
+		}
+	}
+}
+
+float FFragmentMeshBuilder::ComputeLodScreenSize(float Error, float BoundsDiameter, float PixelError, float ViewportHeight)
+{
+	// CalculateScreenSize maps a length L at distance D to L / (D * tan(FOV/2)) * ViewportHeight
+	// pixels, while the engine's LOD screen size is (BoundsDiameter / 2) / (D * tan(FOV/2)).
+	// Solving Error * 2 * ScreenSize / BoundsDiameter * ViewportHeight == PixelError:
+	if (Error <= KINDA_SMALL_NUMBER || ViewportHeight <= 0.0f)
+	{
+		return 0.0f;
+	}
+	return PixelError * BoundsDiameter / (2.0f * Error * ViewportHeight);
+}
+
+bool FFragmentMeshBuilder::BuildGeometryData(const FPreExtractedGeometry& Geometry, const FFragmentMeshBuildOptions& Options, FFragmentMeshBuildData& OutData)
+{
+	OutData.Lods.Reset();
+	OutData.Bounds = FBox3f(ForceInit);
+
+	FFragmentMeshLodData& Lod0 = OutData.Lods.AddDefaulted_GetRef();
+	float Lod0Error = 0.0f;
+	const bool bBuilt = Geometry.bIsShell
+		? BuildShellData(Geometry, Options.Backend, Lod0)
+		: BuildCircleExtrusionData(Geometry, Options.CircleTolerance, 6, Lod0, Lod0Error);
+
+	if (!bBuilt)
+	{
+		return false;
+	}
+
+	for (const FVector3f& Position : Lod0.Positions)
+	{
+		OutData.Bounds += Position;
+	}
+
+	if (Geometry.bIsShell)
+	{
+		if (Options.bGenerateShellLods && OutData.Lods[0].GetTriangleCount() >= Options.ShellLodMinTriangles)
+		{
+			BuildShellLods(Options, OutData);
+		}
+		return true;
+	}
+
+	// Coarser extrusion LODs: each quadruples the tolerance (halving the segment count)
+	// and takes over once its deviation drops below LodPixelError on screen
+	const float BoundsDiameter = 2.0f * OutData.Bounds.GetExtent().Size();
+	float Tolerance = Options.CircleTolerance;
+
+	for (int32 LodIndex = 1; LodIndex < FMath::Min(Options.CircleExtrusionLodCount, MAX_STATIC_MESH_LODS); LodIndex++)
+	{
+		Tolerance *= 4.0f;
+
+		FFragmentMeshLodData Lod;
+		float LodError = 0.0f;
+		if (!BuildCircleExtrusionData(Geometry, Tolerance, 3, Lod, LodError))
+		{
+			break;
+		}
+
+		// Stop once the segment counts bottom out or the switch distance stops growing
+		const FFragmentMeshLodData& Previous = OutData.Lods.Last();
+		Lod.ScreenSize = FMath::Min(ComputeLodScreenSize(LodError, BoundsDiameter, Options.LodPixelError, Options.ReferenceViewportHeight), 1.0f);
+		if (Lod.GetTriangleCount() >= Previous.GetTriangleCount() || Lod.ScreenSize >= Previous.ScreenSize)
+		{
+			break;
+		}
+
+		OutData.Lods.Add(MoveTemp(Lod));
+	}
+
+	return true;
+}
+
+bool FFragmentMeshBuilder::BuildMergedData(const TArray<FFragmentMergeElement>& Elements, const FFragmentMeshBuildOptions& Options, FFragmentMeshBuildData& OutData)
+{
+	OutData.Lods.Reset();
+	OutData.Elements.Reset();
+	OutData.Bounds = FBox3f(ForceInit);
+
+	// Merged meshes are drawn close up only: full detail, no LOD chain
+	FFragmentMeshBuildOptions ElementOptions = Options;
+	ElementOptions.CircleExtrusionLodCount = 1;
+	ElementOptions.bGenerateShellLods = false;
+
+	FFragmentMeshLodData& Merged = OutData.Lods.AddDefaulted_GetRef();
+	TMap<int32, FFragmentMeshBuildData> RepresentationData;
+	FFragmentMeshBuildData ScratchData;
+
+	for (const FFragmentMergeElement& Element : Elements)
+	{
+		const FFragmentMeshBuildData* Source = nullptr;
+		if (Element.RepresentationId != INDEX_NONE)
+		{
+			Source = RepresentationData.Find(Element.RepresentationId);
+			if (!Source)
+			{
+				FFragmentMeshBuildData& Built = RepresentationData.Add(Element.RepresentationId);
+
+				// Cached entries carry the whole LOD chain; LOD0 matches a single-LOD build
+				if (!Element.DerivedCacheFile.IsEmpty() && !FFragmentDerivedMeshCache::Load(Element.DerivedCacheFile, Built)
+					&& Element.Geometry.bFromDerivedCache)
+				{
+					// No geometry to fall back to: the fragment is not drawn by the merged mesh
+					UE_LOG(LogFragments, Warning, TEXT("BuildMergedData: Cache entry %s of fragment %d cannot be read, leaving it out of the merged mesh"),
+						*Element.DerivedCacheFile, Element.LocalId);
+				}
+				else if (!Built.IsValid())
+				{
+					BuildGeometryData(Element.Geometry, ElementOptions, Built);
+				}
+				Source = &Built;
+			}
+		}
+		else
+		{
+			BuildGeometryData(Element.Geometry, ElementOptions, ScratchData);
+			Source = &ScratchData;
+		}
+
+		if (!Source->IsValid())
+		{
+			continue;
+		}
+
+		// Consecutive samples of one fragment share its range
+		if (OutData.Elements.Num() == 0 || OutData.Elements.Last().LocalId != Element.LocalId)
+		{
+			FFragmentMeshElementRange& Range = OutData.Elements.AddDefaulted_GetRef();
+			Range.LocalId = Element.LocalId;
+			Range.FirstTriangle = Merged.GetTriangleCount();
+		}
+
+		const FFragmentMeshLodData& Lod = Source->Lods[0];
+		const FTransform3f Transform(Element.Transform);
+
+		// Normals take the inverse scale so non-uniform scaling keeps them perpendicular
+		const FVector3f InverseScale = FTransform3f::GetSafeScaleReciprocal(Transform.GetScale3D());
+
+		// Mirroring transforms turn the winding inside out
+		const bool bMirrored = Transform.GetDeterminant() < 0.0f;
+
+		const uint32 VertexBase = Merged.Positions.Num();
+		for (int32 i = 0; i < Lod.Positions.Num(); i++)
+		{
+			const FVector3f Position = Transform.TransformPosition(Lod.Positions[i]);
+			Merged.Positions.Add(Position);
+			Merged.Normals.Add(Transform.TransformVectorNoScale(Lod.Normals[i] * InverseScale).GetSafeNormal());
+			Merged.Tangents.Add(Transform.TransformVector(Lod.Tangents[i]).GetSafeNormal());
+			OutData.Bounds += Position;
+		}
+
+		for (int32 i = 0; i + 2 < Lod.Indices.Num(); i += 3)
+		{
+			Merged.Indices.Add(VertexBase + Lod.Indices[i]);
+			Merged.Indices.Add(VertexBase + Lod.Indices[bMirrored ? i + 2 : i + 1]);
+			Merged.Indices.Add(VertexBase + Lod.Indices[bMirrored ? i + 1 : i + 2]);
+		}
+
+		OutData.Elements.Last().NumTriangles = Merged.GetTriangleCount() - OutData.Elements.Last().FirstTriangle;
+	}
+
+	return OutData.IsValid();
+}
+
+TFuture<FFragmentMeshBuildDataPtr> FFragmentMeshBuilder::BuildMergedAsync(TArray<FFragmentMergeElement>&& Elements, const FFragmentMeshBuildOptions& Options)
+{
+	return Async(EAsyncExecution::ThreadPool, [Elements = MoveTemp(Elements), Options]() -> FFragmentMeshBuildDataPtr
+		{
+			FFragmentMeshBuildDataPtr Data = MakeShared<FFragmentMeshBuildData, ESPMode::ThreadSafe>();
+			if (BuildMergedData(Elements, Options, *Data))
+			{
+				BuildRenderData(*Data);
+			}
+			return Data;
+		});
+}
+
+void FFragmentMeshBuilder::BuildMeshDescriptions(FFragmentMeshBuildData& OutData)
+{
+	for (FFragmentMeshLodData& Lod : OutData.Lods)
+	{
+		FMeshDescription& MeshDescription = Lod.MeshDescription;
+		MeshDescription.Empty();
+
+		FStaticMeshAttributes Attributes(MeshDescription);
+		Attributes.Register();
+
+		const int32 VertexCount = Lod.Positions.Num();
+		const int32 TriangleCount = Lod.GetTriangleCount();
+
+		MeshDescription.ReserveNewVertices(VertexCount);
+		MeshDescription.ReserveNewVertexInstances(VertexCount);
+		MeshDescription.ReserveNewTriangles(TriangleCount);
+		MeshDescription.ReserveNewEdges(TriangleCount * 3);
+
+		TVertexAttributesRef<FVector3f> Positions = Attributes.GetVertexPositions();
+		TVertexInstanceAttributesRef<FVector3f> Normals = Attributes.GetVertexInstanceNormals();
+		TVertexInstanceAttributesRef<FVector3f> Tangents = Attributes.GetVertexInstanceTangents();
+		TVertexInstanceAttributesRef<float> BinormalSigns = Attributes.GetVertexInstanceBinormalSigns();
+
+		// One vertex instance per vertex: normals are already final
+		TArray<FVertexInstanceID> Instances;
+		Instances.Reserve(VertexCount);
+		for (int32 i = 0; i < VertexCount; i++)
+		{
+			const FVertexID VertexId = MeshDescription.CreateVertex();
+			Positions[VertexId] = Lod.Positions[i];
+
+			const FVertexInstanceID InstanceId = MeshDescription.CreateVertexInstance(VertexId);
+			Normals[InstanceId] = Lod.Normals[i];
+			Tangents[InstanceId] = Lod.Tangents[i];
+			BinormalSigns[InstanceId] = 1.0f;
+			Instances.Add(InstanceId);
+		}
+
+		const FPolygonGroupID PolygonGroupId = MeshDescription.CreatePolygonGroup();
+		for (int32 i = 0; i + 2 < Lod.Indices.Num(); i += 3)
+		{
+			const FVertexInstanceID Triangle[3] = {
+				Instances[Lod.Indices[i]],
+				Instances[Lod.Indices[i + 1]],
+				Instances[Lod.Indices[i + 2]]
+			};
+			MeshDescription.CreateTriangle(PolygonGroupId, MakeArrayView(Triangle, 3));
+		}
+	}
+}
+
+void FFragmentMeshBuilder::BuildRenderData(FFragmentMeshBuildData& OutData)
+{
+	const int32 LodCount = OutData.Lods.Num();
+
+	OutData.RenderData = MakeUnique<FStaticMeshRenderData>();
+	FStaticMeshRenderData& RenderData = *OutData.RenderData;
+	RenderData.AllocateLODResources(LodCount);
+
+	for (int32 LodIndex = 0; LodIndex < LodCount; LodIndex++)
+	{
+		const FFragmentMeshLodData& Lod = OutData.Lods[LodIndex];
+		const int32 VertexCount = Lod.Positions.Num();
+
+		FStaticMeshLODResources& LODResources = RenderData.LODResources[LodIndex];
+		LODResources.VertexBuffers.PositionVertexBuffer.Init(Lod.Positions);
+
+		// Fragments carry no texture coordinates; one zeroed channel keeps materials happy
+		FStaticMeshVertexBuffer& VertexBuffer = LODResources.VertexBuffers.StaticMeshVertexBuffer;
+		VertexBuffer.Init(VertexCount, 1);
+		for (int32 i = 0; i < VertexCount; i++)
+		{
+			const FVector3f& Normal = Lod.Normals[i];
+			const FVector3f& Tangent = Lod.Tangents[i];
+			VertexBuffer.SetVertexTangents(i, Tangent, FVector3f::CrossProduct(Normal, Tangent), Normal);
+			VertexBuffer.SetVertexUV(i, 0, FVector2f::ZeroVector);
+		}
+
+		LODResources.IndexBuffer.SetIndices(Lod.Indices, EIndexBufferStride::AutoDetect);
+
+		FStaticMeshSection& Section = LODResources.Sections.AddDefaulted_GetRef();
+		Section.MaterialIndex = 0;
+		Section.FirstIndex = 0;
+		Section.NumTriangles = Lod.GetTriangleCount();
+		Section.MinVertexIndex = 0;
+		Section.MaxVertexIndex = FMath::Max(VertexCount - 1, 0);
+		// Only cooked when runtime collision is enabled (UFragmentsImporter::bRuntimeMeshCollision)
+		Section.bEnableCollision = true;
+		Section.bCastShadow = true;
+
+		// Nothing to stream: every LOD lives with the mesh
+		LODResources.bBuffersInlined = true;
+		RenderData.ScreenSize[LodIndex].Default = Lod.ScreenSize;
+	}
+
+	RenderData.NumInlinedLODs = LodCount;
+	RenderData.Bounds = FBoxSphereBounds(FBox(OutData.Bounds));
+}
+
+void FFragmentMeshBuilder::BuildForProfile(FFragmentMeshBuildData& OutData, EFragmentMeshBuildProfile Profile)
+{
+	if (Profile == EFragmentMeshBuildProfile::Full)
+	{
+		BuildMeshDescriptions(OutData);
+	}
+	else
+	{
+		BuildRenderData(OutData);
+	}
+}
+
+TFuture<FFragmentMeshBuildDataPtr> FFragmentMeshBuilder::BuildAsync(const FPreExtractedGeometry& Geometry, const FFragmentMeshBuildOptions& Options,
+	const FString& DerivedCacheFile)
+{
+	return Async(EAsyncExecution::ThreadPool, [Geometry, Options, DerivedCacheFile]() -> FFragmentMeshBuildDataPtr
+		{
+			FFragmentMeshBuildDataPtr Data = MakeShared<FFragmentMeshBuildData, ESPMode::ThreadSafe>();
+			bool bBuilt = !DerivedCacheFile.IsEmpty() && FFragmentDerivedMeshCache::Load(DerivedCacheFile, *Data);
+
+			// Geometry skipped at load because of the cache entry cannot be rebuilt here
+			if (!bBuilt && !Geometry.bFromDerivedCache)
+			{
+				bBuilt = BuildGeometryData(Geometry, Options, *Data);
+				if (bBuilt && !DerivedCacheFile.IsEmpty())
+				{
+					FFragmentDerivedMeshCache::Store(DerivedCacheFile, *Data);
+				}
+			}
+
+			if (bBuilt)
+			{
+				BuildForProfile(*Data, Options.Profile);
+			}
+			return Data;
+		});
+}
@@ -20,3 +20,35 @@ void UFragmentModelWrapper::BuildFragmentRegistry(const FString& ModelGuid)
 	       *ModelGuid, FragmentRegistry->GetFragmentCount());
 }
 
+int32 UFragmentModelWrapper::GetItemIndex(int32 LocalId)
+{
+	if (Items.Num() == 0)
+	{
+		BuildItemIndex();
+	}
+
+	const int32* ItemIndex = LocalIdToItemIndex.Find(LocalId);
+	return ItemIndex ? *ItemIndex : INDEX_NONE;
+}
+
+void UFragmentModelWrapper::BuildItemIndex()
+{
+	Items.Reset();
+	LocalIdToItemIndex.Reset();
+
+	TArray<const FFragmentItem*> Stack;
+	Stack.Add(&ModelItem);
+	while (Stack.Num() > 0)
+	{
+		const FFragmentItem* Item = Stack.Pop();
+		LocalIdToItemIndex.Add(Item->LocalId, Items.Add(Item));
+
+		for (int32 ChildIndex = Item->FragmentChildren.Num() - 1; ChildIndex >= 0; --ChildIndex)
+		{
+			if (const FFragmentItem* Child = Item->FragmentChildren[ChildIndex])
+			{
+				Stack.Add(Child);
+			}
+		}
+	}
+}
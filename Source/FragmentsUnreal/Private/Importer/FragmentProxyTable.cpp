@@ -0,0 +1,43 @@
+#include "Importer/FragmentProxyTable.h"
+
+int32 FFragmentProxyTable::AddRow(int32 LocalId, int32 ItemIndex)
+{
+	if (const int32* Existing = LocalIdToRow.Find(LocalId))
+	{
+		return *Existing;
+	}
+
+	const int32 Row = LocalIds.Add(LocalId);
+	GroupKeys.Add(0);
+	InstanceIndices.Add(INDEX_NONE);
+	ItemIndices.Add(ItemIndex);
+	LocalIdToRow.Add(LocalId, Row);
+	return Row;
+}
+
+bool FFragmentProxyTable::RemoveRow(int32 LocalId)
+{
+	int32 Row = INDEX_NONE;
+	if (!LocalIdToRow.RemoveAndCopyValue(LocalId, Row))
+	{
+		return false;
+	}
+
+	const int32 Last = LocalIds.Num() - 1;
+	if (Row != Last)
+	{
+		LocalIdToRow[LocalIds[Last]] = Row;
+	}
+
+	LocalIds.RemoveAtSwap(Row);
+	GroupKeys.RemoveAtSwap(Row);
+	InstanceIndices.RemoveAtSwap(Row);
+	ItemIndices.RemoveAtSwap(Row);
+	return true;
+}
+
+SIZE_T FFragmentProxyTable::GetAllocatedSize() const
+{
+	return LocalIds.GetAllocatedSize() + GroupKeys.GetAllocatedSize() + InstanceIndices.GetAllocatedSize()
+		+ ItemIndices.GetAllocatedSize() + LocalIdToRow.GetAllocatedSize() + ModelGuid.GetAllocatedSize();
+}
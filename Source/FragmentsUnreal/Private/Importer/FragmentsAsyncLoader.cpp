@@ -303,7 +303,7 @@ void UFragmentsAsyncLoader::CheckTaskCompletion()
 				// when FlatBuffer pointers become invalid in the async/TileManager path
 				if (_meshes && Importer)
 				{
-					Importer->PreExtractAllGeometry(Wrapper->GetModelItemRef(), _meshes);
+					Wrapper->SetDerivedCacheOptionsHash(Importer->PreExtractAllGeometry(Wrapper->GetModelItemRef(), _meshes, Wrapper->GetContentHash()));
 				}
 
 				// Store wrapper in importer's FragmentModels map
@@ -116,6 +116,23 @@ AFragment* UFragmentsComponent::GetItemByLocalId(int32 LocalId, const FString& M
 	return nullptr;
 }
 
+FFindResult UFragmentsComponent::PickFragment(const FHitResult& Hit)
+{
+	if (FragmentsImporter) return FragmentsImporter->PickFragment(Hit);
+	return FFindResult::NotFound();
+}
+
+int32 UFragmentsComponent::SetFragmentsSelected(const FString& ModelGuid, const TArray<int32>& LocalIds, bool bSelected)
+{
+	if (FragmentsImporter) return FragmentsImporter->SetFragmentsSelected(ModelGuid, LocalIds, bSelected);
+	return 0;
+}
+
+void UFragmentsComponent::ClearFragmentSelection()
+{
+	if (FragmentsImporter) FragmentsImporter->ClearFragmentSelection();
+}
+
 void UFragmentsComponent::ProcessFragmentAsync(const FString& Path, FOnFragmentLoadComplete OnComplete)
 {
 	if (!FragmentsImporter)
@@ -15,6 +15,12 @@
 #include "Curve/PolygonIntersectionUtils.h"
 #include "CompGeom/PolygonTriangulation.h"
 #include "tesselator.h"
+#include "Utils/TriangulationBackend.h"
+#include "Importer/FragmentMeshBuilder.h"
+#include "Importer/FragmentDerivedMeshCache.h"
+#include "Hash/CityHash.h"
+#include "StaticMeshAttributes.h"
+#include "StaticMeshResources.h"
 #include "Algo/Reverse.h"
 #include "Fragment/Fragment.h"
 #include "Importer/FragmentModelWrapper.h"
@@ -22,8 +28,281 @@
 #include "Misc/ScopedSlowTask.h"
 #include "Importer/FragmentsAsyncLoader.h"
 #include "Spatial/FragmentTileManager.h"
+#include "Spatial/FragmentResourceLedger.h"
+#include "Spatial/PerSampleVisibilityController.h"
 #include "Utils/FragmentOcclusionClassifier.h"
+#include "Utils/ShellCanonicalForm.h"
 #include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Misc/QueuedThreadPool.h"
+
+namespace
+{
+	FMeshBuildWaiter MakeComponentWaiter(AFragment* FragmentActor, int32 SampleIndex, const FFragmentKey& Fragment, float Priority)
+	{
+		FMeshBuildWaiter Waiter;
+		Waiter.Actor = FragmentActor;
+		Waiter.SampleIndex = SampleIndex;
+		Waiter.Fragment = Fragment;
+		Waiter.Priority = Priority;
+		return Waiter;
+	}
+
+	FMeshBuildWaiter MakeInstanceWaiter(const FFragmentItem& Item, int32 SampleIndex, const FFragmentKey& Fragment, float Priority)
+	{
+		const FPreExtractedGeometry& Geometry = Item.Samples[SampleIndex].ExtractedGeometry;
+
+		FMeshBuildWaiter Waiter;
+		Waiter.SampleIndex = SampleIndex;
+		Waiter.Fragment = Fragment;
+		Waiter.Priority = Priority;
+		Waiter.bInstanced = true;
+		Waiter.InstanceItem.ModelGuid = Item.ModelGuid;
+		Waiter.InstanceItem.LocalId = Item.LocalId;
+		Waiter.InstanceItem.Category = Item.Category;
+		Waiter.WorldTransform = Geometry.LocalTransform * Item.GlobalTransform;
+		Waiter.R = Geometry.R;
+		Waiter.G = Geometry.G;
+		Waiter.B = Geometry.B;
+		Waiter.A = Geometry.A;
+		Waiter.bIsGlass = Geometry.bIsGlass;
+		return Waiter;
+	}
+
+	/**
+	 * Triangles of a representation's built mesh, read from the FlatBuffers data without extracting it.
+	 * Shells: n - 2 per profile plus 2 + n per hole. Circle extrusions: 16 segments around each span
+	 * (one per wire segment, 8 per arc), a mid-range value of the tolerance-driven segment count.
+	 */
+	int32 EstimateRepresentationTriangles(const Meshes* MeshesRef, const Representation* InRepresentation)
+	{
+		const uint32 Id = InRepresentation->id();
+		int32 Triangles = 0;
+
+		if (InRepresentation->representation_class() == RepresentationClass::RepresentationClass_SHELL)
+		{
+			const Shell* InShell = MeshesRef->shells() && Id < MeshesRef->shells()->size() ? MeshesRef->shells()->Get(Id) : nullptr;
+			if (!InShell)
+			{
+				return 0;
+			}
+			if (const auto* Profiles = InShell->profiles())
+			{
+				for (flatbuffers::uoffset_t i = 0; i < Profiles->size(); i++)
+				{
+					const auto* Profile = Profiles->Get(i);
+					const int32 IndexCount = Profile && Profile->indices() ? Profile->indices()->size() : 0;
+					Triangles += IndexCount >= 3 ? IndexCount - 2 : 0;
+				}
+			}
+			if (const auto* Holes = InShell->holes())
+			{
+				for (flatbuffers::uoffset_t i = 0; i < Holes->size(); i++)
+				{
+					const auto* Hole = Holes->Get(i);
+					Triangles += Hole && Hole->indices() ? Hole->indices()->size() + 2 : 0;
+				}
+			}
+			return Triangles;
+		}
+
+		if (InRepresentation->representation_class() == RepresentationClass_CIRCLE_EXTRUSION)
+		{
+			constexpr int32 SegmentsAround = 16;
+			constexpr int32 SegmentsPerArc = 8;
+
+			const CircleExtrusion* Extrusion = MeshesRef->circle_extrusions() && Id < MeshesRef->circle_extrusions()->size()
+				? MeshesRef->circle_extrusions()->Get(Id) : nullptr;
+			if (!Extrusion || !Extrusion->axes())
+			{
+				return 0;
+			}
+
+			int32 Spans = 0;
+			for (flatbuffers::uoffset_t AxisIndex = 0; AxisIndex < Extrusion->axes()->size(); AxisIndex++)
+			{
+				const Axis* CurAxis = Extrusion->axes()->Get(AxisIndex);
+				if (!CurAxis)
+				{
+					continue;
+				}
+				Spans += CurAxis->wires() ? CurAxis->wires()->size() : 0;
+				Spans += CurAxis->circle_curves() ? CurAxis->circle_curves()->size() * SegmentsPerArc : 0;
+				if (const auto* WireSets = CurAxis->wire_sets())
+				{
+					for (flatbuffers::uoffset_t i = 0; i < WireSets->size(); i++)
+					{
+						const auto* Points = WireSets->Get(i) ? WireSets->Get(i)->ps() : nullptr;
+						Spans += Points && Points->size() > 1 ? Points->size() - 1 : 0;
+					}
+				}
+			}
+			return Spans * SegmentsAround * 2;
+		}
+
+		return 0;
+	}
+
+	/** Key of the instanced group drawing a mesh with a material */
+	uint64 MakeInstanceGroupKey(uint64 MeshKey, uint32 MaterialHash)
+	{
+		return MeshKey ^ (static_cast<uint64>(MaterialHash) * 0x9E3779B97F4A7C15ull);
+	}
+
+	/** Spread the low 21 bits of a value to every third bit (one axis of a 3D Morton code) */
+	uint64 SpreadMortonBits(uint64 Value)
+	{
+		Value &= 0x1fffff;
+		Value = (Value | Value << 32) & 0x1f00000000ffffull;
+		Value = (Value | Value << 16) & 0x1f0000ff0000ffull;
+		Value = (Value | Value << 8) & 0x100f00f00f00f00full;
+		Value = (Value | Value << 4) & 0x10c30c30c30c30c3ull;
+		Value = (Value | Value << 2) & 0x1249249249249249ull;
+		return Value;
+	}
+
+	/**
+	 * Sort instance transforms along a Z-order curve over their bounds (runs on a worker).
+	 * Neighbouring instances end up next to each other, so the HISMC's first cluster build
+	 * starts from spatially coherent runs instead of spawn order.
+	 */
+	FPreparedInstanceBatch PrepareInstanceBatch(TArray<FTransform>&& Transforms)
+	{
+		FBox Bounds(ForceInit);
+		for (const FTransform& Transform : Transforms)
+		{
+			Bounds += Transform.GetLocation();
+		}
+
+		constexpr double MaxCell = 2097151.0; // 21 bits per axis
+		const FVector Size = Bounds.GetSize();
+		const FVector Scale(
+			Size.X > KINDA_SMALL_NUMBER ? MaxCell / Size.X : 0.0,
+			Size.Y > KINDA_SMALL_NUMBER ? MaxCell / Size.Y : 0.0,
+			Size.Z > KINDA_SMALL_NUMBER ? MaxCell / Size.Z : 0.0);
+
+		TArray<TPair<uint64, int32>> Codes;
+		Codes.Reserve(Transforms.Num());
+		for (int32 Index = 0; Index < Transforms.Num(); Index++)
+		{
+			const FVector Cell = (Transforms[Index].GetLocation() - Bounds.Min) * Scale;
+			const uint64 Code = SpreadMortonBits(static_cast<uint64>(FMath::Clamp(Cell.X, 0.0, MaxCell)))
+				| SpreadMortonBits(static_cast<uint64>(FMath::Clamp(Cell.Y, 0.0, MaxCell))) << 1
+				| SpreadMortonBits(static_cast<uint64>(FMath::Clamp(Cell.Z, 0.0, MaxCell))) << 2;
+			Codes.Emplace(Code, Index);
+		}
+
+		// Ties keep spawn order so the result does not depend on the sort
+		Codes.Sort([](const TPair<uint64, int32>& A, const TPair<uint64, int32>& B)
+		{
+			return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value);
+		});
+
+		FPreparedInstanceBatch Batch;
+		Batch.Order.Reserve(Codes.Num());
+		Batch.Transforms.Reserve(Codes.Num());
+		for (const TPair<uint64, int32>& Code : Codes)
+		{
+			Batch.Order.Add(Code.Value);
+			Batch.Transforms.Add(Transforms[Code.Value]);
+		}
+		return Batch;
+	}
+
+	uint64 HashValue(uint32 Value, uint64 Hash)
+	{
+		return CityHash64WithSeed(reinterpret_cast<const char*>(&Value), sizeof(Value), Hash);
+	}
+
+	/** Fold the length and raw bytes of a FlatBuffers vector into Hash */
+	template <typename VectorType>
+	uint64 HashVectorBytes(const VectorType* Vector, SIZE_T ElementSize, uint64 Hash)
+	{
+		const uint32 Count = Vector ? Vector->size() : 0;
+		Hash = HashValue(Count, Hash);
+		if (Count > 0)
+		{
+			Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Vector->Data()), Count * ElementSize, Hash);
+		}
+		return Hash;
+	}
+
+	/**
+	 * Hash the source geometry of a representation straight from the FlatBuffers data.
+	 * Only coordinates and topology go in, never ids or indices into the model, so the
+	 * same shape gets the same hash in every model.
+	 * @return Content hash, or 0 if the representation has no geometry
+	 */
+	uint64 HashRepresentationGeometry(const Meshes* MeshesRef, const Representation* Rep)
+	{
+		const uint32 Id = Rep->id();
+		uint64 Hash = HashValue(static_cast<uint32>(Rep->representation_class()), 0);
+
+		if (Rep->representation_class() == RepresentationClass::RepresentationClass_SHELL)
+		{
+			const Shell* ShellRef = MeshesRef->shells() && Id < MeshesRef->shells()->size() ? MeshesRef->shells()->Get(Id) : nullptr;
+			if (!ShellRef || !ShellRef->points() || !ShellRef->profiles())
+			{
+				return 0;
+			}
+
+			Hash = HashVectorBytes(ShellRef->points(), sizeof(FloatVector), Hash);
+			Hash = HashValue(ShellRef->profiles()->size(), Hash);
+			for (const ShellProfile* Profile : *ShellRef->profiles())
+			{
+				Hash = HashVectorBytes(Profile ? Profile->indices() : nullptr, sizeof(uint16), Hash);
+			}
+			if (const auto* Holes = ShellRef->holes())
+			{
+				Hash = HashValue(Holes->size(), Hash);
+				for (const ShellHole* Hole : *Holes)
+				{
+					Hash = HashValue(Hole ? static_cast<uint32>(Hole->profile_id()) : MAX_uint32, Hash);
+					Hash = HashVectorBytes(Hole ? Hole->indices() : nullptr, sizeof(uint16), Hash);
+				}
+			}
+		}
+		else if (Rep->representation_class() == RepresentationClass_CIRCLE_EXTRUSION)
+		{
+			const CircleExtrusion* Extrusion = MeshesRef->circle_extrusions() && Id < MeshesRef->circle_extrusions()->size()
+				? MeshesRef->circle_extrusions()->Get(Id) : nullptr;
+			if (!Extrusion || !Extrusion->axes() || !Extrusion->radius())
+			{
+				return 0;
+			}
+
+			Hash = HashVectorBytes(Extrusion->radius(), sizeof(double), Hash);
+			Hash = HashValue(Extrusion->axes()->size(), Hash);
+			for (const Axis* CurAxis : *Extrusion->axes())
+			{
+				if (!CurAxis)
+				{
+					Hash = HashValue(MAX_uint32, Hash);
+					continue;
+				}
+				Hash = HashVectorBytes(CurAxis->order(), sizeof(uint32), Hash);
+				Hash = HashVectorBytes(CurAxis->parts(), sizeof(int8), Hash);
+				Hash = HashVectorBytes(CurAxis->wires(), sizeof(Wire), Hash);
+				Hash = HashVectorBytes(CurAxis->circle_curves(), sizeof(CircleCurve), Hash);
+				Hash = HashValue(CurAxis->wire_sets() ? CurAxis->wire_sets()->size() : 0, Hash);
+				if (CurAxis->wire_sets())
+				{
+					for (const WireSet* Set : *CurAxis->wire_sets())
+					{
+						Hash = HashVectorBytes(Set ? Set->ps() : nullptr, sizeof(FloatVector), Hash);
+					}
+				}
+			}
+		}
+		else
+		{
+			return 0;
+		}
+
+		// 0 marks "no geometry"
+		return Hash != 0 ? Hash : 1;
+	}
+}
 
 
 void UFragmentsImporter::ProcessFragmentAsync(const FString& FragmentPath, AActor* Owner, FOnFragmentLoadComplete OnComplete)
@@ -406,7 +685,7 @@ FString UFragmentsImporter::LoadFragment(const FString& FragPath)
 		// Pre-extract all geometry data from FlatBuffers at load time
 		// This eliminates FlatBuffer access during spawn phase and prevents crashes
 		// when FlatBuffer pointers become invalid in the async/TileManager path
-		PreExtractAllGeometry(Wrapper->GetModelItemRef(), _meshes);
+		Wrapper->SetDerivedCacheOptionsHash(PreExtractAllGeometry(Wrapper->GetModelItemRef(), _meshes, Wrapper->GetContentHash()));
 	}
 	ModelFragmentsMap.Add(ModelGuidStr, FFragmentLookup());
 
@@ -505,22 +784,113 @@ TArray<int32> UFragmentsImporter::GetElementsByCategory(const FString& InCategor
 
 void UFragmentsImporter::UnloadFragment(const FString& ModelGuid)
 {
+	// Box proxies and merged tile meshes live on host actors owned by the model's tile manager
+	UFragmentTileManager* TileManager = nullptr;
+	if (TileManagers.RemoveAndCopyValue(ModelGuid, TileManager) && TileManager)
+	{
+		TileManager->Shutdown();
+	}
+
+	// Samples of the model must not be added once their meshes finish
+	const UFragmentModelWrapper* UnloadedWrapper = GetFragmentModel(ModelGuid);
+	const uint64 UnloadedModelKey = UnloadedWrapper ? UnloadedWrapper->GetContentHash() : 0;
+	for (TPair<uint64, FMeshBuildRequest>& Pair : MeshBuildRequests)
+	{
+		const uint64 MeshKey = Pair.Key;
+		Pair.Value.Waiters.RemoveAll([this, UnloadedModelKey, MeshKey](const FMeshBuildWaiter& Waiter)
+		{
+			if (Waiter.Fragment.ModelKey != UnloadedModelKey)
+			{
+				return false;
+			}
+			WaitingFragmentMeshes.RemoveSingle(Waiter.Fragment, MeshKey);
+			return true;
+		});
+	}
+
+	// Pull the model's instances out of the shared HISMCs (the key needs the wrapper, still registered here)
+	if (const UFragmentModelWrapper* Wrapper = GetFragmentModel(ModelGuid))
+	{
+		const uint64 ModelKey = Wrapper->GetContentHash();
+		TArray<FFragmentKey> ModelInstances;
+		for (const TPair<FFragmentKey, TArray<uint64>>& Pair : InstancedFragmentGroups)
+		{
+			if (Pair.Key.ModelKey == ModelKey)
+			{
+				ModelInstances.Add(Pair.Key);
+			}
+		}
+		for (const FFragmentKey& Key : ModelInstances)
+		{
+			RemoveInstancedFragment(Key);
+		}
+		FlushInstanceVisibility();
+		ProxyTables.Remove(ModelKey);
+
+		for (auto It = SelectedFragments.CreateIterator(); It; ++It)
+		{
+			if (It->ModelKey == ModelKey)
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
 	if (FFragmentLookup* Lookup = ModelFragmentsMap.Find(ModelGuid))
 	{
 		for (TPair<int32, AFragment*> Obj : Lookup->Fragments)
 		{
-			Obj.Value->Destroy();
+			// Fully instanced fragments have no actor; streamed-out actors left the map when destroyed
+			if (IsValid(Obj.Value))
+			{
+				ReleaseFragmentResources(Obj.Value);
+				Obj.Value->Destroy();
+			}
 		}
 		ModelFragmentsMap.Remove(ModelGuid);
 	}
 
+	// Geometry the model could not build may build from another model's samples
+	FailedMeshKeys.Empty();
+
+	// Saved-asset meshes of the model are only looked up by its package paths
+	const FString ModelPackagePrefix = TEXT("/Game/Buildings") / ModelGuid / TEXT("");
+	for (auto It = MeshCache.CreateIterator(); It; ++It)
+	{
+		if (It.Key().StartsWith(ModelPackagePrefix))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
 	if (UFragmentModelWrapper** WrapperPtr = FragmentModels.Find(ModelGuid))
 	{
 		UFragmentModelWrapper* Wrapper = *WrapperPtr;
 
+		// Instance counts are shared with the other loaded models
+		TMap<uint64, FInstancingGroupStats> ModelInstanceCounts;
+		CountInstancesPerGroup(Wrapper->GetModelItemRef(), ModelInstanceCounts);
+		for (const TPair<uint64, FInstancingGroupStats>& Pair : ModelInstanceCounts)
+		{
+			FInstancingGroupStats* Stats = InstancingGroupStats.Find(Pair.Key);
+			if (!Stats)
+			{
+				continue;
+			}
+			if ((Stats->InstanceCount -= Pair.Value.InstanceCount) <= 0)
+			{
+				InstancingGroupStats.Remove(Pair.Key);
+				continue;
+			}
+			EvaluateInstancingCost(*Stats);
+		}
+		InstancingDecisionSerial++;
+
 		Wrapper = nullptr;
 		FragmentModels.Remove(ModelGuid);
 	}
+
+	TrimResourceCaches();
 }
 
 void UFragmentsImporter::CollectPropertiesRecursive(
@@ -1094,7 +1464,7 @@ void UFragmentsImporter::BuildSpawnQueue(const FFragmentItem& Item, AActor* Pare
 	// We'll handle parent-child relationships during spawning
 }
 
-AFragment* UFragmentsImporter::SpawnSingleFragment(const FFragmentItem& Item, AActor* ParentActor, const Meshes* MeshesRef, bool bSaveMeshes, bool* bOutWasInstanced, float* RemainingBudgetMs, int32* OutSamplesProcessed)
+AFragment* UFragmentsImporter::SpawnSingleFragment(const FFragmentItem& Item, AActor* ParentActor, const Meshes* MeshesRef, uint64 ModelKey, bool bSaveMeshes, bool* bOutWasInstanced, float* RemainingBudgetMs, int32* OutSamplesProcessed, float SpawnPriority)
 {
 	// Track start time for budget checking
 	const double SpawnStartTime = FPlatformTime::Seconds();
@@ -1114,6 +1484,8 @@ AFragment* UFragmentsImporter::SpawnSingleFragment(const FFragmentItem& Item, AA
 
 	const TArray<FFragmentSample>& Samples = Item.Samples;
 
+	const FFragmentKey FragmentKey(ModelKey, Item.LocalId);
+
 	// ==========================================
 	// GPU INSTANCING: Check if ALL samples should be instanced
 	// If so, we can skip actor creation entirely and just use a proxy
@@ -1128,18 +1500,10 @@ AFragment* UFragmentsImporter::SpawnSingleFragment(const FFragmentItem& Item, AA
 			if (!Sample.ExtractedGeometry.bIsValid) continue;
 			ValidSampleCount++;
 
-			// Only Shell geometry supports instancing currently
-			if (!Sample.ExtractedGeometry.bIsShell)
-			{
-				bAllSamplesInstanced = false;
-				break;
-			}
-
-			const int32 RepId = Sample.RepresentationIndex;
 			const FPreExtractedGeometry& Geom = Sample.ExtractedGeometry;
-			const uint32 MatHash = HashMaterialProperties(Geom.R, Geom.G, Geom.B, Geom.A, Geom.bIsGlass);
+			const uint32 MatHash = GetGroupMaterialHash(Geom.R, Geom.G, Geom.B, Geom.A, Geom.bIsGlass);
 
-			if (!ShouldUseInstancing(RepId, MatHash))
+			if (!ShouldUseInstancing(Geom.GeometryHash, MatHash, Item.Category))
 			{
 				bAllSamplesInstanced = false;
 				break;
@@ -1166,38 +1530,20 @@ AFragment* UFragmentsImporter::SpawnSingleFragment(const FFragmentItem& Item, AA
 
 			if (!ExtractedGeom.bIsValid) continue;
 
-			const int32 RepId = Sample.RepresentationIndex;
-			const uint32 MatHash = HashMaterialProperties(ExtractedGeom.R, ExtractedGeom.G,
+			const uint64 MeshKey = ExtractedGeom.GeometryHash;
+			const uint32 MatHash = GetGroupMaterialHash(ExtractedGeom.R, ExtractedGeom.G,
 				ExtractedGeom.B, ExtractedGeom.A, ExtractedGeom.bIsGlass);
 
-			// Get or create mesh from representation cache
-			UStaticMesh* Mesh = nullptr;
-			if (UStaticMesh** CachedMesh = RepresentationMeshCache.Find(RepId))
-			{
-				Mesh = *CachedMesh;
-			}
-			else if (CanCreateNewMesh())
-			{
-				// Create new mesh (only if we haven't exceeded the per-frame limit)
-				FString MeshName = FString::Printf(TEXT("Rep_%d"), RepId);
-				UPackage* MeshPackage = CreatePackage(*FString::Printf(TEXT("/Game/Buildings/Instanced/%s"), *MeshName));
-				Mesh = CreateStaticMeshFromPreExtractedShell(ExtractedGeom, MeshName, MeshPackage);
-				if (Mesh)
-				{
-					OnNewMeshCreated();
-					RepresentationMeshCache.Add(RepId, Mesh);
-					UE_LOG(LogFragments, Verbose, TEXT("GPU Instancing: Created mesh for RepId %d [%d/%d this frame]"),
-						RepId, NewMeshCreationsThisFrame, MaxNewMeshCreationsPerFrame);
-				}
-			}
-			else
+			// Get mesh from the shared cache, or from a finished background build
+			UStaticMesh* Mesh = GetOrBuildRepresentationMesh(Item, i, ModelKey, EFragmentMeshBuildProfile::Runtime);
+
+			// Mesh still building: the instance is queued once the mesh is committed
+			if (!Mesh)
 			{
-				// Skip this sample - mesh creation limit reached
+				AddMeshBuildWaiter(MeshKey, MakeInstanceWaiter(Item, i, FragmentKey, SpawnPriority));
 				continue;
 			}
 
-			if (!Mesh) continue;
-
 			// Get pooled material
 			UMaterialInstanceDynamic* Material = GetPooledMaterial(ExtractedGeom.R, ExtractedGeom.G,
 				ExtractedGeom.B, ExtractedGeom.A, ExtractedGeom.bIsGlass);
@@ -1212,7 +1558,8 @@ AFragment* UFragmentsImporter::SpawnSingleFragment(const FFragmentItem& Item, AA
 
 			// QUEUE instance for batch addition (no ISMC created yet!)
 			// Proxies will be created in FinalizeAllISMCs()
-			QueueInstanceForBatchAdd(RepId, MatHash, SampleWorldTransform, Item, Mesh, Material, ExtractedGeom.A);
+			QueueInstanceForBatchAdd(MeshKey, MatHash, SampleWorldTransform, Item, Mesh, Material,
+				FColor(ExtractedGeom.R, ExtractedGeom.G, ExtractedGeom.B, ExtractedGeom.A));
 		}
 
 		// Store null in actor lookup map to indicate this fragment exists but is instanced
@@ -1276,290 +1623,100 @@ AFragment* UFragmentsImporter::SpawnSingleFragment(const FFragmentItem& Item, AA
 				continue;
 			}
 
-			const int32 RepId = Sample.RepresentationIndex;
-			const uint32 MatHash = HashMaterialProperties(ExtractedGeom.R, ExtractedGeom.G,
+			const uint64 MeshKey = ExtractedGeom.GeometryHash;
+			const uint32 MatHash = GetGroupMaterialHash(ExtractedGeom.R, ExtractedGeom.G,
 				ExtractedGeom.B, ExtractedGeom.A, ExtractedGeom.bIsGlass);
 
 			// ==========================================
 			// PER-SAMPLE INSTANCING CHECK (for mixed fragments)
 			// Queue for batch addition instead of immediate ISMC creation
 			// ==========================================
-			if (bEnableGPUInstancing && ExtractedGeom.bIsShell && ShouldUseInstancing(RepId, MatHash))
+			if (bEnableGPUInstancing && ShouldUseInstancing(MeshKey, MatHash, Item.Category))
 			{
 				// This sample goes to an ISMC instead of a component
 
-				// Get or create mesh
-				UStaticMesh* Mesh = nullptr;
-				if (UStaticMesh** CachedMesh = RepresentationMeshCache.Find(RepId))
-				{
-					Mesh = *CachedMesh;
-				}
-				else if (CanCreateNewMesh())
+				// Get mesh from cache or a finished background build
+				UStaticMesh* Mesh = GetOrBuildRepresentationMesh(Item, i, ModelKey, EFragmentMeshBuildProfile::Runtime);
+
+				// Mesh still building: the instance is queued once the mesh is committed
+				if (!Mesh)
 				{
-					FString MeshName = FString::Printf(TEXT("Rep_%d"), RepId);
-					UPackage* MeshPackage = CreatePackage(*FString::Printf(TEXT("/Game/Buildings/Instanced/%s"), *MeshName));
-					Mesh = CreateStaticMeshFromPreExtractedShell(ExtractedGeom, MeshName, MeshPackage);
-					if (Mesh)
-					{
-						OnNewMeshCreated();
-						RepresentationMeshCache.Add(RepId, Mesh);
-					}
+					AddMeshBuildWaiter(MeshKey, MakeInstanceWaiter(Item, i, FragmentKey, SpawnPriority));
+					continue;
 				}
-				// If mesh creation limit reached, Mesh stays nullptr and we fall through
 
-				if (Mesh)
-				{
-					UMaterialInstanceDynamic* Material = GetPooledMaterial(ExtractedGeom.R, ExtractedGeom.G,
-						ExtractedGeom.B, ExtractedGeom.A, ExtractedGeom.bIsGlass);
+				UMaterialInstanceDynamic* Material = GetPooledMaterial(ExtractedGeom.R, ExtractedGeom.G,
+					ExtractedGeom.B, ExtractedGeom.A, ExtractedGeom.bIsGlass);
 
-					if (Material)
-					{
-						FTransform SampleWorldTransform = ExtractedGeom.LocalTransform * Item.GlobalTransform;
-						QueueInstanceForBatchAdd(RepId, MatHash, SampleWorldTransform, Item, Mesh, Material, ExtractedGeom.A);
-						continue;  // Skip standard component creation for this sample
-					}
-					// Fall through to standard component creation if material is null
+				if (Material)
+				{
+					FTransform SampleWorldTransform = ExtractedGeom.LocalTransform * Item.GlobalTransform;
+					QueueInstanceForBatchAdd(MeshKey, MatHash, SampleWorldTransform, Item, Mesh, Material,
+						FColor(ExtractedGeom.R, ExtractedGeom.G, ExtractedGeom.B, ExtractedGeom.A));
+					continue;  // Skip standard component creation for this sample
 				}
+				// Fall through to standard component creation if material is null
 			}
 
 			// ==========================================
 			// STANDARD COMPONENT CREATION PATH
 			// ==========================================
-			FString MeshName = FString::Printf(TEXT("%d_%d"), FragmentModel->GetLocalId(), i);
-			FString PackagePath = TEXT("/Game/Buildings") / FragmentModel->GetModelGuid() / MeshName;
-			const FString SamplePath = PackagePath + TEXT(".") + MeshName;
-
-			FString UniquePackageName = FPackageName::ObjectPathToPackageName(PackagePath);
-			FString PackageFileName = FPackageName::LongPackageNameToFilename(UniquePackageName, FPackageName::GetAssetPackageExtension());
-
-			// Use pre-extracted local transform instead of FlatBuffer access
-			FTransform LocalTransform = ExtractedGeom.LocalTransform;
-
-			UStaticMesh* Mesh = nullptr;
+			// Meshes are shared by geometry content: every sample with the same
+			// shape, in this model or any other loaded one, uses the same mesh.
+			// Only meshes that may be written to disk need the editor-grade build
+			const EFragmentMeshBuildProfile Profile = bSaveMeshes ? EFragmentMeshBuildProfile::Full : EFragmentMeshBuildProfile::Runtime;
+			UStaticMesh* Mesh = GetOrBuildRepresentationMesh(Item, i, ModelKey, Profile);
 
-			// Check mesh cache first
-			if (MeshCache.Contains(SamplePath))
-			{
-				Mesh = MeshCache[SamplePath];
-			}
-			// Check if mesh exists on disk
-			else if (FPaths::FileExists(PackageFileName))
+			if (!Mesh)
 			{
-				UPackage* ExistingPackage = LoadPackage(nullptr, *PackagePath, LOAD_None);
-				if (ExistingPackage)
-				{
-					Mesh = FindObject<UStaticMesh>(ExistingPackage, *MeshName);
-				}
+				// Mesh queued or still building - the component is added once the mesh is committed
+				AddMeshBuildWaiter(MakeSampleMeshKey(Item, i, ModelKey, Profile), MakeComponentWaiter(FragmentModel, i, FragmentKey, SpawnPriority));
+				UE_LOG(LogFragments, Verbose, TEXT("SpawnSingleFragment: Waiting for mesh %016llx (LocalId: %d)"),
+					MeshKey, FragmentModel->GetLocalId());
+				continue;  // Skip to next sample
 			}
-			// Create new mesh from pre-extracted geometry (NO FLATBUFFER ACCESS)
-			else
-			{
-				UPackage* MeshPackage = CreatePackage(*PackagePath);
-
-				if (ExtractedGeom.bIsShell)
-				{
-					// Use RepresentationId-based caching (more reliable than geometry hashing)
-					// All instances with the same RepresentationId share identical geometry
-					const int32 RepresentationId = Sample.RepresentationIndex;
 
-					if (UStaticMesh** CachedMesh = RepresentationMeshCache.Find(RepresentationId))
-					{
-						// Reuse existing mesh for this representation (cache hit - no limit)
-						Mesh = *CachedMesh;
-						UE_LOG(LogFragments, Verbose, TEXT("SpawnSingleFragment: Reusing cached mesh for RepId %d (LocalId: %d)"),
-							RepresentationId, FragmentModel->GetLocalId());
-					}
-					else if (CanCreateNewMesh())
-					{
-						// Create new mesh using the working pre-extracted shell function
-						// (only if we haven't exceeded the per-frame mesh creation limit)
-						Mesh = CreateStaticMeshFromPreExtractedShell(ExtractedGeom, MeshName, MeshPackage);
+			CreateSampleComponent(FragmentModel, Sample, Mesh);
+		}
+	}
 
-						if (Mesh)
-						{
-							// Track that we created a new mesh this frame
-							OnNewMeshCreated();
+	// Store in lookup map
+	if (ModelFragmentsMap.Contains(Item.ModelGuid))
+	{
+		ModelFragmentsMap[Item.ModelGuid].Fragments.Add(Item.LocalId, FragmentModel);
+	}
 
-							// Cache by RepresentationId for future instances
-							RepresentationMeshCache.Add(RepresentationId, Mesh);
+	// NOTE: No recursive child spawning here - handled by chunking system
 
-							// Save mesh if needed
-							if (!FPaths::FileExists(PackageFileName) && bSaveMeshes)
-							{
-#if WITH_EDITOR
-								MeshPackage->FullyLoad();
-								Mesh->Rename(*MeshName, MeshPackage);
-								Mesh->SetFlags(RF_Public | RF_Standalone);
-								MeshPackage->MarkPackageDirty();
-								FAssetRegistryModule::AssetCreated(Mesh);
-								PackagesToSave.Add(MeshPackage);
-#endif
-							}
+	return FragmentModel;
+}
 
-							UE_LOG(LogFragments, Log, TEXT("SpawnSingleFragment: Created and cached mesh for RepId %d (LocalId: %d) [%d/%d this frame]"),
-								RepresentationId, FragmentModel->GetLocalId(), NewMeshCreationsThisFrame, MaxNewMeshCreationsPerFrame);
-						}
-					}
-					else
-					{
-						// Mesh creation limit reached - skip this sample for now
-						// It will be created on a future frame when this fragment is visible again
-						UE_LOG(LogFragments, Verbose, TEXT("SpawnSingleFragment: Deferred mesh creation for RepId %d (LocalId: %d) - limit reached [%d/%d]"),
-							RepresentationId, FragmentModel->GetLocalId(), NewMeshCreationsThisFrame, MaxNewMeshCreationsPerFrame);
-						continue;  // Skip to next sample
-					}
-				}
-				else
-				{
-					// CircleExtrusion: still use FlatBuffer path (not pre-extracted)
-					// This is acceptable because CircleExtrusion works correctly with FlatBuffer access
+void UFragmentsImporter::ProcessSpawnChunk()
+{
+	// Commit finished mesh builds and attach the samples waiting on them
+	ProcessMeshBuildQueue(TotalFrameBudgetMs * GeometryBudgetRatio);
 
-					// Check mesh creation limit first
-					if (!CanCreateNewMesh())
-					{
-						UE_LOG(LogFragments, Verbose, TEXT("SpawnSingleFragment: Deferred CircleExtrusion mesh creation (LocalId: %d) - limit reached [%d/%d]"),
-							FragmentModel->GetLocalId(), NewMeshCreationsThisFrame, MaxNewMeshCreationsPerFrame);
-						continue;  // Skip to next sample
-					}
+	if (PendingSpawnQueue.Num() == 0)
+	{
+		// Samples still waiting on meshes complete the spawn before it is reported
+		if (MeshBuildRequests.Num() > 0)
+		{
+			return;
+		}
 
-					if (MeshesRef && MeshesRef->representations() && MeshesRef->circle_extrusions())
-					{
-						const uint32 RepCount = MeshesRef->representations()->size();
-						if (static_cast<uint32>(Sample.RepresentationIndex) < RepCount)
-						{
-							const Representation* representation = MeshesRef->representations()->Get(Sample.RepresentationIndex);
-							if (representation && representation->representation_class() == RepresentationClass_CIRCLE_EXTRUSION)
-							{
-								const uint32 ExtrusionId = representation->id();
-								if (ExtrusionId < MeshesRef->circle_extrusions()->size())
-								{
-									const auto* circleExtrusion = MeshesRef->circle_extrusions()->Get(ExtrusionId);
-
-									// Get material from FlatBuffer for CircleExtrusion (still needed)
-									const Material* material = nullptr;
-									if (MeshesRef->materials() && static_cast<uint32>(Sample.MaterialIndex) < MeshesRef->materials()->size())
-									{
-										material = MeshesRef->materials()->Get(Sample.MaterialIndex);
-									}
-
-									Mesh = CreateStaticMeshFromCircleExtrusion(circleExtrusion, material, *MeshName, MeshPackage);
-
-									if (Mesh)
-									{
-										OnNewMeshCreated();
-									}
-								}
-							}
-						}
-					}
+		// Spawning complete
+		UE_LOG(LogFragments, Log, TEXT("Chunked spawning complete! Total fragments: %d"), FragmentsSpawned);
 
-					// Save CircleExtrusion mesh if needed
-					if (Mesh && !FPaths::FileExists(PackageFileName) && bSaveMeshes)
-					{
-#if WITH_EDITOR
-						MeshPackage->FullyLoad();
-						Mesh->Rename(*MeshName, MeshPackage);
-						Mesh->SetFlags(RF_Public | RF_Standalone);
-						MeshPackage->MarkPackageDirty();
-						FAssetRegistryModule::AssetCreated(Mesh);
-						PackagesToSave.Add(MeshPackage);
-#endif
-					}
-				}
+		// FINALIZE ALL ISMCs - batch-add all queued instances
+		// This is the key performance optimization: all instances are added at once
+		// instead of one-at-a-time which causes UE5 GPU buffer rebuilds
+		FinalizeAllISMCs();
 
-				if (Mesh)
-				{
-					MeshCache.Add(SamplePath, Mesh);
-				}
-			}
-
-			if (Mesh)
-			{
-				// Add StaticMeshComponent to parent actor
-				UStaticMeshComponent* MeshComp = NewObject<UStaticMeshComponent>(FragmentModel);
-				MeshComp->SetStaticMesh(Mesh);
-				MeshComp->SetRelativeTransform(LocalTransform);
-				MeshComp->AttachToComponent(RootSceneComponent, FAttachmentTransformRules::KeepRelativeTransform);
-
-				// Disable Lumen/Distance Field features to avoid "Preparing mesh distance fields/cards" delays
-				// These are expensive to compute at runtime for procedurally generated meshes
-				MeshComp->bAffectDistanceFieldLighting = false;  // Skip distance field generation
-				MeshComp->bAffectDynamicIndirectLighting = false; // Skip Lumen indirect lighting
-				MeshComp->bAffectIndirectLightingWhileHidden = false;
-
-				MeshComp->RegisterComponent();
-				FragmentModel->AddInstanceComponent(MeshComp);
-
-				// IMPORTANT: Apply material AFTER registration - material overrides don't persist on unregistered components
-				// This applies the correct material for this sample, which may differ from the mesh's embedded material
-				// (e.g., when the mesh is cached by RepresentationId but different samples have different materials)
-				UMaterialInstanceDynamic* Material = GetPooledMaterial(ExtractedGeom.R, ExtractedGeom.G,
-					ExtractedGeom.B, ExtractedGeom.A, ExtractedGeom.bIsGlass);
-				if (Material)
-				{
-					MeshComp->SetMaterial(0, Material);
-				}
-
-				// Configure occlusion culling based on fragment classification
-				// Use pre-extracted material alpha instead of FlatBuffer access
-				const EOcclusionRole Role = UFragmentOcclusionClassifier::ClassifyFragment(
-					Item.Category, ExtractedGeom.A);
-
-				switch (Role)
-				{
-				case EOcclusionRole::Occluder:
-					// Large structural elements that block visibility
-					MeshComp->bUseAsOccluder = true;
-					MeshComp->SetCastShadow(true);
-					break;
-
-				case EOcclusionRole::Occludee:
-					// Objects that can be hidden by occluders
-					MeshComp->bUseAsOccluder = false;
-					MeshComp->SetCastShadow(true);
-					break;
-
-				case EOcclusionRole::NonOccluder:
-					// Glass/transparent - doesn't block anything
-					MeshComp->bUseAsOccluder = false;
-					MeshComp->SetCastShadow(false);
-					break;
-				}
-			}
-		}
-	}
-
-	// Store in lookup map
-	if (ModelFragmentsMap.Contains(Item.ModelGuid))
-	{
-		ModelFragmentsMap[Item.ModelGuid].Fragments.Add(Item.LocalId, FragmentModel);
-	}
-
-	// NOTE: No recursive child spawning here - handled by chunking system
-
-	return FragmentModel;
-}
-
-void UFragmentsImporter::ProcessSpawnChunk()
-{
-	// Reset per-frame mesh creation counter (for non-TileManager path)
-	NewMeshCreationsThisFrame = 0;
-
-	if (PendingSpawnQueue.Num() == 0)
-	{
-		// Spawning complete
-		UE_LOG(LogFragments, Log, TEXT("Chunked spawning complete! Total fragments: %d"), FragmentsSpawned);
-
-		// FINALIZE ALL ISMCs - batch-add all queued instances
-		// This is the key performance optimization: all instances are added at once
-		// instead of one-at-a-time which causes UE5 GPU buffer rebuilds
-		FinalizeAllISMCs();
-
-		// Clear timer
-		if (UWorld* World = GetWorld())
-		{
-			World->GetTimerManager().ClearTimer(SpawnChunkTimerHandle);
-		}
+		// Clear timer
+		if (UWorld* World = GetWorld())
+		{
+			World->GetTimerManager().ClearTimer(SpawnChunkTimerHandle);
+		}
 
 		// Save meshes if needed
 		if (PackagesToSave.Num() > 0)
@@ -1584,7 +1741,7 @@ void UFragmentsImporter::ProcessSpawnChunk()
 
 		// Spawn this fragment
 		bool bWasInstanced = false;
-		AFragment* SpawnedActor = SpawnSingleFragment(Task.FragmentItem, Task.ParentActor, CurrentMeshesRef, bCurrentSaveMeshes, &bWasInstanced);
+		AFragment* SpawnedActor = SpawnSingleFragment(Task.FragmentItem, Task.ParentActor, CurrentMeshesRef, CurrentSpawningModelKey, bCurrentSaveMeshes, &bWasInstanced);
 
 		if (SpawnedActor)
 		{
@@ -1618,9 +1775,6 @@ void UFragmentsImporter::ProcessSpawnChunk()
 
 void UFragmentsImporter::ProcessAllTileManagerChunks()
 {
-	// Reset per-frame mesh creation counter
-	NewMeshCreationsThisFrame = 0;
-
 	// Sync coordinator settings from UPROPERTY values
 	FrameBudgetCoordinator.TotalFrameBudgetMs = TotalFrameBudgetMs;
 	FrameBudgetCoordinator.GeometryBudgetRatio = GeometryBudgetRatio;
@@ -1630,6 +1784,13 @@ void UFragmentsImporter::ProcessAllTileManagerChunks()
 	// Begin coordinated frame budget
 	FrameBudgetCoordinator.BeginFrame();
 
+	// Mesh commits (geometry share of the budget): finished builds are attached before new spawns
+	FBudgetAllocationResult GeometryBudget = FrameBudgetCoordinator.AllocateGeometryBudget();
+	if (GeometryBudget.bHasBudget)
+	{
+		ProcessMeshBuildQueue(GeometryBudget.BudgetMs);
+	}
+
 	// Spawning (budget split among TileManagers)
 	const int32 TMCount = TileManagers.Num();
 	int32 TMIndex = 0;
@@ -1661,6 +1822,9 @@ void UFragmentsImporter::ProcessAllTileManagerChunks()
 		TMIndex++;
 	}
 
+	// HISMCs of the groups whose batches finished sorting on the workers, in what is left of the frame
+	FinalizeISMCsWithBudget(FrameBudgetCoordinator.GetRemainingBudgetMs());
+
 	// End frame (logs statistics periodically)
 	FrameBudgetCoordinator.EndFrame();
 
@@ -1694,6 +1858,15 @@ void UFragmentsImporter::UpdateTileStreaming(const FVector& CameraLocation, cons
 			TileManager->UpdateVisibleTiles(CameraLocation, CameraRotation, FOV, AspectRatio, ViewportHeight);
 		}
 	}
+
+	// The view or thresholds may have changed above: the groups' cull distances follow
+	RefreshGroupCullDistances();
+
+	// Instanced fragments hidden, shown or evicted above: one HISMC update per touched group
+	FlushInstanceVisibility();
+
+	// Meshes and materials of fragments evicted above become releasable
+	TrimResourceCaches();
 }
 
 void UFragmentsImporter::StartChunkedSpawning(const FFragmentItem& RootItem, AActor* OwnerActor, const Meshes* MeshesRef, bool bSaveMeshes)
@@ -1710,6 +1883,8 @@ void UFragmentsImporter::StartChunkedSpawning(const FFragmentItem& RootItem, AAc
 	CurrentMeshesRef = MeshesRef;
 	bCurrentSaveMeshes = bSaveMeshes;
 	CurrentSpawningModelGuid = RootItem.ModelGuid;
+	const UFragmentModelWrapper* Wrapper = GetFragmentModel(RootItem.ModelGuid);
+	CurrentSpawningModelKey = Wrapper ? Wrapper->GetContentHash() : 0;
 
 	// Add root to queue
 	PendingSpawnQueue.Add(FFragmentSpawnTask(RootItem, OwnerActor));
@@ -1730,21 +1905,67 @@ void UFragmentsImporter::StartChunkedSpawning(const FFragmentItem& RootItem, AAc
 
 UStaticMesh* UFragmentsImporter::CreateStaticMeshFromShell(const Shell* ShellRef, const Material* RefMaterial, const FString& AssetName, UObject* OuterRef)
 {
+	// Gather the shell into the same layout the pre-extracted path uses
+	FPreExtractedGeometry Geometry;
+	const auto* Points = ShellRef->points();
+	Geometry.Vertices.Reserve(Points->size());
+	for (flatbuffers::uoffset_t i = 0; i < Points->size(); i++)
+	{
+		const auto& P = *Points->Get(i);
+		Geometry.Vertices.Add(FVector(P.x() * 100, P.z() * 100, P.y() * 100)); // Fix Z-up, and Unreal Units from m to cm
+	}
+
+	const auto* Profiles = ShellRef->profiles();
+	Geometry.ProfileIndices.SetNum(Profiles->size());
+	Geometry.ProfileHoles.SetNum(Profiles->size());
+	for (flatbuffers::uoffset_t i = 0; i < Profiles->size(); i++)
+	{
+		const auto* Indices = Profiles->Get(i)->indices();
+		for (flatbuffers::uoffset_t j = 0; j < Indices->size(); j++)
+		{
+			Geometry.ProfileIndices[i].Add(Indices->Get(j));
+		}
+	}
+
+	const auto* Holes = ShellRef->holes();
+	for (flatbuffers::uoffset_t j = 0; j < Holes->size(); j++)
+	{
+		const auto* Hole = Holes->Get(j);
+		if (!Geometry.ProfileHoles.IsValidIndex(Hole->profile_id()))
+		{
+			continue;
+		}
+
+		TArray<int32>& HoleIdx = Geometry.ProfileHoles[Hole->profile_id()].AddDefaulted_GetRef();
+		const auto* HoleIndices = Hole->indices();
+		for (flatbuffers::uoffset_t k = 0; k < HoleIndices->size(); k++)
+		{
+			HoleIdx.Add(HoleIndices->Get(k));
+		}
+	}
+
+	// Each profile becomes one vertex ring with its analytic plane normal
+	FFragmentMeshBuildData BuildData;
+	if (!FFragmentMeshBuilder::BuildShellData(Geometry, TriangulationBackend, BuildData.Lods.AddDefaulted_GetRef()))
+	{
+		UE_LOG(LogFragments, Warning, TEXT("CreateStaticMeshFromShell: No valid polygons for %s"), *AssetName);
+		return nullptr;
+	}
+
 	// Create StaticMesh object
 	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(OuterRef, FName(*AssetName), RF_Public | RF_Standalone /*| RF_Transient*/);
 	StaticMesh->InitResources();
 	StaticMesh->SetLightingGuid();
 
-	UStaticMeshDescription* StaticMeshDescription = StaticMesh->CreateStaticMeshDescription(OuterRef);
-	FMeshDescription& MeshDescription = StaticMeshDescription->GetMeshDescription();
 	UStaticMesh::FBuildMeshDescriptionsParams MeshParams;
 
 	//Build Settings
 #if WITH_EDITOR
 	{
 		FStaticMeshSourceModel& SrcModel = StaticMesh->AddSourceModel();
-		SrcModel.BuildSettings.bRecomputeNormals = true;
-		SrcModel.BuildSettings.bRecomputeTangents = true;
+		// Normals and tangents come from BuildShellData
+		SrcModel.BuildSettings.bRecomputeNormals = false;
+		SrcModel.BuildSettings.bRecomputeTangents = false;
 		SrcModel.BuildSettings.bRemoveDegenerates = true;
 		SrcModel.BuildSettings.bUseHighPrecisionTangentBasis = false;
 		SrcModel.BuildSettings.bBuildReversedIndexBuffer = true;
@@ -1765,141 +1986,11 @@ UStaticMesh* UFragmentsImporter::CreateStaticMeshFromShell(const Shell* ShellRef
 	MeshParams.bFastBuild = true;
 #endif
 
-	// Convert Shell Geometry (vertices and triangles)
-	const auto* Points = ShellRef->points();
-	TArray<FVector> PointsRef;
-	TArray<FVertexID> Vertices;
-	Vertices.Reserve(Points->size());
-
-	for (flatbuffers::uoffset_t i = 0; i < Points->size(); i++)
-	{
-		const auto& P = *Points->Get(i);
-		const FVertexID VertId = StaticMeshDescription->CreateVertex();
-		StaticMeshDescription->SetVertexPosition(VertId, FVector(P.x()*100, P.z()*100, P.y()*100)); // Fix Z-up, and Unreal Units from m to cm
-		PointsRef.Add(FVector(P.x() * 100, P.z() * 100, P.y() * 100));
-		Vertices.Add(VertId);
-
-	}
+	FFragmentMeshBuilder::BuildMeshDescriptions(BuildData);
 
+	FMeshDescription& MeshDescription = BuildData.Lods[0].MeshDescription;
 	FName MaterialSlotName = AddMaterialToMesh(StaticMesh, RefMaterial);
-	const FPolygonGroupID PolygonGroupId = StaticMeshDescription->CreatePolygonGroup();
-	StaticMeshDescription->SetPolygonGroupMaterialSlotName(PolygonGroupId, MaterialSlotName);
-
-	// Map the holes and identify the profiles that has holes
-	const auto* Holes = ShellRef->holes();
-	TMap<int32, TArray<TArray<int32>>> ProfileHolesIdx;
-	for (flatbuffers::uoffset_t j = 0; j < Holes->size(); j++)
-	{
-		const auto* Hole = Holes->Get(j);
-		const auto* HoleIndices = Hole->indices();
-		const auto Profile_id = Hole->profile_id();
-		TArray<int32> HoleIdx;
-
-		for (flatbuffers::uoffset_t k = 0; k < HoleIndices->size(); k++)
-		{
-			HoleIdx.Add(HoleIndices->Get(k));
-		}
-
-		if (ProfileHolesIdx.Contains(Profile_id))
-		{
-			ProfileHolesIdx[Profile_id].Add(HoleIdx);
-		}
-		else
-		{
-			TArray<TArray<int32>> HolesForProfile;
-			HolesForProfile.Add(HoleIdx);
-			ProfileHolesIdx.Add(Profile_id, HolesForProfile);
-		}
-	}
-	// Create Faces (triangles)
-	const auto* Profiles = ShellRef->profiles();
-	TMap<int32, FPolygonID> PolygonMap;
-	
-	for (flatbuffers::uoffset_t i = 0; i < Profiles->size(); i++)
-	{
-		// Create Profile Polygons for those that has no holes reference
-		if (!ProfileHolesIdx.Contains(i))
-		{
-			const ShellProfile* Profile = Profiles->Get(i);
-			const auto* Indices = Profile->indices();
-
-			TArray<FVertexInstanceID> VertexInstances;
-			VertexInstances.Reserve(Indices->size());
-			TArray<FVertexInstanceID> TriangleInstance;
-			for (flatbuffers::uoffset_t j = 0; j < Indices->size(); j++)
-			{
-				const auto Indice = Indices->Get(j);
-				if (Vertices.IsValidIndex(Indice))
-				{
-					TriangleInstance.Add(MeshDescription.CreateVertexInstance(Vertices[Indice]));
-				}
-				else
-					UE_LOG(LogFragments, Log, TEXT("Invalid Indice: shell %s, profile %d, indice %d"), *AssetName, i, j);
-			}
-
-
-			if (!TriangleInstance.IsEmpty())
-			{
-				FPolygonID PolygonID = MeshDescription.CreatePolygon(PolygonGroupId, TriangleInstance, {});
-			}
-		}
-		// Process profile with holes to create new polygon that fully represent the substraction of holes in profile
-		else
-		{
-			const ShellProfile* Profile = Profiles->Get(i);
-			const auto* Indices = Profile->indices();
-			if (Indices->size() < 3)
-			{
-				UE_LOG(LogFragments, Error, TEXT("Profile %d skipped: fewer than 3 points"), i);
-				continue;
-			}
-
-			TArray<FVector> ProfilePoints;
-			TArray<int32> ProfilePointsIndex;
-			for (flatbuffers::uoffset_t j = 0; j < Indices->size(); j++)
-			{
-				const auto Indice = Indices->Get(j);
-				ProfilePointsIndex.Add(Indice);
-				const auto* Point = Points->Get(Indice);
-				FVector Vector = FVector(Point->x() * 100, Point->y() * 100, Point->z() * 100);
-				ProfilePoints.Add(Vector);
-			}
-
-			TArray<TArray<FVector>> ProfileHolesPoints;
-
-			TArray<int32> OutIndices;
-			TArray<FVector> OutVertices;
-			if (!TriangulatePolygonWithHoles(PointsRef, ProfilePointsIndex, ProfileHolesIdx[i], OutVertices, OutIndices))
-			{
-				UE_LOG(LogFragments, Error, TEXT("Profile %d skipped: Triangulation failed"), i);
-				continue;
-			}
-
-			TMap<int32, FVertexID> TempVertexMap;
-			for (int32 j = 0; j < OutVertices.Num(); j++)
-			{
-				FVertexID VId = StaticMeshDescription->CreateVertex();
-				StaticMeshDescription->SetVertexPosition(VId, OutVertices[j]);
-				TempVertexMap.Add(j, VId);
-			}
-
-			for (int32 j = 0; j < OutIndices.Num(); j+=3)
-			{
-				TArray<FVertexInstanceID> Triangle;
-
-				Triangle.Add(MeshDescription.CreateVertexInstance(TempVertexMap[OutIndices[j]]));
-				Triangle.Add(MeshDescription.CreateVertexInstance(TempVertexMap[OutIndices[j+1]]));
-				Triangle.Add(MeshDescription.CreateVertexInstance(TempVertexMap[OutIndices[j+2]]));
-				
-				if (!Triangle.IsEmpty())
-					MeshDescription.CreatePolygon(PolygonGroupId, Triangle);
-			}
-
-		}
-	}
-	
-	FStaticMeshOperations::ComputeTriangleTangentsAndNormals(MeshDescription);
-	FStaticMeshOperations::ComputeTangentsAndNormals(MeshDescription, EComputeNTBsFlags::Normals | EComputeNTBsFlags::Tangents);
+	FStaticMeshAttributes(MeshDescription).GetPolygonGroupMaterialSlotNames()[FPolygonGroupID(0)] = MaterialSlotName;
 
 	StaticMesh->BuildFromMeshDescriptions(TArray<const FMeshDescription*>{&MeshDescription}, MeshParams);
 
@@ -1997,142 +2088,127 @@ bool UFragmentsImporter::TriangulatePolygonWithHoles(const TArray<FVector>& Poin
 	TArray<FVector>& OutVertices,
 	TArray<int32>& OutIndices)
 {
-	TESStesselator* Tess = tessNewTess(nullptr);
-	FPlaneProjection Projection = UFragmentsUtils::BuildProjectionPlane(Points, Profiles);
-	
-	auto AddContour = [&](const TArray<int32>& Indices, bool bIsHole)
-		{
-			TArray<FVector2D> Projected;
-			TArray<float> Contour;
+	return FTriangulation::Triangulate(TriangulationBackend, Points, Profiles, Holes, OutVertices, OutIndices);
+}
 
-			for (int32 Index : Indices)
-			{
-				FVector2D P2d = Projection.Project(Points[Index]);
-				Projected.Add(P2d);
-			}
+FString UFragmentsImporter::BenchmarkTriangulation(const FString& ModelGuid, int32 Iterations)
+{
+	UFragmentModelWrapper* Wrapper = GetFragmentModel(ModelGuid);
+	if (!Wrapper)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("BenchmarkTriangulation: Model %s is not loaded"), *ModelGuid);
+		return FString();
+	}
 
-			if (Projected.Num() < 3)
+	Iterations = FMath::Max(1, Iterations);
+
+	// Collect each unique profile with holes once (representations are shared by many samples)
+	TArray<FTriangulationPolygon> Polygons;
+	TArray<const TArray<FVector>*> PolygonPoints;
+	TSet<int64> SeenProfiles;
+
+	const double PrepareStart = FPlatformTime::Seconds();
+	TArray<const FFragmentItem*> Stack;
+	Stack.Add(&Wrapper->GetModelItemRef());
+
+	while (Stack.Num() > 0)
+	{
+		const FFragmentItem* Item = Stack.Pop();
+
+		for (const FFragmentSample& Sample : Item->Samples)
+		{
+			const FPreExtractedGeometry& Geometry = Sample.ExtractedGeometry;
+			if (!Geometry.bIsValid || !Geometry.bIsShell)
 			{
-				UE_LOG(LogFragments, Error, TEXT("Contour has fewer than 3 points, skipping."));
-				return;
+				continue;
 			}
 
-			// Check for colinearity
-			bool bColinear = true;
-			const FVector2D& A = Projected[0];
-
-			for (int i = 1; i < Projected.Num() - 1; ++i)
+			for (int32 ProfileIdx = 0; ProfileIdx < Geometry.ProfileHoles.Num() && ProfileIdx < Geometry.ProfileIndices.Num(); ProfileIdx++)
 			{
-				FVector2D Dir1 = (Projected[i] - A).GetSafeNormal();
-				FVector2D Dir2 = (Projected[i + 1] - Projected[i]).GetSafeNormal();
-				if (!Dir1.Equals(Dir2, 0.001f))
+				const int64 ProfileKey = ((int64)Geometry.RepresentationId << 32) | (uint32)ProfileIdx;
+				if (Geometry.ProfileHoles[ProfileIdx].Num() == 0 || SeenProfiles.Contains(ProfileKey))
 				{
-					bColinear = false;
-					break;
+					continue;
 				}
-			}
-			if (bColinear)
-			{
-				UE_LOG(LogFragments, Error, TEXT("Contour is colinear in 2D projection, skipping."));
-				return;
-			}
-
-			TArray<FVector2D> UniqueProjected;
-			UniqueProjected.Reserve(Projected.Num());
+				SeenProfiles.Add(ProfileKey);
 
-			for (int32 i = 0; i < Projected.Num(); ++i)
-			{
-				if (i == 0 || !Projected[i].Equals(Projected[i - 1], 0.001))
+				FTriangulationPolygon Polygon;
+				if (FTriangulation::PreparePolygon(Geometry.Vertices, Geometry.ProfileIndices[ProfileIdx], Geometry.ProfileHoles[ProfileIdx], Polygon))
 				{
-					UniqueProjected.Add(Projected[i]);
+					Polygons.Add(MoveTemp(Polygon));
+					PolygonPoints.Add(&Geometry.Vertices);
 				}
 			}
-			Projected = UniqueProjected;
-
-			// Fix winding
-			bool bClockwise = UFragmentsUtils::IsClockwise(Projected);
+		}
 
-			if (!bIsHole && bClockwise)
-			{
-				Algo::Reverse(Projected); // Outer should be CCW
-			}
-			else if (bIsHole && !bClockwise)
-			{
-				Algo::Reverse(Projected); // Holes should be CW
-			}
-			
-			for (const FVector2D& P : Projected)
+		for (const FFragmentItem* Child : Item->FragmentChildren)
+		{
+			if (Child)
 			{
-				Contour.Add(P.X);
-				Contour.Add(P.Y);
+				Stack.Add(Child);
 			}
+		}
+	}
+	const double PrepareMs = (FPlatformTime::Seconds() - PrepareStart) * 1000.0;
 
-			tessAddContour(Tess, 2, Contour.GetData(), sizeof(float) * 2, Projected.Num());
-		};
-
-	AddContour(Profiles, false);
-
-	for (const TArray<int32>& Hole : Holes)
+	if (Polygons.Num() == 0)
 	{
-		AddContour(Hole, true);
+		return FString::Printf(TEXT("BenchmarkTriangulation: No profiles with holes in model %s"), *ModelGuid);
 	}
 
-	if (!tessTesselate(Tess, TESS_WINDING_ODD, TESS_POLYGONS, 3, 2, nullptr))
+	int32 TotalPoints = 0;
+	int32 AutoEarClipping = 0;
+	for (const FTriangulationPolygon& Polygon : Polygons)
 	{
-		UE_LOG(LogFragments, Error, TEXT("tessTesselate failed."));
-		tessDeleteTess(Tess);
-		return false;
+		TotalPoints += Polygon.Points2D.Num();
+		AutoEarClipping += (FTriangulation::SelectBackend(Polygon) == ETriangulationBackend::EarClipping) ? 1 : 0;
 	}
 
-	const int32 VertexCount = tessGetVertexCount(Tess);
-	const TESSreal* Vertices = tessGetVertices(Tess);
+	FString Report = FString::Printf(TEXT("Triangulation benchmark for %s: %d profiles, %d points, %d iterations, prepare %.2f ms\n"),
+		*ModelGuid, Polygons.Num(), TotalPoints, Iterations, PrepareMs);
+
+	TArray<FVector> OutVertices;
+	TArray<int32> OutIndices;
 
-	if (VertexCount == 0)
+	for (ETriangulationBackend Mode : { ETriangulationBackend::LibTess2, ETriangulationBackend::EarClipping, ETriangulationBackend::Auto })
 	{
-		for (const int32& P : Profiles)
-		{
-			UE_LOG(LogFragments, Warning, TEXT("\tPoints of Vertex 0 X: %.6f, Y: %.6f, Z: %.6f"), Points[P].X, Points[P].Y, Points[P].Z);
-		}
+		int32 Failures = 0;
+		int64 Triangles = 0;
 
-		int32 HoleIdx = 0;
-		for (const auto& H : Holes)
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
 		{
-			for (const int32& P : H)
+			for (int32 i = 0; i < Polygons.Num(); i++)
 			{
-				UE_LOG(LogFragments, Warning, TEXT("\tPoints of Hole %d 0 X: %.6f, Y: %.6f, Z: %.6f"), HoleIdx, Points[P].X, Points[P].Y, Points[P].Z);
-			}
-			HoleIdx++;
-		}
-	}
-
-	TMap<int32, int32> IndexRemap;
+				OutVertices.Reset();
+				OutIndices.Reset();
 
-	for (int32 i = 0; i < VertexCount; i++)
-	{
-		FVector2D P2d(Vertices[i * 2], Vertices[i * 2 + 1]);
-		FVector P3d = Projection.Unproject(P2d);
-		IndexRemap.Add(i, OutVertices.Num());
-		OutVertices.Add(P3d);
-	}
-	const int32* Indices = tessGetElements(Tess);
-	const int32 ElementCount = tessGetElementCount(Tess);
+				// Auto goes through the same selection + fallback as the import path
+				ETriangulationBackend Selected = (Mode == ETriangulationBackend::Auto) ? FTriangulation::SelectBackend(Polygons[i]) : Mode;
+				bool bSuccess = FTriangulation::GetBackend(Selected).Triangulate(Polygons[i], *PolygonPoints[i], OutVertices, OutIndices);
+				if (!bSuccess && Mode == ETriangulationBackend::Auto && Selected == ETriangulationBackend::EarClipping)
+				{
+					bSuccess = FTriangulation::GetBackend(ETriangulationBackend::LibTess2).Triangulate(Polygons[i], *PolygonPoints[i], OutVertices, OutIndices);
+				}
 
-	for (int32 i = 0; i < ElementCount; ++i)
-	{
-		const int32* Poly = &Indices[i * 3];
-		for (int j = 0; j < 3; ++j)
-		{
-			int32 Idx = Poly[j];
-			if (Idx != TESS_UNDEF)
-			{
-				OutIndices.Add(IndexRemap[Idx]);
+				if (Iteration == 0)
+				{
+					Failures += bSuccess ? 0 : 1;
+					Triangles += OutIndices.Num() / 3;
+				}
 			}
 		}
+		const double ElapsedMs = (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+
+		const TCHAR* ModeName = (Mode == ETriangulationBackend::Auto) ? TEXT("Auto") : FTriangulation::GetBackend(Mode).GetName();
+		Report += FString::Printf(TEXT("  %-12s %8.3f ms/pass  %7.2f us/profile  %lld tris  %d failed\n"),
+			ModeName, ElapsedMs, ElapsedMs * 1000.0 / Polygons.Num(), Triangles, Failures);
 	}
 
-	tessDeleteTess(Tess);
+	Report += FString::Printf(TEXT("  Auto selects ear clipping for %d / %d profiles"), AutoEarClipping, Polygons.Num());
 
-	return true;
+	UE_LOG(LogFragments, Log, TEXT("%s"), *Report);
+	return Report;
 }
 
 void UFragmentsImporter::BuildFullCircleExtrusion(UStaticMeshDescription& StaticMeshDescription, const CircleExtrusion* CircleExtrusion, const Material* RefMaterial, UStaticMesh* StaticMesh)
@@ -2540,52 +2616,350 @@ uint32 UFragmentsImporter::HashMaterialProperties(uint8 R, uint8 G, uint8 B, uin
 	return Hash;
 }
 
-UMaterialInstanceDynamic* UFragmentsImporter::GetPooledMaterial(uint8 R, uint8 G, uint8 B, uint8 A, bool bIsGlass)
+uint32 UFragmentsImporter::GetGroupMaterialHash(uint8 R, uint8 G, uint8 B, uint8 A, bool bIsGlass) const
 {
-	uint32 Hash = HashMaterialProperties(R, G, B, A, bIsGlass);
-
-	if (UMaterialInstanceDynamic** Found = MaterialPool.Find(Hash))
+	// Shared color material: the color travels with each instance, only the blend mode splits groups
+	if (bSharedColorMaterialActive)
 	{
-		return *Found;
+		return bIsGlass ? 2u : 1u;
 	}
+	return HashMaterialProperties(R, G, B, A, bIsGlass);
+}
 
-	// Create new material instance
-	UMaterialInterface* BaseMat = bIsGlass ? BaseGlassMaterial : BaseMaterial;
-	if (!BaseMat)
+void UFragmentsImporter::ResolveColorMaterialMode()
+{
+	if (bColorMaterialModeResolved)
 	{
-		// Load materials if not already loaded
-		BaseGlassMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/FragmentsUnreal/Materials/M_BaseFragmentGlassMaterial.M_BaseFragmentGlassMaterial"));
-		BaseMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/FragmentsUnreal/Materials/M_BaseFragmentMaterial.M_BaseFragmentMaterial"));
-		BaseMat = bIsGlass ? BaseGlassMaterial : BaseMaterial;
+		return;
 	}
+	bColorMaterialModeResolved = true;
 
-	if (!BaseMat)
+	if (!bUseSharedColorMaterial)
 	{
-		UE_LOG(LogFragments, Error, TEXT("Failed to load base material for pooling"));
-		return nullptr;
+		return;
 	}
 
-	UMaterialInstanceDynamic* NewMat = UMaterialInstanceDynamic::Create(BaseMat, this);
-	if (!NewMat)
+	UMaterialInterface* Opaque = SharedColorMaterial.LoadSynchronous();
+	UMaterialInterface* Glass = SharedColorGlassMaterial.LoadSynchronous();
+	if (!Opaque || !Glass)
 	{
-		return nullptr;
+		UE_LOG(LogFragments, Warning, TEXT("Shared color material requested but %s could not be loaded; using one material instance per color"),
+			!Opaque ? *SharedColorMaterial.ToString() : *SharedColorGlassMaterial.ToString());
+		return;
 	}
 
-	float Rf = R / 255.f;
-	float Gf = G / 255.f;
-	float Bf = B / 255.f;
-	float Af = A / 255.f;
+	SharedColorInstances[0] = UMaterialInstanceDynamic::Create(Opaque, this);
+	SharedColorInstances[1] = UMaterialInstanceDynamic::Create(Glass, this);
+	bSharedColorMaterialActive = SharedColorInstances[0] && SharedColorInstances[1];
 
-	if (Af < 1.0f)
+	UE_LOG(LogFragments, Log, TEXT("Shared color material %s: instanced groups are keyed on geometry and blend mode only"),
+		bSharedColorMaterialActive ? TEXT("enabled") : TEXT("failed"));
+}
+
+void UFragmentsImporter::SetInstanceColor(UInstancedStaticMeshComponent* Component, int32 InstanceIndex, const FColor& Color, bool bMarkRenderStateDirty) const
+{
+	if (!bSharedColorMaterialActive || !Component)
 	{
-		NewMat->SetScalarParameterValue(TEXT("Opacity"), Af);
+		return;
+	}
+
+	const float Values[4] = { Color.R / 255.f, Color.G / 255.f, Color.B / 255.f, Color.A / 255.f };
+	for (int32 Channel = 0; Channel < 4; ++Channel)
+	{
+		Component->SetCustomDataValue(InstanceIndex, InstanceColorCustomDataIndex + Channel, Values[Channel],
+			bMarkRenderStateDirty && Channel == 3);
+	}
+}
+
+void UFragmentsImporter::ApplyColorMaterial(UMeshComponent* Component, const FColor& Color)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	if (UMaterialInstanceDynamic* Material = GetColorMaterial(Color))
+	{
+		// The component holds one reference on the material it overrides with
+		UMaterialInterface* Previous = Component->GetNumOverrideMaterials() > 0 ? Component->OverrideMaterials[0] : nullptr;
+		if (Material != Previous)
+		{
+			AcquirePooledMaterial(Material);
+			ReleasePooledMaterial(Previous);
+		}
+		Component->SetMaterial(0, Material);
+	}
+
+	if (bSharedColorMaterialActive)
+	{
+		Component->SetCustomPrimitiveDataVector4(InstanceColorCustomDataIndex,
+			FVector4(Color.R / 255.f, Color.G / 255.f, Color.B / 255.f, Color.A / 255.f));
+	}
+}
+
+UMaterialInstanceDynamic* UFragmentsImporter::GetPooledMaterial(uint8 R, uint8 G, uint8 B, uint8 A, bool bIsGlass)
+{
+	ResolveColorMaterialMode();
+	if (bSharedColorMaterialActive)
+	{
+		return SharedColorInstances[bIsGlass ? 1 : 0];
+	}
+
+	uint32 Hash = HashMaterialProperties(R, G, B, A, bIsGlass);
+
+	if (FPooledMaterial* Found = MaterialPool.Find(Hash))
+	{
+		return Found->Material;
+	}
+
+	// Create new material instance
+	UMaterialInterface* BaseMat = bIsGlass ? BaseGlassMaterial : BaseMaterial;
+	if (!BaseMat)
+	{
+		// Load materials if not already loaded
+		BaseGlassMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/FragmentsUnreal/Materials/M_BaseFragmentGlassMaterial.M_BaseFragmentGlassMaterial"));
+		BaseMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/FragmentsUnreal/Materials/M_BaseFragmentMaterial.M_BaseFragmentMaterial"));
+		BaseMat = bIsGlass ? BaseGlassMaterial : BaseMaterial;
+	}
+
+	if (!BaseMat)
+	{
+		UE_LOG(LogFragments, Error, TEXT("Failed to load base material for pooling"));
+		return nullptr;
+	}
+
+	UMaterialInstanceDynamic* NewMat = UMaterialInstanceDynamic::Create(BaseMat, this);
+	if (!NewMat)
+	{
+		return nullptr;
+	}
+
+	float Rf = R / 255.f;
+	float Gf = G / 255.f;
+	float Bf = B / 255.f;
+	float Af = A / 255.f;
+
+	if (Af < 1.0f)
+	{
+		NewMat->SetScalarParameterValue(TEXT("Opacity"), Af);
 	}
 	NewMat->SetVectorParameterValue(TEXT("BaseColor"), FVector4(Rf, Gf, Bf, Af));
 
-	MaterialPool.Add(Hash, NewMat);
+	FPooledMaterial& Pooled = MaterialPool.Add(Hash);
+	Pooled.Material = NewMat;
+	Pooled.ResourceBytes = FFragmentResourceLedger::GetMaterialBytes(NewMat);
+	Pooled.LastUsedTime = FPlatformTime::Seconds();
+	PooledMaterialHashes.Add(NewMat, Hash);
+	CachedResourceBytes += Pooled.ResourceBytes;
+	bResourceCachesTrimmable = true;
 	return NewMat;
 }
 
+void UFragmentsImporter::AcquirePooledMaterial(const UMaterialInterface* Material)
+{
+	if (const uint32* Hash = Material ? PooledMaterialHashes.Find(Material) : nullptr)
+	{
+		FPooledMaterial& Pooled = MaterialPool[*Hash];
+		Pooled.RefCount++;
+		Pooled.LastUsedTime = FPlatformTime::Seconds();
+	}
+}
+
+void UFragmentsImporter::ReleasePooledMaterial(const UMaterialInterface* Material)
+{
+	if (const uint32* Hash = Material ? PooledMaterialHashes.Find(Material) : nullptr)
+	{
+		FPooledMaterial& Pooled = MaterialPool[*Hash];
+		Pooled.RefCount = FMath::Max(0, Pooled.RefCount - 1);
+		Pooled.LastUsedTime = FPlatformTime::Seconds();
+		bResourceCachesTrimmable |= Pooled.RefCount == 0;
+	}
+}
+
+void UFragmentsImporter::CacheRepresentationMesh(uint64 MeshKey, UStaticMesh* Mesh, uint64 SourceModelKey)
+{
+	FCachedRepresentationMesh& Cached = RepresentationMeshCache.Add(MeshKey);
+	Cached.Mesh = Mesh;
+	Cached.SourceModelKey = SourceModelKey;
+	Cached.ResourceBytes = FFragmentResourceLedger::GetMeshBytes(Mesh);
+	Cached.LastUsedTime = FPlatformTime::Seconds();
+
+	RepresentationMeshKeys.Add(Mesh, MeshKey);
+	CachedResourceBytes += Cached.ResourceBytes;
+	bResourceCachesTrimmable = true;
+
+	// The mesh's own material slot keeps the pooled material alive as long as the mesh is cached
+	AcquirePooledMaterial(Mesh->GetMaterial(0));
+}
+
+void UFragmentsImporter::AcquireRepresentationMesh(const UStaticMesh* Mesh)
+{
+	if (const uint64* MeshKey = Mesh ? RepresentationMeshKeys.Find(Mesh) : nullptr)
+	{
+		FCachedRepresentationMesh& Cached = RepresentationMeshCache[*MeshKey];
+		Cached.RefCount++;
+		Cached.LastUsedTime = FPlatformTime::Seconds();
+	}
+}
+
+void UFragmentsImporter::ReleaseRepresentationMesh(const UStaticMesh* Mesh)
+{
+	if (const uint64* MeshKey = Mesh ? RepresentationMeshKeys.Find(Mesh) : nullptr)
+	{
+		FCachedRepresentationMesh& Cached = RepresentationMeshCache[*MeshKey];
+		Cached.RefCount = FMath::Max(0, Cached.RefCount - 1);
+		Cached.LastUsedTime = FPlatformTime::Seconds();
+		bResourceCachesTrimmable |= Cached.RefCount == 0;
+	}
+}
+
+void UFragmentsImporter::ReleaseComponentResources(UMeshComponent* Component)
+{
+	if (!Component)
+	{
+		return;
+	}
+
+	if (const UStaticMeshComponent* MeshComp = Cast<UStaticMeshComponent>(Component))
+	{
+		ReleaseRepresentationMesh(MeshComp->GetStaticMesh());
+	}
+
+	if (Component->GetNumOverrideMaterials() > 0)
+	{
+		ReleasePooledMaterial(Component->OverrideMaterials[0]);
+	}
+}
+
+void UFragmentsImporter::ReleaseFragmentResources(AFragment* FragmentActor)
+{
+	if (!FragmentActor)
+	{
+		return;
+	}
+
+	TArray<UStaticMeshComponent*> MeshComponents;
+	FragmentActor->GetComponents<UStaticMeshComponent>(MeshComponents);
+	for (UStaticMeshComponent* MeshComp : MeshComponents)
+	{
+		ReleaseComponentResources(MeshComp);
+	}
+}
+
+void UFragmentsImporter::DestroyFragmentActor(AFragment* FragmentActor)
+{
+	if (!FragmentActor)
+	{
+		return;
+	}
+
+	if (FFragmentLookup* Lookup = ModelFragmentsMap.Find(FragmentActor->GetModelGuid()))
+	{
+		if (Lookup->Fragments.FindRef(FragmentActor->GetLocalId()) == FragmentActor)
+		{
+			Lookup->Fragments.Remove(FragmentActor->GetLocalId());
+		}
+	}
+
+	ReleaseFragmentResources(FragmentActor);
+	FragmentActor->Destroy();
+}
+
+void UFragmentsImporter::RefreshFragmentCullDistance(AFragment* FragmentActor) const
+{
+	if (!FragmentActor)
+	{
+		return;
+	}
+
+	const float CullDistance = GetFragmentCullDistance(FragmentActor->GetModelGuid(), FragmentActor->GetLocalId());
+	TArray<UStaticMeshComponent*> MeshComponents;
+	FragmentActor->GetComponents<UStaticMeshComponent>(MeshComponents);
+	for (UStaticMeshComponent* MeshComp : MeshComponents)
+	{
+		MeshComp->SetCullDistance(CullDistance);
+	}
+}
+
+void UFragmentsImporter::TrimResourceCaches()
+{
+	// Nothing became releasable since the last pass: scanning again would find the same entries
+	const int64 BudgetBytes = static_cast<int64>(ResourceCacheBudgetMB) * 1024 * 1024;
+	if (CachedResourceBytes <= BudgetBytes || !bResourceCachesTrimmable)
+	{
+		return;
+	}
+	bResourceCachesTrimmable = false;
+
+	struct FReleaseCandidate
+	{
+		double LastUsedTime;
+		uint64 Key;
+		bool bMaterial;
+	};
+
+	// Only entries nothing draws with may go; the rest stay even when over budget
+	TArray<FReleaseCandidate> Candidates;
+	for (const TPair<uint64, FCachedRepresentationMesh>& Pair : RepresentationMeshCache)
+	{
+		if (Pair.Value.RefCount <= 0)
+		{
+			Candidates.Add({ Pair.Value.LastUsedTime, Pair.Key, false });
+		}
+	}
+	for (const TPair<uint32, FPooledMaterial>& Pair : MaterialPool)
+	{
+		if (Pair.Value.RefCount <= 0)
+		{
+			Candidates.Add({ Pair.Value.LastUsedTime, Pair.Key, true });
+		}
+	}
+
+	Candidates.Sort([](const FReleaseCandidate& A, const FReleaseCandidate& B)
+	{
+		return A.LastUsedTime < B.LastUsedTime;
+	});
+
+	int32 ReleasedMeshes = 0;
+	int32 ReleasedMaterials = 0;
+	for (const FReleaseCandidate& Candidate : Candidates)
+	{
+		if (CachedResourceBytes <= BudgetBytes)
+		{
+			break;
+		}
+
+		// Dropping the cache entry is enough: the object is collected once no component holds it
+		if (Candidate.bMaterial)
+		{
+			FPooledMaterial Pooled;
+			if (MaterialPool.RemoveAndCopyValue(static_cast<uint32>(Candidate.Key), Pooled))
+			{
+				PooledMaterialHashes.Remove(Pooled.Material);
+				CachedResourceBytes -= Pooled.ResourceBytes;
+				ReleasedMaterials++;
+			}
+		}
+		else
+		{
+			FCachedRepresentationMesh Cached;
+			if (RepresentationMeshCache.RemoveAndCopyValue(Candidate.Key, Cached))
+			{
+				RepresentationMeshKeys.Remove(Cached.Mesh);
+				CachedResourceBytes -= Cached.ResourceBytes;
+				ReleasePooledMaterial(Cached.Mesh ? Cached.Mesh->GetMaterial(0) : nullptr);
+				ReleasedMeshes++;
+			}
+		}
+	}
+
+	if (ReleasedMeshes > 0 || ReleasedMaterials > 0)
+	{
+		UE_LOG(LogFragments, Log, TEXT("TrimResourceCaches: Released %d meshes and %d materials, %lld MB cached (budget %d MB)"),
+			ReleasedMeshes, ReleasedMaterials, CachedResourceBytes / (1024 * 1024), ResourceCacheBudgetMB);
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////
 // EAGER GEOMETRY EXTRACTION
 // Extracts all geometry data from FlatBuffers at load time to eliminate
@@ -2593,38 +2967,89 @@ UMaterialInstanceDynamic* UFragmentsImporter::GetPooledMaterial(uint8 R, uint8 G
 // FlatBuffer pointers become invalid in the async/TileManager path.
 //////////////////////////////////////////////////////////////////////////
 
-UStaticMesh* UFragmentsImporter::CreateStaticMeshFromPreExtractedShell(
+UStaticMesh* UFragmentsImporter::CreateStaticMeshFromPreExtractedGeometry(
 	const FPreExtractedGeometry& Geometry,
 	const FString& AssetName,
-	UObject* OuterRef)
+	UObject* OuterRef,
+	FFragmentMeshBuildDataPtr BuildData,
+	EFragmentMeshBuildProfile Profile)
 {
-	if (!Geometry.bIsValid || !Geometry.bIsShell)
+	if (!Geometry.bIsValid)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("CreateStaticMeshFromPreExtractedShell: Invalid geometry for %s"), *AssetName);
+		UE_LOG(LogFragments, Warning, TEXT("CreateStaticMeshFromPreExtractedGeometry: Invalid geometry for %s (geometry %016llx)"), *AssetName, Geometry.GeometryHash);
 		return nullptr;
 	}
 
-	if (Geometry.Vertices.Num() == 0)
+	// Cached representations have no source geometry; their buffers come with BuildData
+	if (!Geometry.bFromDerivedCache && (Geometry.bIsShell ? Geometry.Vertices.Num() == 0 : Geometry.ExtrusionParts.Num() == 0))
 	{
-		UE_LOG(LogFragments, Warning, TEXT("CreateStaticMeshFromPreExtractedShell: No vertices for %s"), *AssetName);
+		UE_LOG(LogFragments, Warning, TEXT("CreateStaticMeshFromPreExtractedGeometry: No vertices for %s (geometry %016llx)"), *AssetName, Geometry.GeometryHash);
 		return nullptr;
 	}
 
-	// Create StaticMesh object
-	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(OuterRef, FName(*AssetName), RF_Public | RF_Standalone);
+	// Worker stage (tessellation, normals, output buffers): normally done in the
+	// background by the mesh build queue, run inline when no prepared data is supplied
+	if (!BuildData.IsValid())
+	{
+		BuildData = MakeShared<FFragmentMeshBuildData, ESPMode::ThreadSafe>();
+		if (!Geometry.bFromDerivedCache)
+		{
+			FFragmentMeshBuilder::BuildGeometryData(Geometry, MakeMeshBuildOptions(Profile), *BuildData);
+		}
+	}
+
+	if (!BuildData->IsValid())
+	{
+		UE_LOG(LogFragments, Warning, TEXT("CreateStaticMeshFromPreExtractedGeometry: No valid polygons for %s (geometry %016llx)"), *AssetName, Geometry.GeometryHash);
+		return nullptr;
+	}
+
+	// Data prepared for the other profile (or not at all) is completed here
+	if (Profile == EFragmentMeshBuildProfile::Full ? BuildData->Lods[0].MeshDescription.IsEmpty() : !BuildData->RenderData.IsValid())
+	{
+		FFragmentMeshBuilder::BuildForProfile(*BuildData, Profile);
+	}
+
+	// Game thread stage: create the asset and hand the prepared data to the renderer.
+	// Runtime-only meshes are unnamed transient objects, kept alive by the mesh cache
+	const bool bTransient = OuterRef == GetTransientPackage();
+	UStaticMesh* StaticMesh = NewObject<UStaticMesh>(OuterRef, AssetName.IsEmpty() ? NAME_None : FName(*AssetName),
+		bTransient ? RF_Transient : RF_Public | RF_Standalone);
+
+	// Add material using pre-extracted color data; the worker left the slot name empty
+	FName MaterialSlotName = AddMaterialToMeshFromRawData(
+		StaticMesh,
+		Geometry.R, Geometry.G, Geometry.B, Geometry.A,
+		Geometry.bIsGlass);
+
+	if (Profile == EFragmentMeshBuildProfile::Runtime)
+	{
+		// Buffers (every LOD, screen sizes included) were written on the worker with
+		// final normals: no build step, lightmap UVs or reversed index buffer. Collision is
+		// cooked from LOD0 only when traces must hit the fragment (bRuntimeMeshCollision)
+		StaticMesh->SetRenderData(MoveTemp(BuildData->RenderData));
+		StaticMesh->CalculateExtendedBounds();
+		BuildRuntimeCollision(StaticMesh);
+		StaticMesh->InitResources();
+		return StaticMesh;
+	}
+
 	StaticMesh->InitResources();
 	StaticMesh->SetLightingGuid();
 
-	UStaticMeshDescription* StaticMeshDescription = StaticMesh->CreateStaticMeshDescription(OuterRef);
-	FMeshDescription& MeshDescription = StaticMeshDescription->GetMeshDescription();
 	UStaticMesh::FBuildMeshDescriptionsParams MeshParams;
 
 	// Build Settings
 #if WITH_EDITOR
+	// Screen sizes come from the tessellation error of each LOD, not the engine heuristic
+	StaticMesh->bAutoComputeLODScreenSize = false;
+	for (const FFragmentMeshLodData& Lod : BuildData->Lods)
 	{
 		FStaticMeshSourceModel& SrcModel = StaticMesh->AddSourceModel();
-		SrcModel.BuildSettings.bRecomputeNormals = true;
-		SrcModel.BuildSettings.bRecomputeTangents = true;
+		SrcModel.ScreenSize.Default = Lod.ScreenSize;
+		// Full builds carry the worker's final normals and tangents in their mesh descriptions
+		SrcModel.BuildSettings.bRecomputeNormals = false;
+		SrcModel.BuildSettings.bRecomputeTangents = false;
 		SrcModel.BuildSettings.bRemoveDegenerates = true;
 		SrcModel.BuildSettings.bUseHighPrecisionTangentBasis = false;
 		SrcModel.BuildSettings.bBuildReversedIndexBuffer = true;
@@ -2645,1163 +3070,2729 @@ UStaticMesh* UFragmentsImporter::CreateStaticMeshFromPreExtractedShell(
 	MeshParams.bFastBuild = true;
 #endif
 
-	// Create vertices from pre-extracted data
-	TArray<FVertexID> Vertices;
-	Vertices.Reserve(Geometry.Vertices.Num());
-
-	for (int32 i = 0; i < Geometry.Vertices.Num(); i++)
+	TArray<const FMeshDescription*> MeshDescriptionPtrs;
+	for (FFragmentMeshLodData& Lod : BuildData->Lods)
 	{
-		const FVertexID VertId = StaticMeshDescription->CreateVertex();
-		StaticMeshDescription->SetVertexPosition(VertId, Geometry.Vertices[i]);
-		Vertices.Add(VertId);
+		FStaticMeshAttributes(Lod.MeshDescription).GetPolygonGroupMaterialSlotNames()[FPolygonGroupID(0)] = MaterialSlotName;
+		MeshDescriptionPtrs.Add(&Lod.MeshDescription);
 	}
 
-	// Add material using pre-extracted color data
-	FName MaterialSlotName = AddMaterialToMeshFromRawData(
-		StaticMesh,
-		Geometry.R, Geometry.G, Geometry.B, Geometry.A,
-		Geometry.bIsGlass);
-	const FPolygonGroupID PolygonGroupId = StaticMeshDescription->CreatePolygonGroup();
-	StaticMeshDescription->SetPolygonGroupMaterialSlotName(PolygonGroupId, MaterialSlotName);
+	StaticMesh->BuildFromMeshDescriptions(MeshDescriptionPtrs, MeshParams);
 
-	// Build hole map
-	TMap<int32, TArray<TArray<int32>>> ProfileHolesMap;
-	for (int32 ProfileIdx = 0; ProfileIdx < Geometry.ProfileHoles.Num(); ProfileIdx++)
+	// Outside the editor there are no source models to carry the screen sizes
+	if (FStaticMeshRenderData* RenderData = StaticMesh->GetRenderData())
 	{
-		if (Geometry.ProfileHoles[ProfileIdx].Num() > 0)
+		for (int32 LodIndex = 0; LodIndex < BuildData->Lods.Num() && LodIndex < MAX_STATIC_MESH_LODS; LodIndex++)
 		{
-			ProfileHolesMap.Add(ProfileIdx, Geometry.ProfileHoles[ProfileIdx]);
+			RenderData->ScreenSize[LodIndex].Default = BuildData->Lods[LodIndex].ScreenSize;
 		}
 	}
 
-	// Process profiles
-	bool bHasValidPolygons = false;
-	for (int32 ProfileIdx = 0; ProfileIdx < Geometry.ProfileIndices.Num(); ProfileIdx++)
-	{
-		const TArray<int32>& ProfileVertexIndices = Geometry.ProfileIndices[ProfileIdx];
+	return StaticMesh;
+}
 
-		if (ProfileVertexIndices.Num() < 3)
-		{
-			continue;
-		}
+FFragmentMeshBuildOptions UFragmentsImporter::MakeMeshBuildOptions(EFragmentMeshBuildProfile Profile) const
+{
+	FFragmentMeshBuildOptions Options;
+	Options.Backend = TriangulationBackend;
+	Options.Profile = Profile;
+	Options.CircleExtrusionLodCount = FMath::Clamp(CircleExtrusionLodCount, 1, MAX_STATIC_MESH_LODS);
+	Options.CircleTolerance = FMath::Max(CircleExtrusionTolerance, 0.01f);
+	Options.LodPixelError = FMath::Max(LodPixelError, 0.1f);
+	Options.bGenerateShellLods = bGenerateShellLods;
+	Options.ShellLodMinTriangles = FMath::Max(ShellLodMinTriangles, 12);
+	Options.ShellLodCount = FMath::Clamp(ShellLodCount, 0, MAX_STATIC_MESH_LODS - 2);
+	Options.ShellLodPixels = FMath::Max(ShellLodPixels, 1.0f);
+	Options.ShellProxyPixels = FMath::Max(ShellProxyPixels, 0.0f);
+	return Options;
+}
 
-		bool bHasHoles = ProfileHolesMap.Contains(ProfileIdx);
+void UFragmentsImporter::BuildRuntimeCollision(UStaticMesh* Mesh) const
+{
+	if (!bRuntimeMeshCollision || !Mesh || !Mesh->GetRenderData())
+	{
+		return;
+	}
 
-		if (!bHasHoles)
-		{
-			// Simple polygon - direct creation
-			TArray<FVertexInstanceID> TriangleInstance;
-			TriangleInstance.Reserve(ProfileVertexIndices.Num());
+	// The trimesh is cooked from the CPU copy of the LOD0 buffers; hit face indices are its triangle indices
+	Mesh->bAllowCPUAccess = true;
+	Mesh->CreateBodySetup();
+	if (UBodySetup* BodySetup = Mesh->GetBodySetup())
+	{
+		BodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
+		BodySetup->CreatePhysicsMeshes();
+	}
+}
 
-			for (int32 Idx : ProfileVertexIndices)
-			{
-				if (Vertices.IsValidIndex(Idx))
-				{
-					TriangleInstance.Add(MeshDescription.CreateVertexInstance(Vertices[Idx]));
-				}
-			}
+FString UFragmentsImporter::GetDerivedMeshCacheFile(const FString& ModelGuid, int32 RepresentationIndex) const
+{
+	const UFragmentModelWrapper* Wrapper = bUseDerivedMeshCache ? GetFragmentModel(ModelGuid) : nullptr;
+	if (!Wrapper || RepresentationIndex < 0)
+	{
+		return FString();
+	}
 
-			if (TriangleInstance.Num() >= 3)
-			{
-				MeshDescription.CreatePolygon(PolygonGroupId, TriangleInstance, {});
-				bHasValidPolygons = true;
-			}
-		}
-		else
-		{
-			// Polygon with holes - tessellate
-			TArray<FVector> OutVertices;
-			TArray<int32> OutIndices;
+	const uint32 OptionsHash = FFragmentDerivedMeshCache::HashOptions(MakeMeshBuildOptions(EFragmentMeshBuildProfile::Runtime));
+	return FFragmentDerivedMeshCache::GetEntryFile(Wrapper->GetContentHash(), RepresentationIndex, OptionsHash);
+}
 
-			if (TriangulatePolygonWithHoles(
-				Geometry.Vertices,
-				ProfileVertexIndices,
-				ProfileHolesMap[ProfileIdx],
-				OutVertices,
-				OutIndices))
-			{
-				// Create new vertices for tessellated geometry
-				TMap<int32, FVertexID> TempVertexMap;
-				for (int32 j = 0; j < OutVertices.Num(); j++)
-				{
-					FVertexID VId = StaticMeshDescription->CreateVertex();
-					StaticMeshDescription->SetVertexPosition(VId, OutVertices[j]);
-					TempVertexMap.Add(j, VId);
-				}
+bool UFragmentsImporter::IsDerivedMeshCacheCurrent(const FString& ModelGuid) const
+{
+	const UFragmentModelWrapper* Wrapper = GetFragmentModel(ModelGuid);
+	if (!Wrapper || Wrapper->GetDerivedCacheOptionsHash() == 0)
+	{
+		return true;
+	}
 
-				// Create triangles
-				for (int32 j = 0; j < OutIndices.Num(); j += 3)
-				{
-					if (j + 2 < OutIndices.Num())
-					{
-						TArray<FVertexInstanceID> Triangle;
-						Triangle.Add(MeshDescription.CreateVertexInstance(TempVertexMap[OutIndices[j]]));
-						Triangle.Add(MeshDescription.CreateVertexInstance(TempVertexMap[OutIndices[j + 1]]));
-						Triangle.Add(MeshDescription.CreateVertexInstance(TempVertexMap[OutIndices[j + 2]]));
+	return bUseDerivedMeshCache
+		&& Wrapper->GetDerivedCacheOptionsHash() == FFragmentDerivedMeshCache::HashOptions(MakeMeshBuildOptions(EFragmentMeshBuildProfile::Runtime));
+}
 
-						MeshDescription.CreatePolygon(PolygonGroupId, Triangle);
-						bHasValidPolygons = true;
-					}
-				}
-			}
-			else
-			{
-				UE_LOG(LogFragments, Warning, TEXT("Tessellation failed for profile %d in mesh %s"), ProfileIdx, *AssetName);
-			}
-		}
+bool UFragmentsImporter::RestoreSampleGeometry(const FString& ModelGuid, int32 LocalId, int32 SampleIndex, FPreExtractedGeometry& OutGeometry)
+{
+	UFragmentModelWrapper* Wrapper = GetFragmentModel(ModelGuid);
+	const Model* ParsedModel = Wrapper ? Wrapper->GetParsedModel() : nullptr;
+	const FFragmentItem* Item = ParsedModel ? Wrapper->GetItemAt(Wrapper->GetItemIndex(LocalId)) : nullptr;
+	if (!Item || !Item->Samples.IsValidIndex(SampleIndex) || !ParsedModel->meshes())
+	{
+		UE_LOG(LogFragments, Warning, TEXT("RestoreSampleGeometry: Sample %d of fragment %d is not in loaded model %s"), SampleIndex, LocalId, *ModelGuid);
+		return false;
 	}
 
-	if (!bHasValidPolygons)
+	// Rigid duplicate matching is off whenever samples were skipped, so the representation is the sample's own
+	FFragmentSample Sample = Item->Samples[SampleIndex];
+	const uint64 GeometryHash = Sample.ExtractedGeometry.GeometryHash;
+	if (!ExtractSampleGeometry(Sample, ParsedModel->meshes(), LocalId))
 	{
-		UE_LOG(LogFragments, Warning, TEXT("CreateStaticMeshFromPreExtractedShell: No valid polygons for %s"), *AssetName);
-		return nullptr;
+		return false;
 	}
 
-	FStaticMeshOperations::ComputeTriangleTangentsAndNormals(MeshDescription);
-	FStaticMeshOperations::ComputeTangentsAndNormals(MeshDescription, EComputeNTBsFlags::Normals | EComputeNTBsFlags::Tangents);
-
-	StaticMesh->BuildFromMeshDescriptions(TArray<const FMeshDescription*>{&MeshDescription}, MeshParams);
-
-	return StaticMesh;
+	Sample.ExtractedGeometry.GeometryHash = GeometryHash;
+	OutGeometry = MoveTemp(Sample.ExtractedGeometry);
+	UE_LOG(LogFragments, Verbose, TEXT("RestoreSampleGeometry: Extracted sample %d of fragment %d again (geometry %016llx)"), SampleIndex, LocalId, GeometryHash);
+	return true;
 }
 
-void UFragmentsImporter::PreExtractAllGeometry(FFragmentItem& RootItem, const Meshes* MeshesRef)
+float UFragmentsImporter::GetFragmentCullDistance(const FString& ModelGuid, int32 LocalId) const
 {
-	if (!MeshesRef)
+	if (!bAutoCullDistances)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("PreExtractAllGeometry: MeshesRef is null, skipping extraction"));
-		return;
+		return 0.0f;
 	}
 
-	// Statistics for logging
-	int32 TotalSamples = 0;
-	int32 SuccessfulExtractions = 0;
-	int32 FailedExtractions = 0;
+	const float MaxDimension = GetFragmentMaxDimension(ModelGuid, LocalId);
+	if (MaxDimension <= 0.0f)
+	{
+		return 0.0f;
+	}
 
-	// Use a stack-based approach to avoid deep recursion
-	TArray<FFragmentItem*> ItemStack;
-	ItemStack.Add(&RootItem);
+	// The model's streaming thresholds, or the defaults before its tile manager exists
+	const UFragmentTileManager* TileManager = TileManagers.FindRef(ModelGuid);
+	const UPerSampleVisibilityController* Visibility = TileManager ? TileManager->GetSampleVisibility() : nullptr;
+	if (!Visibility)
+	{
+		Visibility = GetDefault<UPerSampleVisibilityController>();
+	}
+	return Visibility->GetCullDistance(MaxDimension);
+}
 
-	while (ItemStack.Num() > 0)
+float UFragmentsImporter::GetFragmentMaxDimension(const FString& ModelGuid, int32 LocalId) const
+{
+	const UFragmentModelWrapper* Wrapper = GetFragmentModel(ModelGuid);
+	const UFragmentRegistry* Registry = Wrapper ? Wrapper->GetFragmentRegistry() : nullptr;
+	const FFragmentVisibilityData* VisData = Registry && Registry->IsBuilt() ? Registry->FindFragment(LocalId) : nullptr;
+	return VisData ? VisData->MaxDimension : 0.0f;
+}
+
+void UFragmentsImporter::WidenGroupCullDistance(FInstancedMeshGroup& Group, float MaxDimension)
+{
+	if (Group.bNeverCull || (MaxDimension > 0.0f && MaxDimension <= Group.MaxInstanceDimension))
 	{
-		FFragmentItem* CurrentItem = ItemStack.Pop();
-		if (!CurrentItem)
-		{
-			continue;
-		}
+		return;
+	}
 
-		// Process all samples in this item
-		for (FFragmentSample& Sample : CurrentItem->Samples)
-		{
-			TotalSamples++;
+	if (MaxDimension <= 0.0f)
+	{
+		Group.bNeverCull = true;
+	}
+	else
+	{
+		Group.MaxInstanceDimension = MaxDimension;
+	}
+	ApplyGroupCullDistance(Group);
+}
 
-			if (ExtractSampleGeometry(Sample, MeshesRef, CurrentItem->LocalId))
-			{
-				SuccessfulExtractions++;
-			}
-			else
+void UFragmentsImporter::ApplyGroupCullDistance(FInstancedMeshGroup& Group) const
+{
+	// Before the first refresh no tile manager has a view yet: use the default thresholds
+	float Scale = GroupCullDistanceScale;
+	if (Scale < 0.0f)
+	{
+		Scale = bAutoCullDistances ? GetDefault<UPerSampleVisibilityController>()->GetCullDistanceScale() : 0.0f;
+	}
+
+	const float CullDistance = Group.bNeverCull ? 0.0f
+		: UPerSampleVisibilityController::GetCullDistanceAtScale(Group.MaxInstanceDimension, Scale);
+	if (CullDistance == Group.CullDistance)
+	{
+		return;
+	}
+
+	Group.CullDistance = CullDistance;
+	if (Group.ISMC)
+	{
+		const int32 EndCullDistance = FMath::CeilToInt(Group.CullDistance);
+		Group.ISMC->SetCullDistances(EndCullDistance, EndCullDistance);
+	}
+}
+
+void UFragmentsImporter::RefreshGroupCullDistances()
+{
+	float Scale = 0.0f;
+	if (bAutoCullDistances)
+	{
+		for (const auto& Pair : TileManagers)
+		{
+			const UPerSampleVisibilityController* Visibility = Pair.Value ? Pair.Value->GetSampleVisibility() : nullptr;
+			if (!Visibility)
 			{
-				FailedExtractions++;
+				continue;
 			}
-		}
 
-		// Add children to the stack for processing
-		for (FFragmentItem* Child : CurrentItem->FragmentChildren)
-		{
-			if (Child)
+			// One model that culls nothing by size keeps every shared group unculled
+			const float ModelScale = Visibility->GetCullDistanceScale();
+			if (ModelScale <= 0.0f)
 			{
-				ItemStack.Add(Child);
+				Scale = 0.0f;
+				break;
 			}
+			Scale = FMath::Max(Scale, ModelScale);
 		}
 	}
 
-	// Calculate approximate memory usage for extracted geometry
-	int64 TotalVertexBytes = 0;
-	int64 TotalProfileBytes = 0;
-	int64 TotalHoleBytes = 0;
+	// Small view changes (a resize by a few pixels) are not worth touching every HISMC
+	if (GroupCullDistanceScale >= 0.0f && FMath::IsNearlyEqual(Scale, GroupCullDistanceScale, GroupCullDistanceScale * 0.02f))
+	{
+		return;
+	}
 
-	// Re-traverse to calculate memory
-	ItemStack.Add(&RootItem);
-	while (ItemStack.Num() > 0)
+	GroupCullDistanceScale = Scale;
+	for (auto& Pair : InstancedMeshGroups)
 	{
-		FFragmentItem* CurrentItem = ItemStack.Pop();
-		if (!CurrentItem) continue;
+		ApplyGroupCullDistance(Pair.Value);
+	}
+}
 
-		for (const FFragmentSample& Sample : CurrentItem->Samples)
-		{
-			const FPreExtractedGeometry& Geom = Sample.ExtractedGeometry;
-			if (Geom.bIsValid && Geom.bIsShell)
-			{
-				// Vertices: TArray overhead (24 bytes) + sizeof(FVector) * count
-				TotalVertexBytes += 24 + (sizeof(FVector) * Geom.Vertices.Num());
+uint64 UFragmentsImporter::MakeRepresentationMeshKey(uint64 GeometryHash, EFragmentMeshBuildProfile Profile)
+{
+	return Profile == EFragmentMeshBuildProfile::Full ? HashValue(static_cast<uint32>(Profile), GeometryHash) : GeometryHash;
+}
 
-				// Profile indices: TArray overhead + nested array overhead + actual indices
-				TotalProfileBytes += 24;  // Outer array
-				for (const TArray<int32>& Profile : Geom.ProfileIndices)
-				{
-					TotalProfileBytes += 24 + (sizeof(int32) * Profile.Num());
-				}
+uint64 UFragmentsImporter::MakeSampleMeshKey(const FFragmentItem& Item, int32 SampleIndex, uint64 ModelKey, EFragmentMeshBuildProfile Profile)
+{
+	const uint64 GeometryHash = Item.Samples[SampleIndex].ExtractedGeometry.GeometryHash;
 
-				// Holes: triple-nested arrays
-				TotalHoleBytes += 24;  // Outer array
-				for (const TArray<TArray<int32>>& HolesForProfile : Geom.ProfileHoles)
-				{
-					TotalHoleBytes += 24;
-					for (const TArray<int32>& Hole : HolesForProfile)
-					{
-						TotalHoleBytes += 24 + (sizeof(int32) * Hole.Num());
-					}
-				}
-			}
-		}
+	// Hash 0 means the geometry could not be hashed: its mesh belongs to this sample alone
+	const uint64 ContentKey = GeometryHash != 0 ? GeometryHash
+		: HashValue(static_cast<uint32>(SampleIndex), HashValue(static_cast<uint32>(Item.LocalId), ModelKey));
+	return MakeRepresentationMeshKey(ContentKey, Profile);
+}
 
-		for (FFragmentItem* Child : CurrentItem->FragmentChildren)
+UStaticMesh* UFragmentsImporter::GetOrBuildRepresentationMesh(const FFragmentItem& Item, int32 SampleIndex, uint64 ModelKey,
+	EFragmentMeshBuildProfile Profile)
+{
+	const FPreExtractedGeometry& Geometry = Item.Samples[SampleIndex].ExtractedGeometry;
+	const uint64 MeshKey = MakeSampleMeshKey(Item, SampleIndex, ModelKey, Profile);
+
+	if (FCachedRepresentationMesh* Cached = RepresentationMeshCache.Find(MeshKey))
+	{
+		CrossModelMeshHits += Cached->SourceModelKey != ModelKey ? 1 : 0;
+		return Cached->Mesh;
+	}
+
+	// Failed before: building again gives the same result, unless the build settings changed since
+	if (FailedMeshKeys.Contains(MeshKey))
+	{
+		if (FFragmentDerivedMeshCache::HashOptions(MakeMeshBuildOptions(Profile)) == FailedMeshOptionsHash)
 		{
-			if (Child) ItemStack.Add(Child);
+			return nullptr;
 		}
+		FailedMeshKeys.Empty();
 	}
 
-	int64 TotalBytes = TotalVertexBytes + TotalProfileBytes + TotalHoleBytes;
-	float TotalMB = TotalBytes / (1024.0f * 1024.0f);
-
-	UE_LOG(LogFragments, Log, TEXT("=== GEOMETRY PRE-EXTRACTION COMPLETE ==="));
-	UE_LOG(LogFragments, Log, TEXT("Total samples: %d"), TotalSamples);
-	UE_LOG(LogFragments, Log, TEXT("Successful extractions: %d"), SuccessfulExtractions);
-	UE_LOG(LogFragments, Log, TEXT("Failed extractions: %d"), FailedExtractions);
-	UE_LOG(LogFragments, Log, TEXT("=== GEOMETRY MEMORY USAGE ==="));
-	UE_LOG(LogFragments, Log, TEXT("Vertex data: %.2f MB"), TotalVertexBytes / (1024.0f * 1024.0f));
-	UE_LOG(LogFragments, Log, TEXT("Profile data: %.2f MB"), TotalProfileBytes / (1024.0f * 1024.0f));
-	UE_LOG(LogFragments, Log, TEXT("Hole data: %.2f MB"), TotalHoleBytes / (1024.0f * 1024.0f));
-	UE_LOG(LogFragments, Log, TEXT("Total pre-extracted geometry: %.2f MB"), TotalMB);
-
-	if (FailedExtractions > 0)
+	FMeshBuildRequest* Request = MeshBuildRequests.Find(MeshKey);
+	if (Request)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("Some geometry extractions failed. These fragments will be skipped during spawn."));
+		CrossModelMeshHits += Request->SourceModelKey != ModelKey ? 1 : 0;
 	}
-
-	// ==========================================
-	// GPU INSTANCING: Count instances per RepresentationId + Material combination
-	// This runs AFTER geometry extraction so we have access to pre-extracted material data
-	// ==========================================
-	RepresentationMaterialInstanceCount.Empty();
+	else
 	{
-		TArray<FFragmentItem*> CountStack;
-		CountStack.Add(&RootItem);
-
-		while (CountStack.Num() > 0)
+		// Cache miss: asset names and file paths are only worked out here, once per mesh,
+		// and only for meshes that may be saved; runtime meshes live in the transient package
+		FString MeshName;
+		FString PackagePath;
+		if (Profile == EFragmentMeshBuildProfile::Full)
 		{
-			FFragmentItem* CurrentItem = CountStack.Pop();
-			if (!CurrentItem) continue;
+			MeshName = FString::Printf(TEXT("%d_%d"), Item.LocalId, SampleIndex);
+			PackagePath = TEXT("/Game/Buildings") / Item.ModelGuid / MeshName;
 
-			for (const FFragmentSample& Sample : CurrentItem->Samples)
+			// Saved by an earlier session
+			const FString PackageFileName = FPackageName::LongPackageNameToFilename(
+				FPackageName::ObjectPathToPackageName(PackagePath), FPackageName::GetAssetPackageExtension());
+			if (FPaths::FileExists(PackageFileName))
 			{
-				// Only count samples with valid pre-extracted geometry
-				if (Sample.RepresentationIndex >= 0 && Sample.ExtractedGeometry.bIsValid)
+				UPackage* ExistingPackage = LoadPackage(nullptr, *PackagePath, LOAD_None);
+				if (UStaticMesh* SavedMesh = ExistingPackage ? FindObject<UStaticMesh>(ExistingPackage, *MeshName) : nullptr)
 				{
-					// Compute material hash from pre-extracted geometry data
-					const FPreExtractedGeometry& Geom = Sample.ExtractedGeometry;
-					uint32 MatHash = HashMaterialProperties(Geom.R, Geom.G, Geom.B, Geom.A, Geom.bIsGlass);
-					int64 ComboKey = ((int64)Sample.RepresentationIndex) | ((int64)MatHash << 32);
-
-					int32& Count = RepresentationMaterialInstanceCount.FindOrAdd(ComboKey);
-					Count++;
+					CacheRepresentationMesh(MeshKey, SavedMesh, ModelKey);
+					return SavedMesh;
 				}
 			}
-
-			// Add children to count stack
-			for (FFragmentItem* Child : CurrentItem->FragmentChildren)
-			{
-				if (Child) CountStack.Add(Child);
-			}
 		}
-	}
 
-	// Log instancing analysis
-	int32 InstanceableCount = 0;
-	int32 UniqueInstanceableGroups = 0;
-	for (const auto& Pair : RepresentationMaterialInstanceCount)
-	{
-		if (Pair.Value >= InstancingThreshold)
+		// The first requester decides geometry, options and asset name
+		Request = &MeshBuildRequests.Add(MeshKey);
+		Request->Geometry = Geometry;
+		Request->Options = MakeMeshBuildOptions(Profile);
+		Request->MeshName = MoveTemp(MeshName);
+		Request->PackagePath = MoveTemp(PackagePath);
+		Request->SourceModelKey = ModelKey;
+		Request->SourceModelGuid = Item.ModelGuid;
+		Request->SourceLocalId = Item.LocalId;
+		Request->SourceSampleIndex = SampleIndex;
+		Request->DerivedCacheFile = GetDerivedMeshCacheFile(Item.ModelGuid, Geometry.SourceRepresentationIndex);
+
+		// Skipped geometry is only served by the entry of the settings the model was loaded with
+		if (Geometry.bFromDerivedCache && !IsDerivedMeshCacheCurrent(Item.ModelGuid))
 		{
-			InstanceableCount += Pair.Value;
-			UniqueInstanceableGroups++;
+			RestoreSampleGeometry(Item.ModelGuid, Item.LocalId, SampleIndex, Request->Geometry);
 		}
 	}
 
-	UE_LOG(LogFragments, Log, TEXT("=== GPU INSTANCING ANALYSIS ==="));
-	UE_LOG(LogFragments, Log, TEXT("Instancing threshold: %d instances"), InstancingThreshold);
-	UE_LOG(LogFragments, Log, TEXT("Total unique RepId+Material combinations: %d"), RepresentationMaterialInstanceCount.Num());
-	UE_LOG(LogFragments, Log, TEXT("Groups meeting threshold: %d"), UniqueInstanceableGroups);
-	UE_LOG(LogFragments, Log, TEXT("Fragments eligible for instancing: %d"), InstanceableCount);
-	UE_LOG(LogFragments, Log, TEXT("Estimated draw call reduction: %d -> %d (%.1f%%)"),
-		SuccessfulExtractions,
-		SuccessfulExtractions - InstanceableCount + UniqueInstanceableGroups,
-		InstanceableCount > 0 ? ((float)(InstanceableCount - UniqueInstanceableGroups) / SuccessfulExtractions * 100.0f) : 0.0f);
+	return nullptr;
 }
 
-bool UFragmentsImporter::ExtractSampleGeometry(FFragmentSample& Sample, const Meshes* MeshesRef, int32 ItemLocalId)
+void UFragmentsImporter::AddMeshBuildWaiter(uint64 MeshKey, FMeshBuildWaiter&& Waiter)
 {
-	// Reset the extracted geometry to ensure clean state
-	Sample.ExtractedGeometry = FPreExtractedGeometry();
-
-	// Validate indices are valid
-	if (Sample.RepresentationIndex < 0 || Sample.MaterialIndex < 0 || Sample.LocalTransformIndex < 0)
+	FMeshBuildRequest* Request = MeshBuildRequests.Find(MeshKey);
+	if (!Request)
 	{
-		UE_LOG(LogFragments, Verbose, TEXT("ExtractSampleGeometry: Invalid indices for item %d, sample %d"),
-			ItemLocalId, Sample.SampleIndex);
-		return false;
+		return;
 	}
 
-	// Validate FlatBuffer arrays exist
-	if (!MeshesRef->representations() || !MeshesRef->materials() || !MeshesRef->local_transforms())
-	{
-		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Missing FlatBuffer arrays for item %d"), ItemLocalId);
-		return false;
-	}
+	// A build is as urgent as the most urgent fragment waiting on it
+	Request->Priority = FMath::Min(Request->Priority, Waiter.Priority);
 
-	// Bounds check representation index
-	const uint32 RepCount = MeshesRef->representations()->size();
-	if (static_cast<uint32>(Sample.RepresentationIndex) >= RepCount)
+	// Spawned again before the mesh is done: the sample waits once, with its latest actor and priority
+	if (WaitingFragmentMeshes.FindPair(Waiter.Fragment, MeshKey))
 	{
-		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: RepresentationIndex %d >= count %u for item %d"),
-			Sample.RepresentationIndex, RepCount, ItemLocalId);
-		return false;
+		FMeshBuildWaiter* Existing = Request->Waiters.FindByPredicate([&Waiter](const FMeshBuildWaiter& Other)
+		{
+			return Other.Fragment == Waiter.Fragment && Other.SampleIndex == Waiter.SampleIndex && Other.bInstanced == Waiter.bInstanced;
+		});
+		if (Existing)
+		{
+			*Existing = MoveTemp(Waiter);
+			return;
+		}
 	}
-
-	// Get representation
-	const Representation* representation = MeshesRef->representations()->Get(Sample.RepresentationIndex);
-	if (!representation)
+	else
 	{
-		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Representation is null for item %d"), ItemLocalId);
-		return false;
+		WaitingFragmentMeshes.Add(Waiter.Fragment, MeshKey);
 	}
 
-	// Get material
-	const uint32 MatCount = MeshesRef->materials()->size();
-	if (static_cast<uint32>(Sample.MaterialIndex) >= MatCount)
+	Request->Waiters.Add(MoveTemp(Waiter));
+}
+
+void UFragmentsImporter::RefreshMeshBuildPriority(uint64 MeshKey, FMeshBuildRequest& Request)
+{
+	// Actors evicted while waiting take no component anymore
+	Request.Waiters.RemoveAll([this, MeshKey](const FMeshBuildWaiter& Waiter)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: MaterialIndex %d >= count %u for item %d"),
-			Sample.MaterialIndex, MatCount, ItemLocalId);
-		return false;
-	}
-	const Material* material = MeshesRef->materials()->Get(Sample.MaterialIndex);
+		if (Waiter.bInstanced || Waiter.Actor.IsValid())
+		{
+			return false;
+		}
+		WaitingFragmentMeshes.RemoveSingle(Waiter.Fragment, MeshKey);
+		return true;
+	});
 
-	// Get local transform
-	const uint32 TransformCount = MeshesRef->local_transforms()->size();
-	if (static_cast<uint32>(Sample.LocalTransformIndex) >= TransformCount)
+	// Fragments streaming hid since they asked for the mesh no longer make it urgent
+	Request.Priority = TNumericLimits<float>::Max();
+	for (const FMeshBuildWaiter& Waiter : Request.Waiters)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: LocalTransformIndex %d >= count %u for item %d"),
-			Sample.LocalTransformIndex, TransformCount, ItemLocalId);
-		return false;
+		const bool bHidden = Waiter.bInstanced
+			? HiddenInstancedFragments.Contains(Waiter.Fragment)
+			: Waiter.Actor->IsHidden();
+		if (!bHidden)
+		{
+			Request.Priority = FMath::Min(Request.Priority, Waiter.Priority);
+		}
 	}
-	const Transform* local_transform = MeshesRef->local_transforms()->Get(Sample.LocalTransformIndex);
+}
 
-	// Extract material data
-	if (material)
+void UFragmentsImporter::UnindexMeshBuildWaiters(uint64 MeshKey, const FMeshBuildRequest& Request)
+{
+	for (const FMeshBuildWaiter& Waiter : Request.Waiters)
 	{
-		Sample.ExtractedGeometry.R = material->r();
-		Sample.ExtractedGeometry.G = material->g();
-		Sample.ExtractedGeometry.B = material->b();
-		Sample.ExtractedGeometry.A = material->a();
-		Sample.ExtractedGeometry.bIsGlass = material->a() < 255;
+		WaitingFragmentMeshes.RemoveSingle(Waiter.Fragment, MeshKey);
 	}
+}
 
-	// Extract local transform
-	if (local_transform)
+void UFragmentsImporter::ProcessMeshBuildQueue(float BudgetMs)
+{
+	if (MeshBuildRequests.Num() == 0)
 	{
-		Sample.ExtractedGeometry.LocalTransform = UFragmentsUtils::MakeTransform(local_transform);
+		return;
 	}
 
-	// Store representation ID for debugging
-	Sample.ExtractedGeometry.RepresentationId = representation->id();
+	const double Deadline = FPlatformTime::Seconds() + BudgetMs / 1000.0;
 
-	// Handle Shell geometry
-	if (representation->representation_class() == RepresentationClass::RepresentationClass_SHELL)
+	TArray<uint64> ReadyKeys;
+	TArray<uint64> QueuedKeys;
+	int32 RunningBuilds = 0;
+	for (const TPair<uint64, FMeshBuildRequest>& Pair : MeshBuildRequests)
 	{
-		Sample.ExtractedGeometry.bIsShell = true;
-
-		if (!MeshesRef->shells())
+		if (!Pair.Value.Future.IsValid())
 		{
-			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: shells() is null for item %d"), ItemLocalId);
-			return false;
+			QueuedKeys.Add(Pair.Key);
 		}
-
-		const uint32 ShellId = representation->id();
-		const uint32 ShellCount = MeshesRef->shells()->size();
-
-		if (ShellId >= ShellCount)
+		else if (Pair.Value.Future.IsReady())
 		{
-			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Shell id %u >= count %u for item %d"),
-				ShellId, ShellCount, ItemLocalId);
-			return false;
+			ReadyKeys.Add(Pair.Key);
 		}
-
-		const Shell* shell = MeshesRef->shells()->Get(ShellId);
-		if (!shell)
+		else
 		{
-			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Shell %u is null for item %d"), ShellId, ItemLocalId);
-			return false;
+			RunningBuilds++;
 		}
+	}
 
-		// Validate and extract points
-		if (!shell->points() || shell->points()->size() == 0)
+	// Only worth ordering when more builds are queued than worker slots are free; waiters come and
+	// go with the camera, so the queued priorities are recomputed a few times per second at most
+	const int32 MaxRunningBuilds = MaxConcurrentMeshBuilds > 0
+		? MaxConcurrentMeshBuilds
+		: FMath::Max(1, GThreadPool ? GThreadPool->GetNumThreads() : 1);
+	const double Now = FPlatformTime::Seconds();
+	if (QueuedKeys.Num() > MaxRunningBuilds - RunningBuilds && Now - LastMeshBuildPriorityRefresh >= 0.25)
+	{
+		for (uint64 MeshKey : QueuedKeys)
 		{
-			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Shell %u has no points for item %d"), ShellId, ItemLocalId);
-			return false;
+			RefreshMeshBuildPriority(MeshKey, MeshBuildRequests[MeshKey]);
 		}
+		LastMeshBuildPriorityRefresh = Now;
+	}
 
-		const auto* Points = shell->points();
-		const uint32 PointCount = Points->size();
+	auto ByPriority = [this](const uint64& A, const uint64& B)
+	{
+		return MeshBuildRequests[A].Priority < MeshBuildRequests[B].Priority;
+	};
 
-		// Sanity check - prevent extremely large allocations
-		constexpr uint32 MaxPointCount = 1000000;
-		if (PointCount > MaxPointCount)
+	// Commit finished builds, most urgent first, within the budget
+	ReadyKeys.Sort(ByPriority);
+	int32 Committed = 0;
+	int32 Attached = 0;
+	bool bQueuedInstances = false;
+
+	for (uint64 MeshKey : ReadyKeys)
+	{
+		if (Committed > 0 && FPlatformTime::Seconds() >= Deadline)
 		{
-			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Point count %u exceeds limit for item %d"), PointCount, ItemLocalId);
-			return false;
+			break;
 		}
 
-		Sample.ExtractedGeometry.Vertices.Reserve(PointCount);
-		for (flatbuffers::uoffset_t i = 0; i < PointCount; i++)
+		FMeshBuildRequest& PendingRequest = MeshBuildRequests[MeshKey];
+		Committed++;
+
+		UStaticMesh* Mesh = CommitMeshBuild(MeshKey, PendingRequest);
+		if (!Mesh && !PendingRequest.DerivedCacheFile.IsEmpty()
+			&& (!PendingRequest.Geometry.bFromDerivedCache || RestoreSampleGeometry(PendingRequest.SourceModelGuid,
+				PendingRequest.SourceLocalId, PendingRequest.SourceSampleIndex, PendingRequest.Geometry)))
 		{
-			const auto* P = Points->Get(i);
-			if (P)
+			// A missing, stale or damaged cache entry fails the same way every time: build from the geometry
+			// instead, extracted again if it was skipped for that entry
+			UE_LOG(LogFragments, Warning, TEXT("ProcessMeshBuildQueue: Build of geometry %016llx produced no mesh, retrying without the derived mesh cache (%d samples waiting)"),
+				MeshKey, PendingRequest.Waiters.Num());
+			PendingRequest.Future = TFuture<FFragmentMeshBuildDataPtr>();
+			PendingRequest.DerivedCacheFile.Empty();
+			continue;
+		}
+
+		FMeshBuildRequest Request = MoveTemp(PendingRequest);
+		MeshBuildRequests.Remove(MeshKey);
+		UnindexMeshBuildWaiters(MeshKey, Request);
+
+		if (!Mesh)
+		{
+			// Building again gives the same result: later requests are turned away, waiting samples stay undrawn
+			const uint32 OptionsHash = FFragmentDerivedMeshCache::HashOptions(Request.Options);
+			if (OptionsHash != FailedMeshOptionsHash)
 			{
-				// Convert to Unreal coordinates: Z-up, cm units
-				Sample.ExtractedGeometry.Vertices.Add(FVector(P->x() * 100.0f, P->z() * 100.0f, P->y() * 100.0f));
+				FailedMeshKeys.Empty();
+				FailedMeshOptionsHash = OptionsHash;
+			}
+			FailedMeshKeys.Add(MeshKey);
+			for (const FMeshBuildWaiter& Waiter : Request.Waiters)
+			{
+				UE_LOG(LogFragments, Warning, TEXT("ProcessMeshBuildQueue: Sample %d of fragment %d (model %016llx) has no mesh, geometry %016llx failed to build"),
+					Waiter.SampleIndex, Waiter.Fragment.LocalId, Waiter.Fragment.ModelKey, MeshKey);
 			}
+			continue;
 		}
 
-		// Validate and extract profiles
-		const auto* Profiles = shell->profiles();
-		if (!Profiles)
+		for (const FMeshBuildWaiter& Waiter : Request.Waiters)
 		{
-			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Shell %u has no profiles for item %d"), ShellId, ItemLocalId);
-			return false;
+			AttachWaitingSample(MeshKey, Waiter, Mesh);
+			bQueuedInstances |= Waiter.bInstanced;
+			Attached++;
 		}
+	}
 
-		const uint32 ProfileCount = Profiles->size();
-		constexpr uint32 MaxProfileCount = 100000;
-		if (ProfileCount > MaxProfileCount)
+	// Instances queued above need their groups finalized to become visible
+	if (bQueuedInstances)
+	{
+		FinalizeISMCsWithBudget(static_cast<float>(FMath::Max(0.0, (Deadline - FPlatformTime::Seconds()) * 1000.0)));
+	}
+
+	// Start queued builds, most urgent first, while worker slots are free
+	QueuedKeys.Sort(ByPriority);
+	int32 Started = 0;
+	for (uint64 MeshKey : QueuedKeys)
+	{
+		if (RunningBuilds >= MaxRunningBuilds)
 		{
-			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Profile count %u exceeds limit for item %d"), ProfileCount, ItemLocalId);
-			return false;
+			break;
 		}
 
-		// Build hole map first
-		TMap<int32, TArray<TArray<int32>>> ProfileHolesMap;
-		if (shell->holes())
+		FMeshBuildRequest& Request = MeshBuildRequests[MeshKey];
+		Request.Future = FFragmentMeshBuilder::BuildAsync(Request.Geometry, Request.Options, Request.DerivedCacheFile);
+		RunningBuilds++;
+		Started++;
+	}
+
+	if (Committed > 0 || Started > 0)
+	{
+		UE_LOG(LogFragments, Verbose, TEXT("Mesh build queue: %d committed (%d samples attached), %d started, %d running, %d queued"),
+			Committed, Attached, Started, RunningBuilds, MeshBuildRequests.Num() - RunningBuilds);
+	}
+}
+
+UStaticMesh* UFragmentsImporter::CommitMeshBuild(uint64 MeshKey, FMeshBuildRequest& Request)
+{
+	FFragmentMeshBuildDataPtr BuildData = Request.Future.Get();
+	const EFragmentMeshBuildProfile Profile = Request.Options.Profile;
+
+	// Only meshes that will be saved get a package of their own
+	UPackage* MeshPackage = Request.PackagePath.IsEmpty() ? GetTransientPackage() : CreatePackage(*Request.PackagePath);
+	UStaticMesh* Mesh = CreateStaticMeshFromPreExtractedGeometry(Request.Geometry, Request.MeshName, MeshPackage, BuildData, Profile);
+	if (!Mesh)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("CommitMeshBuild: No mesh for geometry %016llx (%d waiting samples)"),
+			MeshKey, Request.Waiters.Num());
+		return nullptr;
+	}
+
+	CacheRepresentationMesh(MeshKey, Mesh, Request.SourceModelKey);
+
+	// Full profile is only requested when meshes are saved
+	if (Profile == EFragmentMeshBuildProfile::Full && MeshPackage != GetTransientPackage())
+	{
+		const FString PackageFileName = FPackageName::LongPackageNameToFilename(
+			FPackageName::ObjectPathToPackageName(Request.PackagePath), FPackageName::GetAssetPackageExtension());
+		if (!FPaths::FileExists(PackageFileName))
 		{
-			const auto* Holes = shell->holes();
-			const uint32 HoleCount = Holes->size();
+#if WITH_EDITOR
+			MeshPackage->FullyLoad();
+			Mesh->Rename(*Request.MeshName, MeshPackage);
+			Mesh->SetFlags(RF_Public | RF_Standalone);
+			MeshPackage->MarkPackageDirty();
+			FAssetRegistryModule::AssetCreated(Mesh);
+			PackagesToSave.Add(MeshPackage);
+#endif
+		}
+	}
 
-			for (flatbuffers::uoffset_t j = 0; j < HoleCount && j < MaxProfileCount; j++)
+	UE_LOG(LogFragments, Log, TEXT("CommitMeshBuild: Created and cached mesh for geometry %016llx (%d waiting samples)"),
+		MeshKey, Request.Waiters.Num());
+
+	return Mesh;
+}
+
+void UFragmentsImporter::AttachWaitingSample(uint64 MeshKey, const FMeshBuildWaiter& Waiter, UStaticMesh* Mesh)
+{
+	if (Waiter.bInstanced)
+	{
+		UMaterialInstanceDynamic* Material = GetPooledMaterial(Waiter.R, Waiter.G, Waiter.B, Waiter.A, Waiter.bIsGlass);
+		if (Material)
+		{
+			const uint32 MatHash = GetGroupMaterialHash(Waiter.R, Waiter.G, Waiter.B, Waiter.A, Waiter.bIsGlass);
+			QueueInstanceForBatchAdd(MeshKey, MatHash, Waiter.WorldTransform, Waiter.InstanceItem, Mesh, Material,
+				FColor(Waiter.R, Waiter.G, Waiter.B, Waiter.A));
+		}
+		return;
+	}
+
+	// The actor may have been evicted while the mesh was building
+	AFragment* FragmentActor = Waiter.Actor.Get();
+	if (!FragmentActor || !FragmentActor->GetSamples().IsValidIndex(Waiter.SampleIndex))
+	{
+		return;
+	}
+
+	CreateSampleComponent(FragmentActor, FragmentActor->GetSamples()[Waiter.SampleIndex], Mesh);
+
+	// The streaming ledger charged the actor before this component existed
+	if (UFragmentTileManager* TileManager = TileManagers.FindRef(FragmentActor->GetModelGuid()))
+	{
+		TileManager->RefreshFragmentResources(FragmentActor->GetLocalId(), FragmentActor);
+	}
+}
+
+UStaticMeshComponent* UFragmentsImporter::CreateSampleComponent(AFragment* FragmentActor, const FFragmentSample& Sample, UStaticMesh* Mesh)
+{
+	const FPreExtractedGeometry& ExtractedGeom = Sample.ExtractedGeometry;
+
+	// Add StaticMeshComponent to parent actor
+	UStaticMeshComponent* MeshComp = NewObject<UStaticMeshComponent>(FragmentActor);
+	MeshComp->SetStaticMesh(Mesh);
+	AcquireRepresentationMesh(Mesh);
+	MeshComp->SetRelativeTransform(ExtractedGeom.LocalTransform);
+	MeshComp->AttachToComponent(FragmentActor->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+
+	// Disable Lumen/Distance Field features to avoid "Preparing mesh distance fields/cards" delays
+	// These are expensive to compute at runtime for procedurally generated meshes
+	MeshComp->bAffectDistanceFieldLighting = false;  // Skip distance field generation
+	MeshComp->bAffectDynamicIndirectLighting = false; // Skip Lumen indirect lighting
+	MeshComp->bAffectIndirectLightingWhileHidden = false;
+
+	// Culled by the renderer where streaming would find it below the minimum screen size
+	// (set before registration so the render proxy is created with it)
+	MeshComp->LDMaxDrawDistance = GetFragmentCullDistance(FragmentActor->GetModelGuid(), FragmentActor->GetLocalId());
+
+	MeshComp->RegisterComponent();
+	FragmentActor->AddInstanceComponent(MeshComp);
+
+	// IMPORTANT: Apply material AFTER registration - material overrides don't persist on unregistered components
+	// This applies the correct material for this sample, which may differ from the mesh's embedded material
+	// (e.g., when the mesh is cached by geometry hash but different samples have different materials)
+	ApplyColorMaterial(MeshComp, FColor(ExtractedGeom.R, ExtractedGeom.G, ExtractedGeom.B, ExtractedGeom.A));
+
+	// Fragments selected before the component existed (spawned by streaming, or a mesh that finished late)
+	if (SelectedFragments.Num() > 0 && SelectedFragments.Contains(MakeFragmentKey(FragmentActor->GetModelGuid(), FragmentActor->GetLocalId())))
+	{
+		MeshComp->SetCustomPrimitiveDataFloat(GetInstanceSelectionCustomDataIndex(), 1.0f);
+	}
+
+	// Configure occlusion culling based on fragment classification
+	// Use pre-extracted material alpha instead of FlatBuffer access
+	const EOcclusionRole Role = UFragmentOcclusionClassifier::ClassifyFragment(
+		FragmentActor->GetCategory(), ExtractedGeom.A);
+
+	switch (Role)
+	{
+	case EOcclusionRole::Occluder:
+		// Large structural elements that block visibility
+		MeshComp->bUseAsOccluder = true;
+		MeshComp->SetCastShadow(true);
+		break;
+
+	case EOcclusionRole::Occludee:
+		// Objects that can be hidden by occluders
+		MeshComp->bUseAsOccluder = false;
+		MeshComp->SetCastShadow(true);
+		break;
+
+	case EOcclusionRole::NonOccluder:
+		// Glass/transparent - doesn't block anything
+		MeshComp->bUseAsOccluder = false;
+		MeshComp->SetCastShadow(false);
+		break;
+	}
+
+	return MeshComp;
+}
+
+uint32 UFragmentsImporter::PreExtractAllGeometry(FFragmentItem& RootItem, const Meshes* MeshesRef, uint64 ModelHash)
+{
+	if (!MeshesRef)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("PreExtractAllGeometry: MeshesRef is null, skipping extraction"));
+		return 0;
+	}
+
+	// Instance counts below are keyed with the material mode, so it is fixed before the first count
+	ResolveColorMaterialMode();
+
+	// Representations built in an earlier session (one directory scan, no per-file checks).
+	// Rigid duplicate matching needs every shell's vertices, so nothing is skipped while it is on;
+	// the built meshes are still read from the cache by the mesh builds.
+	TSet<int32> CachedRepresentations;
+	uint32 CacheOptionsHash = 0;
+	if (bUseDerivedMeshCache && ModelHash != 0)
+	{
+		// Entries of other models go first when over budget; the loaded ones are still drawn from theirs
+		TSet<uint64> KeepModelHashes = { ModelHash };
+		for (const TPair<FString, UFragmentModelWrapper*>& Pair : FragmentModels)
+		{
+			if (Pair.Value)
 			{
-				const auto* Hole = Holes->Get(j);
-				if (!Hole) continue;
+				KeepModelHashes.Add(Pair.Value->GetContentHash());
+			}
+		}
+		FFragmentDerivedMeshCache::Trim(static_cast<int64>(DerivedMeshCacheBudgetMB) * 1024 * 1024, KeepModelHashes);
 
-				int32 ProfileId = Hole->profile_id();
+		if (!bInstanceRigidDuplicates)
+		{
+			CacheOptionsHash = FFragmentDerivedMeshCache::HashOptions(MakeMeshBuildOptions(EFragmentMeshBuildProfile::Runtime));
+			CachedRepresentations = FFragmentDerivedMeshCache::FindCachedRepresentations(ModelHash, CacheOptionsHash);
+		}
+	}
 
-				TArray<int32> HoleIndices;
-				if (Hole->indices())
+	// Statistics for logging
+	int32 TotalSamples = 0;
+	int32 SuccessfulExtractions = 0;
+	int32 FailedExtractions = 0;
+	int32 CachedSamples = 0;
+
+	// Content hash per representation, computed once however many samples use it
+	TMap<int32, uint64> RepresentationHashes;
+
+	// Use a stack-based approach to avoid deep recursion
+	TArray<FFragmentItem*> ItemStack;
+	ItemStack.Add(&RootItem);
+
+	while (ItemStack.Num() > 0)
+	{
+		FFragmentItem* CurrentItem = ItemStack.Pop();
+		if (!CurrentItem)
+		{
+			continue;
+		}
+
+		// Process all samples in this item
+		for (FFragmentSample& Sample : CurrentItem->Samples)
+		{
+			TotalSamples++;
+
+			if (ExtractSampleGeometry(Sample, MeshesRef, CurrentItem->LocalId, CachedRepresentations.Contains(Sample.RepresentationIndex)))
+			{
+				SuccessfulExtractions++;
+				CachedSamples += Sample.ExtractedGeometry.bFromDerivedCache ? 1 : 0;
+
+				uint64* GeometryHash = RepresentationHashes.Find(Sample.RepresentationIndex);
+				if (!GeometryHash)
 				{
-					const uint32 HoleIndexCount = Hole->indices()->size();
-					constexpr uint32 MaxIndicesPerProfile = 100000;
-					if (HoleIndexCount <= MaxIndicesPerProfile)
-					{
-						HoleIndices.Reserve(HoleIndexCount);
-						for (flatbuffers::uoffset_t k = 0; k < HoleIndexCount; k++)
-						{
-							HoleIndices.Add(Hole->indices()->Get(k));
-						}
-					}
+					const Representation* Rep = MeshesRef->representations()->Get(Sample.RepresentationIndex);
+					GeometryHash = &RepresentationHashes.Add(Sample.RepresentationIndex, HashRepresentationGeometry(MeshesRef, Rep));
 				}
+				Sample.ExtractedGeometry.GeometryHash = *GeometryHash;
+			}
+			else
+			{
+				FailedExtractions++;
+			}
+		}
 
-				ProfileHolesMap.FindOrAdd(ProfileId).Add(MoveTemp(HoleIndices));
+		// Add children to the stack for processing
+		for (FFragmentItem* Child : CurrentItem->FragmentChildren)
+		{
+			if (Child)
+			{
+				ItemStack.Add(Child);
 			}
 		}
+	}
 
-		// Extract profile indices
-		Sample.ExtractedGeometry.ProfileIndices.Reserve(ProfileCount);
-		Sample.ExtractedGeometry.ProfileHoles.SetNum(ProfileCount);
+	// Draw shells that are rotated or translated copies of another with that one's mesh
+	const int32 RigidDuplicateSamples = bInstanceRigidDuplicates ? MatchRigidDuplicates(RootItem) : 0;
 
-		bool bHasValidProfile = false;
-		for (flatbuffers::uoffset_t i = 0; i < ProfileCount; i++)
-		{
-			const auto* Profile = Profiles->Get(i);
-			TArray<int32> ProfileVertexIndices;
+	// Calculate approximate memory usage for extracted geometry
+	int64 TotalVertexBytes = 0;
+	int64 TotalProfileBytes = 0;
+	int64 TotalHoleBytes = 0;
 
-			if (Profile && Profile->indices())
+	// Re-traverse to calculate memory
+	ItemStack.Add(&RootItem);
+	while (ItemStack.Num() > 0)
+	{
+		FFragmentItem* CurrentItem = ItemStack.Pop();
+		if (!CurrentItem) continue;
+
+		for (const FFragmentSample& Sample : CurrentItem->Samples)
+		{
+			const FPreExtractedGeometry& Geom = Sample.ExtractedGeometry;
+			if (Geom.bIsValid && Geom.bIsShell)
 			{
-				const auto* Indices = Profile->indices();
-				const uint32 IndexCount = Indices->size();
+				// Vertices: TArray overhead (24 bytes) + sizeof(FVector) * count
+				TotalVertexBytes += 24 + (sizeof(FVector) * Geom.Vertices.Num());
 
-				// Skip profiles with fewer than 3 indices (not a valid polygon)
-				if (IndexCount >= 3)
+				// Profile indices: TArray overhead + nested array overhead + actual indices
+				TotalProfileBytes += 24;  // Outer array
+				for (const TArray<int32>& Profile : Geom.ProfileIndices)
 				{
-					constexpr uint32 MaxIndicesPerProfile = 100000;
-					if (IndexCount <= MaxIndicesPerProfile)
-					{
-						ProfileVertexIndices.Reserve(IndexCount);
-						for (flatbuffers::uoffset_t j = 0; j < IndexCount; j++)
-						{
-							ProfileVertexIndices.Add(Indices->Get(j));
-						}
-						bHasValidProfile = true;
-					}
-					else
+					TotalProfileBytes += 24 + (sizeof(int32) * Profile.Num());
+				}
+
+				// Holes: triple-nested arrays
+				TotalHoleBytes += 24;  // Outer array
+				for (const TArray<TArray<int32>>& HolesForProfile : Geom.ProfileHoles)
+				{
+					TotalHoleBytes += 24;
+					for (const TArray<int32>& Hole : HolesForProfile)
 					{
-						UE_LOG(LogFragments, Verbose, TEXT("ExtractSampleGeometry: Profile %d has %u indices (limit %u), skipping"),
-							i, IndexCount, MaxIndicesPerProfile);
+						TotalHoleBytes += 24 + (sizeof(int32) * Hole.Num());
 					}
 				}
 			}
+			else if (Geom.bIsValid)
+			{
+				// Circle extrusion parts: axis points count as vertex data
+				TotalProfileBytes += 24 + (sizeof(FPreExtractedExtrusionPart) * Geom.ExtrusionParts.Num());
+				for (const FPreExtractedExtrusionPart& Part : Geom.ExtrusionParts)
+				{
+					TotalVertexBytes += sizeof(FVector) * Part.Points.Num();
+				}
+			}
+		}
+
+		for (FFragmentItem* Child : CurrentItem->FragmentChildren)
+		{
+			if (Child) ItemStack.Add(Child);
+		}
+	}
+
+	int64 TotalBytes = TotalVertexBytes + TotalProfileBytes + TotalHoleBytes;
+	float TotalMB = TotalBytes / (1024.0f * 1024.0f);
+
+	UE_LOG(LogFragments, Log, TEXT("=== GEOMETRY PRE-EXTRACTION COMPLETE ==="));
+	UE_LOG(LogFragments, Log, TEXT("Total samples: %d"), TotalSamples);
+	UE_LOG(LogFragments, Log, TEXT("Successful extractions: %d"), SuccessfulExtractions);
+	UE_LOG(LogFragments, Log, TEXT("Failed extractions: %d"), FailedExtractions);
+	UE_LOG(LogFragments, Log, TEXT("Served by derived mesh cache: %d samples (%d representations)"), CachedSamples, CachedRepresentations.Num());
+	UE_LOG(LogFragments, Log, TEXT("Rigid duplicates drawn with another representation's mesh: %d samples"), RigidDuplicateSamples);
+	UE_LOG(LogFragments, Log, TEXT("=== GEOMETRY MEMORY USAGE ==="));
+	UE_LOG(LogFragments, Log, TEXT("Vertex data: %.2f MB"), TotalVertexBytes / (1024.0f * 1024.0f));
+	UE_LOG(LogFragments, Log, TEXT("Profile data: %.2f MB"), TotalProfileBytes / (1024.0f * 1024.0f));
+	UE_LOG(LogFragments, Log, TEXT("Hole data: %.2f MB"), TotalHoleBytes / (1024.0f * 1024.0f));
+	UE_LOG(LogFragments, Log, TEXT("Total pre-extracted geometry: %.2f MB"), TotalMB);
+
+	if (FailedExtractions > 0)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("Some geometry extractions failed. These fragments will be skipped during spawn."));
+	}
+
+	// ==========================================
+	// GPU INSTANCING: Count instances per geometry + material combination
+	// Counts accumulate over all loaded models, so shapes shared between models
+	// are costed together and end up in one instanced group
+	// ==========================================
+	TMap<uint64, FInstancingGroupStats> ModelInstanceCounts;
+	CountInstancesPerGroup(RootItem, ModelInstanceCounts);
+
+	int32 SharedGroups = 0;
+	for (const TPair<uint64, FInstancingGroupStats>& Pair : ModelInstanceCounts)
+	{
+		FInstancingGroupStats& Stats = InstancingGroupStats.FindOrAdd(Pair.Key);
+		SharedGroups += Stats.InstanceCount > 0 ? 1 : 0;
+		if (Stats.Category.IsEmpty())
+		{
+			Stats.Category = Pair.Value.Category;
+		}
+		Stats.InstanceCount += Pair.Value.InstanceCount;
+		Stats.TriangleCount = FMath::Max(Stats.TriangleCount, Pair.Value.TriangleCount);
+		EvaluateInstancingCost(Stats);
+	}
+	InstancingDecisionSerial++;
+
+	// Log instancing analysis
+	int32 InstanceableCount = 0;
+	int32 UniqueInstanceableGroups = 0;
+	for (const TPair<uint64, FInstancingGroupStats>& Pair : ModelInstanceCounts)
+	{
+		if (InstancingGroupStats[Pair.Key].bInstanced)
+		{
+			InstanceableCount += Pair.Value.InstanceCount;
+			UniqueInstanceableGroups++;
+		}
+	}
+
+	UE_LOG(LogFragments, Log, TEXT("=== GPU INSTANCING ANALYSIS ==="));
+	UE_LOG(LogFragments, Log, TEXT("Instancing cost model: group cost %.1f draw calls, %.0f triangles or %.0f bytes per draw call, %d category overrides"),
+		InstancingGroupCost, InstancingTrianglesPerDrawCall, InstancingBytesPerDrawCall, InstancingCategoryOverrides.Num());
+	UE_LOG(LogFragments, Log, TEXT("Unique geometry+material combinations: %d (%d shared with other loaded models)"),
+		ModelInstanceCounts.Num(), SharedGroups);
+	UE_LOG(LogFragments, Log, TEXT("Groups instanced by the cost model: %d"), UniqueInstanceableGroups);
+	UE_LOG(LogFragments, Log, TEXT("Fragments eligible for instancing: %d"), InstanceableCount);
+	UE_LOG(LogFragments, Log, TEXT("Estimated draw call reduction: %d -> %d (%.1f%%)"),
+		SuccessfulExtractions,
+		SuccessfulExtractions - InstanceableCount + UniqueInstanceableGroups,
+		InstanceableCount > 0 ? ((float)(InstanceableCount - UniqueInstanceableGroups) / SuccessfulExtractions * 100.0f) : 0.0f);
+
+	return CachedSamples > 0 ? CacheOptionsHash : 0;
+}
+
+void UFragmentsImporter::CountInstancesPerGroup(const FFragmentItem& RootItem, TMap<uint64, FInstancingGroupStats>& OutCounts) const
+{
+	TArray<const FFragmentItem*> Stack;
+	Stack.Add(&RootItem);
+
+	while (Stack.Num() > 0)
+	{
+		const FFragmentItem* CurrentItem = Stack.Pop();
+
+		for (const FFragmentSample& Sample : CurrentItem->Samples)
+		{
+			// Only count samples with valid pre-extracted geometry
+			const FPreExtractedGeometry& Geom = Sample.ExtractedGeometry;
+			if (Geom.bIsValid && Geom.GeometryHash != 0)
+			{
+				const uint32 MatHash = GetGroupMaterialHash(Geom.R, Geom.G, Geom.B, Geom.A, Geom.bIsGlass);
+				FInstancingGroupStats& Stats = OutCounts.FindOrAdd(MakeInstanceGroupKey(Geom.GeometryHash, MatHash));
+				if (Stats.InstanceCount++ == 0)
+				{
+					Stats.Category = CurrentItem->Category;
+				}
+				Stats.TriangleCount = FMath::Max(Stats.TriangleCount, Geom.TriangleCount);
+			}
+		}
+
+		for (const FFragmentItem* Child : CurrentItem->FragmentChildren)
+		{
+			if (Child)
+			{
+				Stack.Add(Child);
+			}
+		}
+	}
+}
+
+int32 UFragmentsImporter::MatchRigidDuplicates(FFragmentItem& RootItem) const
+{
+	const double Tolerance = FMath::Max(static_cast<double>(RigidDuplicateTolerance), KINDA_SMALL_NUMBER);
+
+	// Canonical form per representation (all samples of a representation share its vertices)
+	TMap<int32, FShellCanonicalForm> Forms;
+
+	// First sample of every distinct shape, by bucket key; later shapes are verified against them
+	TMultiMap<uint64, const FFragmentSample*> Representatives;
+
+	// Sample whose geometry each representation is drawn with (a sample of itself if unmatched)
+	TMap<int32, const FFragmentSample*> SourceSamples;
+
+	int32 MatchedSamples = 0;
+	TArray<FFragmentItem*> ItemStack;
+	ItemStack.Add(&RootItem);
+
+	while (ItemStack.Num() > 0)
+	{
+		FFragmentItem* CurrentItem = ItemStack.Pop();
+
+		for (FFragmentSample& Sample : CurrentItem->Samples)
+		{
+			FPreExtractedGeometry& Geom = Sample.ExtractedGeometry;
+			if (!Geom.bIsValid || !Geom.bIsShell || Geom.bFromDerivedCache)
+			{
+				continue;
+			}
+
+			const int32 RepIndex = Sample.RepresentationIndex;
+			const FFragmentSample* const* SourcePtr = SourceSamples.Find(RepIndex);
+			if (!SourcePtr)
+			{
+				const FFragmentSample* Source = &Sample;
+				FShellCanonicalForm& Form = Forms.Add(RepIndex);
+				if (FShellCanonicalForm::Compute(Geom, Tolerance, Form))
+				{
+					TArray<const FFragmentSample*, TInlineAllocator<4>> Candidates;
+					Representatives.MultiFind(Form.ShapeHash, Candidates);
+					for (const FFragmentSample* Candidate : Candidates)
+					{
+						if (Form.Matches(Geom, Forms[Candidate->RepresentationIndex], Candidate->ExtractedGeometry, Tolerance))
+						{
+							Source = Candidate;
+							break;
+						}
+					}
+					if (Source == &Sample)
+					{
+						Representatives.Add(Form.ShapeHash, &Sample);
+					}
+				}
+				SourcePtr = &SourceSamples.Add(RepIndex, Source);
+			}
+
+			const FFragmentSample* Source = *SourcePtr;
+			if (Source->RepresentationIndex == RepIndex)
+			{
+				continue;
+			}
+
+			// The rigid offset only composes exactly with uniformly scaled placements: FTransform drops the
+			// shear a non-uniform scale after the offset's rotation would need, in the sample or its item
+			if (!Geom.LocalTransform.GetScale3D().AllComponentsEqual(KINDA_SMALL_NUMBER)
+				|| !CurrentItem->GlobalTransform.GetScale3D().AllComponentsEqual(KINDA_SMALL_NUMBER))
+			{
+				continue;
+			}
+
+			// Source shell coordinates -> canonical -> this shell's coordinates
+			const FTransform Offset = Forms[Source->RepresentationIndex].Frame.Inverse() * Forms[RepIndex].Frame;
+
+			const FPreExtractedGeometry& SourceGeom = Source->ExtractedGeometry;
+			Geom.Vertices = SourceGeom.Vertices;
+			Geom.ProfileIndices = SourceGeom.ProfileIndices;
+			Geom.ProfileHoles = SourceGeom.ProfileHoles;
+			Geom.GeometryHash = SourceGeom.GeometryHash;
+			Geom.SourceRepresentationIndex = SourceGeom.SourceRepresentationIndex;
+			Geom.LocalTransform = Offset * Geom.LocalTransform;
+			MatchedSamples++;
+		}
+
+		for (FFragmentItem* Child : CurrentItem->FragmentChildren)
+		{
+			if (Child)
+			{
+				ItemStack.Add(Child);
+			}
+		}
+	}
+
+	int32 MatchedRepresentations = 0;
+	for (const TPair<int32, const FFragmentSample*>& Pair : SourceSamples)
+	{
+		MatchedRepresentations += Pair.Value->RepresentationIndex != Pair.Key ? 1 : 0;
+	}
+
+	UE_LOG(LogFragments, Log, TEXT("MatchRigidDuplicates: %d of %d shell representations are rigid copies, %d samples remapped"),
+		MatchedRepresentations, SourceSamples.Num(), MatchedSamples);
+
+	return MatchedSamples;
+}
+
+bool UFragmentsImporter::ExtractSampleGeometry(FFragmentSample& Sample, const Meshes* MeshesRef, int32 ItemLocalId, bool bMeshCached)
+{
+	// Reset the extracted geometry to ensure clean state
+	Sample.ExtractedGeometry = FPreExtractedGeometry();
+
+	// Validate indices are valid
+	if (Sample.RepresentationIndex < 0 || Sample.MaterialIndex < 0 || Sample.LocalTransformIndex < 0)
+	{
+		UE_LOG(LogFragments, Verbose, TEXT("ExtractSampleGeometry: Invalid indices for item %d, sample %d"),
+			ItemLocalId, Sample.SampleIndex);
+		return false;
+	}
+
+	// Validate FlatBuffer arrays exist
+	if (!MeshesRef->representations() || !MeshesRef->materials() || !MeshesRef->local_transforms())
+	{
+		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Missing FlatBuffer arrays for item %d"), ItemLocalId);
+		return false;
+	}
+
+	// Bounds check representation index
+	const uint32 RepCount = MeshesRef->representations()->size();
+	if (static_cast<uint32>(Sample.RepresentationIndex) >= RepCount)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: RepresentationIndex %d >= count %u for item %d"),
+			Sample.RepresentationIndex, RepCount, ItemLocalId);
+		return false;
+	}
+
+	// Get representation
+	const Representation* representation = MeshesRef->representations()->Get(Sample.RepresentationIndex);
+	if (!representation)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Representation is null for item %d"), ItemLocalId);
+		return false;
+	}
+
+	// Get material
+	const uint32 MatCount = MeshesRef->materials()->size();
+	if (static_cast<uint32>(Sample.MaterialIndex) >= MatCount)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: MaterialIndex %d >= count %u for item %d"),
+			Sample.MaterialIndex, MatCount, ItemLocalId);
+		return false;
+	}
+	const Material* material = MeshesRef->materials()->Get(Sample.MaterialIndex);
+
+	// Get local transform
+	const uint32 TransformCount = MeshesRef->local_transforms()->size();
+	if (static_cast<uint32>(Sample.LocalTransformIndex) >= TransformCount)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: LocalTransformIndex %d >= count %u for item %d"),
+			Sample.LocalTransformIndex, TransformCount, ItemLocalId);
+		return false;
+	}
+	const Transform* local_transform = MeshesRef->local_transforms()->Get(Sample.LocalTransformIndex);
+
+	// Extract material data
+	if (material)
+	{
+		Sample.ExtractedGeometry.R = material->r();
+		Sample.ExtractedGeometry.G = material->g();
+		Sample.ExtractedGeometry.B = material->b();
+		Sample.ExtractedGeometry.A = material->a();
+		Sample.ExtractedGeometry.bIsGlass = material->a() < 255;
+	}
+
+	// Extract local transform
+	if (local_transform)
+	{
+		Sample.ExtractedGeometry.LocalTransform = UFragmentsUtils::MakeTransform(local_transform);
+	}
+
+	// Store representation ID for debugging
+	Sample.ExtractedGeometry.RepresentationId = representation->id();
+	Sample.ExtractedGeometry.SourceRepresentationIndex = Sample.RepresentationIndex;
+
+	// Read by the instancing cost model, for cached representations too
+	Sample.ExtractedGeometry.TriangleCount = EstimateRepresentationTriangles(MeshesRef, representation);
+
+	// The built mesh is read from the derived mesh cache: material and placement are all spawning needs
+	if (bMeshCached)
+	{
+		Sample.ExtractedGeometry.bIsShell = representation->representation_class() == RepresentationClass::RepresentationClass_SHELL;
+		Sample.ExtractedGeometry.bFromDerivedCache = true;
+		Sample.ExtractedGeometry.bIsValid = true;
+		return true;
+	}
+
+	// Handle Shell geometry
+	if (representation->representation_class() == RepresentationClass::RepresentationClass_SHELL)
+	{
+		Sample.ExtractedGeometry.bIsShell = true;
+
+		if (!MeshesRef->shells())
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: shells() is null for item %d"), ItemLocalId);
+			return false;
+		}
+
+		const uint32 ShellId = representation->id();
+		const uint32 ShellCount = MeshesRef->shells()->size();
+
+		if (ShellId >= ShellCount)
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Shell id %u >= count %u for item %d"),
+				ShellId, ShellCount, ItemLocalId);
+			return false;
+		}
+
+		const Shell* shell = MeshesRef->shells()->Get(ShellId);
+		if (!shell)
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Shell %u is null for item %d"), ShellId, ItemLocalId);
+			return false;
+		}
+
+		// Validate and extract points
+		if (!shell->points() || shell->points()->size() == 0)
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Shell %u has no points for item %d"), ShellId, ItemLocalId);
+			return false;
+		}
+
+		const auto* Points = shell->points();
+		const uint32 PointCount = Points->size();
+
+		// Sanity check - prevent extremely large allocations
+		constexpr uint32 MaxPointCount = 1000000;
+		if (PointCount > MaxPointCount)
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Point count %u exceeds limit for item %d"), PointCount, ItemLocalId);
+			return false;
+		}
+
+		Sample.ExtractedGeometry.Vertices.Reserve(PointCount);
+		for (flatbuffers::uoffset_t i = 0; i < PointCount; i++)
+		{
+			const auto* P = Points->Get(i);
+			if (P)
+			{
+				// Convert to Unreal coordinates: Z-up, cm units
+				Sample.ExtractedGeometry.Vertices.Add(FVector(P->x() * 100.0f, P->z() * 100.0f, P->y() * 100.0f));
+			}
+		}
+
+		// Validate and extract profiles
+		const auto* Profiles = shell->profiles();
+		if (!Profiles)
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Shell %u has no profiles for item %d"), ShellId, ItemLocalId);
+			return false;
+		}
+
+		const uint32 ProfileCount = Profiles->size();
+		constexpr uint32 MaxProfileCount = 100000;
+		if (ProfileCount > MaxProfileCount)
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Profile count %u exceeds limit for item %d"), ProfileCount, ItemLocalId);
+			return false;
+		}
+
+		// Build hole map first
+		TMap<int32, TArray<TArray<int32>>> ProfileHolesMap;
+		if (shell->holes())
+		{
+			const auto* Holes = shell->holes();
+			const uint32 HoleCount = Holes->size();
+
+			for (flatbuffers::uoffset_t j = 0; j < HoleCount && j < MaxProfileCount; j++)
+			{
+				const auto* Hole = Holes->Get(j);
+				if (!Hole) continue;
+
+				int32 ProfileId = Hole->profile_id();
+
+				TArray<int32> HoleIndices;
+				if (Hole->indices())
+				{
+					const uint32 HoleIndexCount = Hole->indices()->size();
+					constexpr uint32 MaxIndicesPerProfile = 100000;
+					if (HoleIndexCount <= MaxIndicesPerProfile)
+					{
+						HoleIndices.Reserve(HoleIndexCount);
+						for (flatbuffers::uoffset_t k = 0; k < HoleIndexCount; k++)
+						{
+							HoleIndices.Add(Hole->indices()->Get(k));
+						}
+					}
+				}
+
+				ProfileHolesMap.FindOrAdd(ProfileId).Add(MoveTemp(HoleIndices));
+			}
+		}
+
+		// Extract profile indices
+		Sample.ExtractedGeometry.ProfileIndices.Reserve(ProfileCount);
+		Sample.ExtractedGeometry.ProfileHoles.SetNum(ProfileCount);
+
+		bool bHasValidProfile = false;
+		for (flatbuffers::uoffset_t i = 0; i < ProfileCount; i++)
+		{
+			const auto* Profile = Profiles->Get(i);
+			TArray<int32> ProfileVertexIndices;
+
+			if (Profile && Profile->indices())
+			{
+				const auto* Indices = Profile->indices();
+				const uint32 IndexCount = Indices->size();
+
+				// Skip profiles with fewer than 3 indices (not a valid polygon)
+				if (IndexCount >= 3)
+				{
+					constexpr uint32 MaxIndicesPerProfile = 100000;
+					if (IndexCount <= MaxIndicesPerProfile)
+					{
+						ProfileVertexIndices.Reserve(IndexCount);
+						for (flatbuffers::uoffset_t j = 0; j < IndexCount; j++)
+						{
+							ProfileVertexIndices.Add(Indices->Get(j));
+						}
+						bHasValidProfile = true;
+					}
+					else
+					{
+						UE_LOG(LogFragments, Verbose, TEXT("ExtractSampleGeometry: Profile %d has %u indices (limit %u), skipping"),
+							i, IndexCount, MaxIndicesPerProfile);
+					}
+				}
+			}
+
+			Sample.ExtractedGeometry.ProfileIndices.Add(MoveTemp(ProfileVertexIndices));
+
+			// Copy holes for this profile
+			if (TArray<TArray<int32>>* HolesForProfile = ProfileHolesMap.Find(i))
+			{
+				Sample.ExtractedGeometry.ProfileHoles[i] = *HolesForProfile;
+			}
+		}
+
+		if (!bHasValidProfile)
+		{
+			UE_LOG(LogFragments, Verbose, TEXT("ExtractSampleGeometry: No valid profiles for Shell %u, item %d"), ShellId, ItemLocalId);
+			return false;
+		}
+
+		// Mark as valid
+		Sample.ExtractedGeometry.bIsValid = true;
+		return true;
+	}
+	// Handle CircleExtrusion geometry
+	else if (representation->representation_class() == RepresentationClass_CIRCLE_EXTRUSION)
+	{
+		Sample.ExtractedGeometry.bIsShell = false;
+
+		if (!MeshesRef->circle_extrusions())
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: circle_extrusions() is null for item %d"), ItemLocalId);
+			return false;
+		}
+
+		const uint32 ExtrusionId = representation->id();
+		const uint32 ExtrusionCount = MeshesRef->circle_extrusions()->size();
+		if (ExtrusionId >= ExtrusionCount)
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: CircleExtrusion id %u >= count %u for item %d"),
+				ExtrusionId, ExtrusionCount, ItemLocalId);
+			return false;
+		}
+
+		const CircleExtrusion* Extrusion = MeshesRef->circle_extrusions()->Get(ExtrusionId);
+		if (!Extrusion || !Extrusion->axes() || !Extrusion->radius())
+		{
+			UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: CircleExtrusion %u has no axes for item %d"), ExtrusionId, ItemLocalId);
+			return false;
+		}
+
+		auto ToUnreal = [](const FloatVector& P)
+			{
+				return FVector(P.x(), P.z(), P.y()) * 100.0f;
+			};
+
+		TArray<FPreExtractedExtrusionPart>& Parts = Sample.ExtractedGeometry.ExtrusionParts;
+		const auto* Axes = Extrusion->axes();
+		const auto* Radii = Extrusion->radius();
+
+		for (flatbuffers::uoffset_t AxisIndex = 0; AxisIndex < Axes->size(); AxisIndex++)
+		{
+			const Axis* CurAxis = Axes->Get(AxisIndex);
+			if (!CurAxis || !CurAxis->order() || !CurAxis->parts() || AxisIndex >= Radii->size())
+			{
+				continue;
+			}
+
+			// One radius per axis, shared by all of its parts
+			const float Radius = Radii->Get(AxisIndex) * 100.0f;
+			const auto* Orders = CurAxis->order();
+			const auto* PartClasses = CurAxis->parts();
+
+			for (flatbuffers::uoffset_t i = 0; i < Orders->size() && i < PartClasses->size(); i++)
+			{
+				const uint32 OrderIndex = Orders->Get(i);
+				FPreExtractedExtrusionPart Part;
+				Part.Radius = Radius;
+
+				switch (PartClasses->Get(i))
+				{
+				case AxisPartClass_WIRE:
+				{
+					if (!CurAxis->wires() || OrderIndex >= CurAxis->wires()->size())
+					{
+						continue;
+					}
+					const Wire* CurWire = CurAxis->wires()->Get(OrderIndex);
+					Part.Type = EExtrusionPartType::Wire;
+					Part.Points.Add(ToUnreal(CurWire->p1()));
+					Part.Points.Add(ToUnreal(CurWire->p2()));
+					break;
+				}
+				case AxisPartClass_WIRE_SET:
+				{
+					if (!CurAxis->wire_sets() || OrderIndex >= CurAxis->wire_sets()->size())
+					{
+						continue;
+					}
+					const auto* Points = CurAxis->wire_sets()->Get(OrderIndex)->ps();
+					if (!Points || Points->size() < 2)
+					{
+						continue;
+					}
+					Part.Type = EExtrusionPartType::WireSet;
+					Part.Points.Reserve(Points->size());
+					for (flatbuffers::uoffset_t p = 0; p < Points->size(); p++)
+					{
+						Part.Points.Add(ToUnreal(*Points->Get(p)));
+					}
+					break;
+				}
+				case AxisPartClass_CIRCLE_CURVE:
+				{
+					if (!CurAxis->circle_curves() || OrderIndex >= CurAxis->circle_curves()->size())
+					{
+						continue;
+					}
+					const CircleCurve* Curve = CurAxis->circle_curves()->Get(OrderIndex);
+					Part.Type = EExtrusionPartType::CircleCurve;
+					Part.ArcCenter = ToUnreal(Curve->position());
+					Part.ArcXDirection = ToUnreal(Curve->x_direction()).GetSafeNormal();
+					Part.ArcYDirection = ToUnreal(Curve->y_direction()).GetSafeNormal();
+					Part.ArcAperture = FMath::DegreesToRadians(Curve->aperture());
+					Part.ArcRadius = Curve->radius() * 100.0f;
+					break;
+				}
+				default:
+					continue;
+				}
+
+				Parts.Add(MoveTemp(Part));
+			}
+		}
+
+		if (Parts.Num() == 0)
+		{
+			UE_LOG(LogFragments, Verbose, TEXT("ExtractSampleGeometry: No valid axis parts for CircleExtrusion %u, item %d"), ExtrusionId, ItemLocalId);
+			return false;
+		}
+
+		Sample.ExtractedGeometry.bIsValid = true;
+		return true;
+	}
+
+	// Unknown representation class
+	UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Unknown representation class %d for item %d"),
+		static_cast<int32>(representation->representation_class()), ItemLocalId);
+	return false;
+}
+
+// ==========================================
+// GPU INSTANCING METHODS (Phase 4)
+// ==========================================
+
+bool UFragmentsImporter::ShouldUseInstancing(uint64 MeshKey, uint32 MaterialHash, const FString& Category) const
+{
+	if (!bEnableGPUInstancing)
+	{
+		return false;
+	}
+
+	const FInstancingGroupStats* Stats = InstancingGroupStats.Find(MakeInstanceGroupKey(MeshKey, MaterialHash));
+	if (!Stats)
+	{
+		return false;
+	}
+
+	if (InstancingCategoryOverrides.Num() > 0)
+	{
+		if (const EFragmentInstancingMode* Mode = InstancingCategoryOverrides.Find(Category))
+		{
+			if (*Mode == EFragmentInstancingMode::Always)
+			{
+				return true;
+			}
+			if (*Mode == EFragmentInstancingMode::Never)
+			{
+				return false;
+			}
+		}
+	}
+	return Stats->bInstanced;
+}
+
+bool UFragmentsImporter::IsSampleInstanced(const FFragmentSample& Sample, const FString& Category) const
+{
+	const FPreExtractedGeometry& Geometry = Sample.ExtractedGeometry;
+	return ShouldUseInstancing(Geometry.GeometryHash,
+		GetGroupMaterialHash(Geometry.R, Geometry.G, Geometry.B, Geometry.A, Geometry.bIsGlass), Category);
+}
+
+void UFragmentsImporter::EvaluateInstancingCost(FInstancingGroupStats& Stats) const
+{
+	// Every copy beyond the first stops being a draw call (per pass) of its own
+	const int32 ExtraCopies = FMath::Max(Stats.InstanceCount - 1, 0);
+	Stats.DrawCallTerm = static_cast<float>(ExtraCopies);
+
+	// Separately drawn copies resubmit their vertices; heavy shapes save more per copy
+	Stats.TriangleTerm = static_cast<float>(ExtraCopies) * Stats.TriangleCount / FMath::Max(InstancingTrianglesPerDrawCall, 1.0f);
+
+	// Mesh and material are shared either way: a component per copy against one HISMC and per-instance data
+	const int64 SeparateBytes = static_cast<int64>(Stats.InstanceCount) * UStaticMeshComponent::StaticClass()->GetStructureSize();
+	const int64 InstancedBytes = UHierarchicalInstancedStaticMeshComponent::StaticClass()->GetStructureSize()
+		+ static_cast<int64>(Stats.InstanceCount) * FFragmentResourceLedger::GetInstanceBytes(GetInstanceCustomDataFloats());
+	Stats.MemoryTerm = static_cast<float>(SeparateBytes - InstancedBytes) / FMath::Max(InstancingBytesPerDrawCall, 1.0f);
+
+	Stats.Benefit = Stats.DrawCallTerm + Stats.TriangleTerm + Stats.MemoryTerm - InstancingGroupCost;
+	Stats.bInstanced = ExtraCopies > 0 && Stats.Benefit >= 0.0f;
+}
+
+FString UFragmentsImporter::DumpInstancingDecisions(int32 MaxRows) const
+{
+	TArray<TPair<uint64, const FInstancingGroupStats*>> Rows;
+	Rows.Reserve(InstancingGroupStats.Num());
+	int32 InstancedGroups = 0;
+	for (const TPair<uint64, FInstancingGroupStats>& Pair : InstancingGroupStats)
+	{
+		Rows.Emplace(Pair.Key, &Pair.Value);
+		InstancedGroups += Pair.Value.bInstanced ? 1 : 0;
+	}
+	Rows.Sort([](const TPair<uint64, const FInstancingGroupStats*>& A, const TPair<uint64, const FInstancingGroupStats*>& B)
+	{
+		return A.Value->Benefit > B.Value->Benefit;
+	});
+
+	FString Report = FString::Printf(TEXT("Instancing decisions: %d groups, %d instanced (group cost %.1f, %.0f triangles / %.0f bytes per draw call)\n"),
+		Rows.Num(), InstancedGroups, InstancingGroupCost, InstancingTrianglesPerDrawCall, InstancingBytesPerDrawCall);
+	Report += FString::Printf(TEXT("%-16s %-24s %8s %9s %9s %9s %9s %9s  %s\n"),
+		TEXT("Group"), TEXT("Category"), TEXT("Inst"), TEXT("Tris"), TEXT("Draws"), TEXT("TriTerm"), TEXT("MemTerm"), TEXT("Benefit"), TEXT("Decision"));
+
+	const int32 RowCount = MaxRows > 0 ? FMath::Min(MaxRows, Rows.Num()) : Rows.Num();
+	for (int32 i = 0; i < RowCount; i++)
+	{
+		const FInstancingGroupStats& Stats = *Rows[i].Value;
+
+		// Overrides are per fragment; the group shows the one of its first category
+		const EFragmentInstancingMode* Mode = InstancingCategoryOverrides.Find(Stats.Category);
+		const TCHAR* Decision = Stats.bInstanced ? TEXT("Instanced") : TEXT("Separate");
+		if (Mode && *Mode == EFragmentInstancingMode::Always)
+		{
+			Decision = TEXT("Instanced (override)");
+		}
+		else if (Mode && *Mode == EFragmentInstancingMode::Never)
+		{
+			Decision = TEXT("Separate (override)");
+		}
+
+		Report += FString::Printf(TEXT("%016llx %-24s %8d %9d %9.1f %9.1f %9.1f %9.1f  %s\n"),
+			Rows[i].Key, *Stats.Category.Left(24), Stats.InstanceCount, Stats.TriangleCount,
+			Stats.DrawCallTerm, Stats.TriangleTerm, Stats.MemoryTerm, Stats.Benefit, Decision);
+	}
+	if (RowCount < Rows.Num())
+	{
+		Report += FString::Printf(TEXT("... %d more groups\n"), Rows.Num() - RowCount);
+	}
+
+	UE_LOG(LogFragments, Log, TEXT("%s"), *Report);
+	return Report;
+}
+
+UHierarchicalInstancedStaticMeshComponent* UFragmentsImporter::GetOrCreateISMC(
+	uint64 MeshKey, uint32 MaterialHash,
+	UStaticMesh* Mesh, UMaterialInstanceDynamic* Material)
+{
+	if (!Mesh)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("GetOrCreateISMC: Mesh is null for Mesh=%016llx"), MeshKey);
+		return nullptr;
+	}
+
+	const uint64 ComboKey = MakeInstanceGroupKey(MeshKey, MaterialHash);
+
+	// Check if HISMC already exists for this combination
+	if (FInstancedMeshGroup* Existing = InstancedMeshGroups.Find(ComboKey))
+	{
+		return Existing->ISMC;
+	}
+
+	// Create host actor if needed (single actor holds all HISMCs for organization)
+	if (!ISMCHostActor && OwnerRef)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = OwnerRef;
+		ISMCHostActor = OwnerRef->GetWorld()->SpawnActor<AActor>(AActor::StaticClass(),
+			FTransform::Identity, SpawnParams);
+
+		if (ISMCHostActor)
+		{
+#if WITH_EDITOR
+			ISMCHostActor->SetActorLabel(TEXT("FragmentHISMCHost"));
+#endif
+			UE_LOG(LogFragments, Log, TEXT("Created HISMC host actor"));
+		}
+	}
+
+	if (!ISMCHostActor)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("GetOrCreateISMC: Failed to create host actor"));
+		return nullptr;
+	}
+
+	// Create new HISMC for per-cluster culling
+	UHierarchicalInstancedStaticMeshComponent* ISMC = NewObject<UHierarchicalInstancedStaticMeshComponent>(ISMCHostActor);
+	if (!ISMC)
+	{
+		UE_LOG(LogFragments, Error, TEXT("GetOrCreateISMC: Failed to create HISMC for Mesh=%016llx"), MeshKey);
+		return nullptr;
+	}
+
+	ISMC->SetStaticMesh(Mesh);
+	ISMC->SetMobility(EComponentMobility::Static);
+
+	// Disable Lumen/Distance Field to avoid "Preparing mesh distance fields" delays
+	ISMC->bAffectDistanceFieldLighting = false;
+	ISMC->bAffectDynamicIndirectLighting = false;
+	ISMC->bAffectIndirectLightingWhileHidden = false;
+
+	// CRITICAL: Disable shadow casting - this was causing 280ms+ Shadow Depths overhead!
+	// Instanced furniture/repeated elements typically don't need per-instance shadows
+	ISMC->SetCastShadow(false);
+	ISMC->bCastDynamicShadow = false;
+	ISMC->bCastStaticShadow = false;
+
+	// Store LocalId (and the color with the shared material) in custom data for picking support
+	ISMC->NumCustomDataFloats = GetInstanceCustomDataFloats();
+
+	// Default: most instanced elements are furniture, not occluders
+	ISMC->bUseAsOccluder = false;
+
+	// Attach and register
+	ISMC->AttachToComponent(ISMCHostActor->GetRootComponent(),
+		FAttachmentTransformRules::KeepRelativeTransform);
+	ISMC->RegisterComponent();
+	ISMCHostActor->AddInstanceComponent(ISMC);
+
+	// IMPORTANT: Set material AFTER registration - material overrides don't persist on unregistered components
+	if (Material)
+	{
+		ISMC->SetMaterial(0, Material);
+	}
+
+	// Create and store the group
+	FInstancedMeshGroup Group;
+	Group.ISMC = ISMC;
+	Group.MeshKey = MeshKey;
+	Group.MaterialHash = MaterialHash;
+	Group.InstanceCount = 0;
+	InstancedMeshGroups.Add(ComboKey, Group);
+	ISMCGroupKeys.Add(ISMC, ComboKey);
+
+	UE_LOG(LogFragments, Log, TEXT("Created HISMC for Mesh=%016llx, MatHash=%u"), MeshKey, MaterialHash);
+	return ISMC;
+}
+
+void UFragmentsImporter::QueueInstanceForBatchAdd(uint64 MeshKey, uint32 MaterialHash,
+	const FTransform& WorldTransform, const FFragmentItem& Item,
+	UStaticMesh* Mesh, UMaterialInstanceDynamic* Material, const FColor& MaterialColor)
+{
+	const uint64 ComboKey = MakeInstanceGroupKey(MeshKey, MaterialHash);
+
+	// Streaming hides and evicts the fragment's instances through this index
+	const FPendingInstanceData Pending = MakePendingInstance(Item, WorldTransform, MaterialColor);
+	InstancedFragmentGroups.FindOrAdd(FFragmentKey(Pending.ModelKey, Pending.LocalId)).AddUnique(ComboKey);
+	WidenGroupCullDistance(InstancedMeshGroups.FindOrAdd(ComboKey), GetFragmentMaxDimension(Item.ModelGuid, Item.LocalId));
+
+	// Check if ISMC already exists (from previous incremental finalization)
+	FInstancedMeshGroup* ExistingGroup = InstancedMeshGroups.Find(ComboKey);
+	if (ExistingGroup && ExistingGroup->ISMC != nullptr)
+	{
+		// ISMC already exists - add directly to it instead of queuing
+		// This handles the TileManager streaming case where ISMC was finalized earlier
+		AddInstanceToExistingISMC(MeshKey, MaterialHash, WorldTransform, Item, Mesh, Material, MaterialColor);
+		return;
+	}
+
+	// Get or create group (but DON'T create ISMC yet - that happens in FinalizeAllISMCs or incrementally)
+	FInstancedMeshGroup& Group = InstancedMeshGroups.FindOrAdd(ComboKey);
+
+	// Store classification data from first instance (all instances in a group share the same classification)
+	const bool bIsNewGroup = Group.PendingInstances.Num() == 0;
+	if (bIsNewGroup)
+	{
+		Group.FirstCategory = Item.Category;
+		Group.FirstMaterialAlpha = MaterialColor.A;
+	}
+
+	Group.MeshKey = MeshKey;
+	Group.MaterialHash = MaterialHash;
+
+	// The group holds one reference on its mesh and material for as long as it exists
+	if (Group.CachedMesh != Mesh)
+	{
+		AcquireRepresentationMesh(Mesh);
+		ReleaseRepresentationMesh(Group.CachedMesh);
+	}
+	if (Group.CachedMaterial != Material)
+	{
+		AcquirePooledMaterial(Material);
+		ReleasePooledMaterial(Group.CachedMaterial);
+	}
+	Group.CachedMesh = Mesh;
+	Group.CachedMaterial = Material;
+
+	// Queue the instance data for batch addition later
+	Group.PendingInstances.Add(Pending);
+	UnfinalizedInstanceGroups.Add(ComboKey);
+	TotalPendingInstances++;
+
+	// ==========================================
+	// INCREMENTAL FINALIZATION: Prevent OOM on large models
+	// ==========================================
+
+	// Check 1: If this group has too many pending instances, sort them on a worker and finalize once sorted
+	if (IncrementalFinalizationThreshold > 0 &&
+		Group.PendingInstances.Num() >= IncrementalFinalizationThreshold)
+	{
+		const FInstanceBatchPreparation* Preparation = InstanceBatchPreparations.Find(ComboKey);
+		if (!Preparation)
+		{
+			StartInstanceBatchPreparation(ComboKey, Group);
+		}
+		else if (Preparation->Future.IsReady())
+		{
+			UE_LOG(LogFragments, Log, TEXT("Incremental finalization triggered: Mesh=%016llx has %d pending instances (threshold=%d)"),
+				MeshKey, Group.PendingInstances.Num(), IncrementalFinalizationThreshold);
+			FinalizeISMCGroup(ComboKey, Group);
+			return;
+		}
+	}
+
+	// Check 2: If the pending instances not yet being sorted exceed the global limit, sort the largest
+	// groups on workers; FinalizeISMCsWithBudget commits them once their batches are ready
+	if (MaxPendingInstancesTotal > 0 && TotalPendingInstances - PreparingInstances >= MaxPendingInstancesTotal)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("Global pending limit reached: %d instances, %d preparing (limit=%d) - preparing groups"),
+			TotalPendingInstances, PreparingInstances, MaxPendingInstancesTotal);
+
+		// Max-heap of the unfinalized groups by pending instances, built once per trigger
+		auto ByMostPending = [](const TPair<int32, uint64>& A, const TPair<int32, uint64>& B)
+		{
+			return A.Key > B.Key;
+		};
+
+		TArray<TPair<int32, uint64>> LargestGroups;
+		LargestGroups.Reserve(UnfinalizedInstanceGroups.Num());
+		for (uint64 Key : UnfinalizedInstanceGroups)
+		{
+			const FInstancedMeshGroup* Candidate = InstancedMeshGroups.Find(Key);
+			if (Candidate && !InstanceBatchPreparations.Contains(Key))
+			{
+				LargestGroups.Emplace(Candidate->PendingInstances.Num(), Key);
+			}
+		}
+		LargestGroups.Heapify(ByMostPending);
+
+		// Prepare groups with the most pending instances until under limit
+		while (TotalPendingInstances - PreparingInstances >= MaxPendingInstancesTotal * 0.8 && LargestGroups.Num() > 0) // Target 80% to give headroom
+		{
+			TPair<int32, uint64> Largest;
+			LargestGroups.HeapPop(Largest, ByMostPending);
+
+			if (const FInstancedMeshGroup* LargestGroup = InstancedMeshGroups.Find(Largest.Value))
+			{
+				StartInstanceBatchPreparation(Largest.Value, *LargestGroup);
+			}
+		}
+	}
+}
+
+void UFragmentsImporter::FinalizeAllISMCs()
+{
+	if (UnfinalizedInstanceGroups.Num() == 0)
+	{
+		// Instances staged for groups finalized earlier
+		FlushInstanceVisibility();
+		return;
+	}
+
+	const TArray<uint64> GroupKeys = UnfinalizedInstanceGroups.Array();
+
+	// Sort every group on the workers first, then commit them in turn as they become ready
+	for (uint64 ComboKey : GroupKeys)
+	{
+		if (const FInstancedMeshGroup* Group = InstancedMeshGroups.Find(ComboKey))
+		{
+			StartInstanceBatchPreparation(ComboKey, *Group);
+		}
+	}
+
+	int32 TotalInstancesAdded = 0;
+	int32 TotalISMCsCreated = 0;
+
+	for (uint64 ComboKey : GroupKeys)
+	{
+		FInstancedMeshGroup* Group = InstancedMeshGroups.Find(ComboKey);
+		if (!Group)
+		{
+			UnfinalizedInstanceGroups.Remove(ComboKey);
+			RemoveInstanceBatchPreparation(ComboKey);
+			continue;
+		}
+
+		// The explicit flush: the only caller that may wait for workers or sort on the game thread
+		const int32 InstancesAdded = FinalizeISMCGroup(ComboKey, *Group, /*bWaitForBatch=*/true);
+		if (InstancesAdded > 0)
+		{
+			TotalInstancesAdded += InstancesAdded;
+			TotalISMCsCreated++;
+		}
+	}
+
+	UE_LOG(LogFragments, Log, TEXT("=== ISMC FINALIZATION COMPLETE: %d ISMCs, %d total instances ==="),
+		TotalISMCsCreated, TotalInstancesAdded);
+
+	// Reset pending counter
+	if (UnfinalizedInstanceGroups.Num() == 0)
+	{
+		TotalPendingInstances = 0;
+	}
+
+	// Instances staged for groups finalized earlier
+	FlushInstanceVisibility();
+}
+
+void UFragmentsImporter::FinalizeISMCsWithBudget(float BudgetMs)
+{
+	if (UnfinalizedInstanceGroups.Num() == 0)
+	{
+		FlushInstanceVisibility();
+		return;
+	}
+
+	const double Deadline = FPlatformTime::Seconds() + BudgetMs / 1000.0;
+	int32 Committed = 0;
+	int32 Preparing = 0;
+
+	for (uint64 ComboKey : UnfinalizedInstanceGroups.Array())
+	{
+		FInstancedMeshGroup* Group = InstancedMeshGroups.Find(ComboKey);
+		if (!Group || Group->ISMC != nullptr || Group->PendingInstances.Num() == 0)
+		{
+			UnfinalizedInstanceGroups.Remove(ComboKey);
+			RemoveInstanceBatchPreparation(ComboKey);
+			continue;
+		}
+
+		const FInstanceBatchPreparation* Preparation = InstanceBatchPreparations.Find(ComboKey);
+		if (!Preparation)
+		{
+			StartInstanceBatchPreparation(ComboKey, *Group);
+			Preparing++;
+			continue;
+		}
+
+		if (!Preparation->Future.IsReady())
+		{
+			Preparing++;
+			continue;
+		}
+
+		// Later groups still get their preparations started once the budget is spent
+		if (Committed > 0 && FPlatformTime::Seconds() >= Deadline)
+		{
+			continue;
+		}
+
+		// A stale batch (instances removed meanwhile) is prepared again instead of sorted here
+		FinalizeISMCGroup(ComboKey, *Group);
+		if (Group->ISMC != nullptr)
+		{
+			Committed++;
+		}
+		else
+		{
+			Preparing += InstanceBatchPreparations.Contains(ComboKey) ? 1 : 0;
+		}
+	}
+
+	UE_LOG(LogFragments, Verbose, TEXT("FinalizeISMCsWithBudget: %d groups committed, %d preparing, %d unfinalized"),
+		Committed, Preparing, UnfinalizedInstanceGroups.Num());
+
+	// Instances queued while the committed groups were preparing go in with the other staged changes
+	FlushInstanceVisibility();
+}
+
+int32 UFragmentsImporter::FinalizeISMCGroup(uint64 ComboKey, FInstancedMeshGroup& Group, bool bWaitForBatch)
+{
+	// Skip if already finalized or no pending instances
+	if (Group.ISMC != nullptr || Group.PendingInstances.Num() == 0)
+	{
+		UnfinalizedInstanceGroups.Remove(ComboKey);
+		RemoveInstanceBatchPreparation(ComboKey);
+		return 0;
+	}
+
+	if (!Group.CachedMesh)
+	{
+		UE_LOG(LogFragments, Warning, TEXT("FinalizeISMCGroup: No cached mesh for Mesh=%016llx"), Group.MeshKey);
+		return -1;
+	}
+
+	// Morton-sorted batch; without one the group stays unfinalized until its worker is done
+	FPreparedInstanceBatch Batch;
+	if (!TakeInstanceBatch(ComboKey, Group, bWaitForBatch, Batch))
+	{
+		return 0;
+	}
+
+	// Ensure host actor exists
+	if (!ISMCHostActor && OwnerRef)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = OwnerRef;
+		ISMCHostActor = OwnerRef->GetWorld()->SpawnActor<AActor>(AActor::StaticClass(),
+			FTransform::Identity, SpawnParams);
+		if (ISMCHostActor)
+		{
+#if WITH_EDITOR
+			ISMCHostActor->SetActorLabel(TEXT("FragmentISMCHost"));
+#endif
+		}
+	}
+
+	if (!ISMCHostActor)
+	{
+		UE_LOG(LogFragments, Error, TEXT("FinalizeISMCGroup: Failed to create host actor"));
+		return -1;
+	}
+
+	// Create HISMC (NOT registered yet - we'll register after adding all instances)
+	// HISMC provides per-cluster culling for better performance
+	UHierarchicalInstancedStaticMeshComponent* ISMC = NewObject<UHierarchicalInstancedStaticMeshComponent>(ISMCHostActor);
+	if (!ISMC)
+	{
+		UE_LOG(LogFragments, Error, TEXT("FinalizeISMCGroup: Failed to create HISMC for Mesh=%016llx"), Group.MeshKey);
+		return -1;
+	}
+
+	ISMC->SetStaticMesh(Group.CachedMesh);
+	ISMC->SetMobility(EComponentMobility::Static);
+
+	// Disable expensive Lumen/Distance Field features
+	ISMC->bAffectDistanceFieldLighting = false;
+	ISMC->bAffectDynamicIndirectLighting = false;
+	ISMC->bAffectIndirectLightingWhileHidden = false;
+
+	// Configure occlusion culling based on fragment classification
+	const EOcclusionRole Role = UFragmentOcclusionClassifier::ClassifyFragment(
+		Group.FirstCategory, Group.FirstMaterialAlpha);
+
+	switch (Role)
+	{
+	case EOcclusionRole::Occluder:
+		// Large structural elements that block visibility
+		ISMC->bUseAsOccluder = true;
+		ISMC->SetCastShadow(true);
+		ISMC->bCastDynamicShadow = true;
+		ISMC->bCastStaticShadow = true;
+		break;
+
+	case EOcclusionRole::Occludee:
+		// Objects that can be hidden by occluders
+		ISMC->bUseAsOccluder = false;
+		ISMC->SetCastShadow(true);
+		ISMC->bCastDynamicShadow = true;
+		ISMC->bCastStaticShadow = true;
+		break;
+
+	case EOcclusionRole::NonOccluder:
+		// Transparent/glass elements
+		ISMC->bUseAsOccluder = false;
+		ISMC->SetCastShadow(false);
+		ISMC->bCastDynamicShadow = false;
+		ISMC->bCastStaticShadow = false;
+		break;
+	}
+
+	// Custom data for picking
+	ISMC->NumCustomDataFloats = GetInstanceCustomDataFloats();
+
+	// Far instances too small for the streaming threshold are culled per cluster by the renderer
+	// (start = end: a hard cut, no per-instance fade range)
+	if (Group.CullDistance > 0.0f)
+	{
+		const int32 CullDistance = FMath::CeilToInt(Group.CullDistance);
+		ISMC->SetCullDistances(CullDistance, CullDistance);
+	}
+
+	// Attach to host (still not registered)
+	ISMC->AttachToComponent(ISMCHostActor->GetRootComponent(),
+		FAttachmentTransformRules::KeepRelativeTransform);
+
+	// Fragments hidden since the batch was prepared stay out of the HISMC
+	const int32 QueuedInstances = Group.PendingInstances.Num();
+
+	TArray<FPendingInstanceData> VisibleInstances;
+	TArray<FTransform> Transforms;
+	VisibleInstances.Reserve(Batch.Order.Num());
+	Transforms.Reserve(Batch.Order.Num());
+	for (int32 i = 0; i < Batch.Order.Num(); i++)
+	{
+		FPendingInstanceData& Pending = Group.PendingInstances[Batch.Order[i]];
+		if (!StashHiddenInstance(Group, Pending))
+		{
+			VisibleInstances.Add(MoveTemp(Pending));
+			Transforms.Add(Batch.Transforms[i]);
+		}
+	}
+
+	// Instances queued after the batch was prepared are staged for the new HISMC
+	Group.PendingInstances.RemoveAt(0, Batch.Order.Num());
+
+	// BATCH ADD ALL INSTANCES AT ONCE
+	TArray<int32> NewIndices = ISMC->AddInstances(Transforms, /*bShouldReturnIndices=*/true, /*bWorldSpace=*/true);
+
+	// NOW register the component (after all instances are added)
+	ISMC->RegisterComponent();
+	ISMCHostActor->AddInstanceComponent(ISMC);
+
+	// Set material AFTER registration - material overrides don't persist on unregistered components
+	if (Group.CachedMaterial)
+	{
+		ISMC->SetMaterial(0, Group.CachedMaterial);
+	}
+
+	// Set custom data and build lookup maps
+	Group.ISMC = ISMC;
+	ISMCGroupKeys.Add(ISMC, ComboKey);
+	RegisterGroupInstances(Group, VisibleInstances, NewIndices);
 
-			Sample.ExtractedGeometry.ProfileIndices.Add(MoveTemp(ProfileVertexIndices));
+	// Mark render state dirty once for all custom data
+	ISMC->MarkRenderStateDirty();
 
-			// Copy holes for this profile
-			if (TArray<TArray<int32>>* HolesForProfile = ProfileHolesMap.Find(i))
-			{
-				Sample.ExtractedGeometry.ProfileHoles[i] = *HolesForProfile;
-			}
-		}
+	int32 InstancesAdded = VisibleInstances.Num();
+	Group.InstanceCount = InstancesAdded;
 
-		if (!bHasValidProfile)
-		{
-			UE_LOG(LogFragments, Verbose, TEXT("ExtractSampleGeometry: No valid profiles for Shell %u, item %d"), ShellId, ItemLocalId);
-			return false;
-		}
+	// Update pending counter
+	TotalPendingInstances -= QueuedInstances;
+	TotalPendingInstances = FMath::Max(0, TotalPendingInstances);
+	UnfinalizedInstanceGroups.Remove(ComboKey);
 
-		// Mark as valid
-		Sample.ExtractedGeometry.bIsValid = true;
-		return true;
+	if (Group.PendingInstances.Num() > 0)
+	{
+		DirtyInstanceGroups.Add(ComboKey);
 	}
-	// Handle CircleExtrusion geometry
-	else if (representation->representation_class() == RepresentationClass_CIRCLE_EXTRUSION)
+	else
 	{
-		Sample.ExtractedGeometry.bIsShell = false;
-
-		// For CircleExtrusion, we mark as valid but don't pre-extract the complex geometry
-		// The spawn phase will still use the FlatBuffer path for CircleExtrusion
-		// This is acceptable because CircleExtrusion uses a different (working) code path
-		// TODO: Implement full CircleExtrusion extraction if needed
-		Sample.ExtractedGeometry.bIsValid = true;
-		return true;
+		Group.PendingInstances.Empty();  // Release allocated memory
 	}
 
-	// Unknown representation class
-	UE_LOG(LogFragments, Warning, TEXT("ExtractSampleGeometry: Unknown representation class %d for item %d"),
-		static_cast<int32>(representation->representation_class()), ItemLocalId);
-	return false;
-}
+	UE_LOG(LogFragments, Log, TEXT("FinalizeISMCGroup: Created ISMC for Mesh=%016llx with %d instances"),
+		Group.MeshKey, InstancesAdded);
 
-// ==========================================
-// GPU INSTANCING METHODS (Phase 4)
-// ==========================================
+	return InstancesAdded;
+}
 
-bool UFragmentsImporter::ShouldUseInstancing(int32 RepresentationId, uint32 MaterialHash) const
+void UFragmentsImporter::StartInstanceBatchPreparation(uint64 ComboKey, const FInstancedMeshGroup& Group)
 {
-	if (!bEnableGPUInstancing)
+	if (Group.ISMC != nullptr || !Group.CachedMesh || Group.PendingInstances.Num() == 0
+		|| InstanceBatchPreparations.Contains(ComboKey))
 	{
-		return false;
+		return;
 	}
 
-	int64 ComboKey = ((int64)RepresentationId) | ((int64)MaterialHash << 32);
-	if (const int32* Count = RepresentationMaterialInstanceCount.Find(ComboKey))
+	// Only the transforms go to the worker; the pending instances stay with the group
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Group.PendingInstances.Num());
+	for (const FPendingInstanceData& Pending : Group.PendingInstances)
 	{
-		return *Count >= InstancingThreshold;
+		Transforms.Add(Pending.WorldTransform);
 	}
-	return false;
+
+	FInstanceBatchPreparation& Preparation = InstanceBatchPreparations.Add(ComboKey);
+	Preparation.Revision = Group.PendingRevision;
+	Preparation.InstanceCount = Transforms.Num();
+	PreparingInstances += Preparation.InstanceCount;
+	Preparation.Future = Async(EAsyncExecution::ThreadPool, [Transforms = MoveTemp(Transforms)]() mutable
+	{
+		return PrepareInstanceBatch(MoveTemp(Transforms));
+	});
 }
 
-UHierarchicalInstancedStaticMeshComponent* UFragmentsImporter::GetOrCreateISMC(
-	int32 RepresentationId, uint32 MaterialHash,
-	UStaticMesh* Mesh, UMaterialInstanceDynamic* Material)
+void UFragmentsImporter::RemoveInstanceBatchPreparation(uint64 ComboKey)
 {
-	if (!Mesh)
+	if (const FInstanceBatchPreparation* Preparation = InstanceBatchPreparations.Find(ComboKey))
 	{
-		UE_LOG(LogFragments, Warning, TEXT("GetOrCreateISMC: Mesh is null for RepId=%d"), RepresentationId);
-		return nullptr;
+		PreparingInstances = FMath::Max(0, PreparingInstances - Preparation->InstanceCount);
+		InstanceBatchPreparations.Remove(ComboKey);
 	}
+}
 
-	int64 ComboKey = ((int64)RepresentationId) | ((int64)MaterialHash << 32);
-
-	// Check if HISMC already exists for this combination
-	if (FInstancedMeshGroup* Existing = InstancedMeshGroups.Find(ComboKey))
+bool UFragmentsImporter::TakeInstanceBatch(uint64 ComboKey, const FInstancedMeshGroup& Group, bool bWait, FPreparedInstanceBatch& OutBatch)
+{
+	if (FInstanceBatchPreparation* Found = InstanceBatchPreparations.Find(ComboKey))
 	{
-		return Existing->ISMC;
-	}
+		if (!bWait && !Found->Future.IsReady())
+		{
+			return false;
+		}
 
-	// Create host actor if needed (single actor holds all HISMCs for organization)
-	if (!ISMCHostActor && OwnerRef)
-	{
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.Owner = OwnerRef;
-		ISMCHostActor = OwnerRef->GetWorld()->SpawnActor<AActor>(AActor::StaticClass(),
-			FTransform::Identity, SpawnParams);
+		TFuture<FPreparedInstanceBatch> Future = MoveTemp(Found->Future);
+		const uint32 Revision = Found->Revision;
+		RemoveInstanceBatchPreparation(ComboKey);
 
-		if (ISMCHostActor)
+		// Appended instances leave the prepared prefix valid; removals shift it
+		OutBatch = Future.Get();
+		if (Revision == Group.PendingRevision && OutBatch.Order.Num() <= Group.PendingInstances.Num())
 		{
-#if WITH_EDITOR
-			ISMCHostActor->SetActorLabel(TEXT("FragmentHISMCHost"));
-#endif
-			UE_LOG(LogFragments, Log, TEXT("Created HISMC host actor"));
+			return true;
 		}
 	}
 
-	if (!ISMCHostActor)
+	// Sorting is worker work outside the explicit flush
+	if (!bWait)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("GetOrCreateISMC: Failed to create host actor"));
-		return nullptr;
+		StartInstanceBatchPreparation(ComboKey, Group);
+		return false;
 	}
 
-	// Create new HISMC for per-cluster culling
-	UHierarchicalInstancedStaticMeshComponent* ISMC = NewObject<UHierarchicalInstancedStaticMeshComponent>(ISMCHostActor);
-	if (!ISMC)
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(Group.PendingInstances.Num());
+	for (const FPendingInstanceData& Pending : Group.PendingInstances)
 	{
-		UE_LOG(LogFragments, Error, TEXT("GetOrCreateISMC: Failed to create HISMC for RepId=%d"), RepresentationId);
-		return nullptr;
+		Transforms.Add(Pending.WorldTransform);
 	}
+	OutBatch = PrepareInstanceBatch(MoveTemp(Transforms));
+	return true;
+}
 
-	ISMC->SetStaticMesh(Mesh);
-	ISMC->SetMobility(EComponentMobility::Static);
+bool UFragmentsImporter::AddInstanceToExistingISMC(uint64 MeshKey, uint32 MaterialHash,
+	const FTransform& WorldTransform, const FFragmentItem& Item,
+	UStaticMesh* Mesh, UMaterialInstanceDynamic* Material, const FColor& MaterialColor)
+{
+	const uint64 ComboKey = MakeInstanceGroupKey(MeshKey, MaterialHash);
 
-	// Disable Lumen/Distance Field to avoid "Preparing mesh distance fields" delays
-	ISMC->bAffectDistanceFieldLighting = false;
-	ISMC->bAffectDynamicIndirectLighting = false;
-	ISMC->bAffectIndirectLightingWhileHidden = false;
+	FInstancedMeshGroup* Group = InstancedMeshGroups.Find(ComboKey);
+	if (!Group || !Group->ISMC)
+	{
+		// ISMC not yet created - queue for batch addition instead
+		QueueInstanceForBatchAdd(MeshKey, MaterialHash, WorldTransform, Item, Mesh, Material, MaterialColor);
+		return false;
+	}
 
-	// CRITICAL: Disable shadow casting - this was causing 280ms+ Shadow Depths overhead!
-	// Instanced furniture/repeated elements typically don't need per-instance shadows
-	ISMC->SetCastShadow(false);
-	ISMC->bCastDynamicShadow = false;
-	ISMC->bCastStaticShadow = false;
+	UHierarchicalInstancedStaticMeshComponent* ISMC = Group->ISMC;
+	if (!ISMC || !IsValid(ISMC))
+	{
+		UE_LOG(LogFragments, Warning, TEXT("AddInstanceToExistingISMC: HISMC invalid for Mesh=%016llx"), MeshKey);
+		return false;
+	}
 
-	// Store LocalId in custom data for picking support
-	ISMC->NumCustomDataFloats = 1;
+	// Staged: every instance streamed into this group in a frame goes in with one AddInstances call
+	Group->PendingInstances.Add(MakePendingInstance(Item, WorldTransform, MaterialColor));
+	DirtyInstanceGroups.Add(ComboKey);
 
-	// Default: most instanced elements are furniture, not occluders
-	ISMC->bUseAsOccluder = false;
+	return true;
+}
 
-	// Attach and register
-	ISMC->AttachToComponent(ISMCHostActor->GetRootComponent(),
-		FAttachmentTransformRules::KeepRelativeTransform);
-	ISMC->RegisterComponent();
-	ISMCHostActor->AddInstanceComponent(ISMC);
+FFragmentKey UFragmentsImporter::MakeFragmentKey(const FString& ModelGuid, int32 LocalId) const
+{
+	const UFragmentModelWrapper* Wrapper = GetFragmentModel(ModelGuid);
+	return FFragmentKey(Wrapper ? Wrapper->GetContentHash() : 0, LocalId);
+}
 
-	// IMPORTANT: Set material AFTER registration - material overrides don't persist on unregistered components
-	if (Material)
+FPendingInstanceData UFragmentsImporter::MakePendingInstance(const FFragmentItem& Item, const FTransform& WorldTransform, const FColor& Color)
+{
+	UFragmentModelWrapper* Wrapper = GetFragmentModel(Item.ModelGuid);
+	if (!Wrapper)
 	{
-		ISMC->SetMaterial(0, Material);
+		return FPendingInstanceData(WorldTransform, Item.LocalId, INDEX_NONE, 0, Color);
 	}
 
-	// Create and store the group
-	FInstancedMeshGroup Group;
-	Group.ISMC = ISMC;
-	Group.RepresentationId = RepresentationId;
-	Group.MaterialHash = MaterialHash;
-	Group.InstanceCount = 0;
-	InstancedMeshGroups.Add(ComboKey, Group);
+	const uint64 ModelKey = Wrapper->GetContentHash();
+	FFragmentProxyTable& Table = ProxyTables.FindOrAdd(ModelKey);
+	if (Table.ModelGuid.IsEmpty())
+	{
+		Table.ModelGuid = Item.ModelGuid;
+	}
+	return FPendingInstanceData(WorldTransform, Item.LocalId, Wrapper->GetItemIndex(Item.LocalId), ModelKey, Color);
+}
 
-	UE_LOG(LogFragments, Log, TEXT("Created HISMC for RepId=%d, MatHash=%u"), RepresentationId, MaterialHash);
-	return ISMC;
+FFragmentProxy UFragmentsImporter::MakeItemProxy(const FString& ModelGuid, const FFragmentItem& Item) const
+{
+	FFragmentProxy Proxy;
+	Proxy.LocalId = Item.LocalId;
+	Proxy.ModelGuid = ModelGuid;
+	Proxy.GlobalId = Item.Guid;
+	Proxy.Category = Item.Category;
+	Proxy.Attributes = Item.Attributes;
+	Proxy.WorldTransform = Item.GlobalTransform;
+	for (const FFragmentItem* Child : Item.FragmentChildren)
+	{
+		if (Child)
+		{
+			Proxy.ChildLocalIds.Add(Child->LocalId);
+		}
+	}
+	return Proxy;
 }
 
-void UFragmentsImporter::QueueInstanceForBatchAdd(int32 RepresentationId, uint32 MaterialHash,
-	const FTransform& WorldTransform, const FFragmentItem& Item,
-	UStaticMesh* Mesh, UMaterialInstanceDynamic* Material, uint8 MaterialAlpha)
+FFragmentProxy UFragmentsImporter::MakeFragmentProxy(const FFragmentProxyTable& Table, int32 Row) const
 {
-	int64 ComboKey = ((int64)RepresentationId) | ((int64)MaterialHash << 32);
+	const UFragmentModelWrapper* Wrapper = GetFragmentModel(Table.ModelGuid);
+	const FFragmentItem* Item = Wrapper ? Wrapper->GetItemAt(Table.GetItemIndex(Row)) : nullptr;
 
-	// Check if ISMC already exists (from previous incremental finalization)
-	FInstancedMeshGroup* ExistingGroup = InstancedMeshGroups.Find(ComboKey);
-	if (ExistingGroup && ExistingGroup->ISMC != nullptr)
+	FFragmentProxy Proxy = Item ? MakeItemProxy(Table.ModelGuid, *Item) : FFragmentProxy();
+	Proxy.LocalId = Table.GetLocalId(Row);
+	Proxy.ModelGuid = Table.ModelGuid;
+
+	// Hidden fragments have no instance: the item transform stands in
+	const FInstancedMeshGroup* Group = InstancedMeshGroups.Find(Table.GetGroupKey(Row));
+	const int32 InstanceIndex = Table.GetInstanceIndex(Row);
+	if (Group && Group->ISMC && InstanceIndex != INDEX_NONE)
 	{
-		// ISMC already exists - add directly to it instead of queuing
-		// This handles the TileManager streaming case where ISMC was finalized earlier
-		AddInstanceToExistingISMC(RepresentationId, MaterialHash, WorldTransform, Item, Mesh, Material, MaterialAlpha);
-		return;
+		Proxy.ISMC = Group->ISMC;
+		Proxy.InstanceIndex = InstanceIndex;
+		Group->ISMC->GetInstanceTransform(InstanceIndex, Proxy.WorldTransform, /*bWorldSpace=*/true);
 	}
+	return Proxy;
+}
 
-	// Get or create group (but DON'T create ISMC yet - that happens in FinalizeAllISMCs or incrementally)
-	FInstancedMeshGroup& Group = InstancedMeshGroups.FindOrAdd(ComboKey);
+void UFragmentsImporter::TakeVisiblePendingInstances(FInstancedMeshGroup& Group, TArray<FPendingInstanceData>& OutVisible)
+{
+	OutVisible.Reserve(OutVisible.Num() + Group.PendingInstances.Num());
+	for (FPendingInstanceData& Pending : Group.PendingInstances)
+	{
+		if (!StashHiddenInstance(Group, Pending))
+		{
+			OutVisible.Add(MoveTemp(Pending));
+		}
+	}
+	Group.PendingInstances.Reset();
+}
 
-	// Store classification data from first instance (all instances in a group share the same classification)
-	const bool bIsNewGroup = Group.PendingInstances.Num() == 0;
-	if (bIsNewGroup)
+bool UFragmentsImporter::StashHiddenInstance(FInstancedMeshGroup& Group, FPendingInstanceData& Pending)
+{
+	const FFragmentKey Key(Pending.ModelKey, Pending.LocalId);
+	if (!HiddenInstancedFragments.Contains(Key))
 	{
-		Group.FirstCategory = Item.Category;
-		Group.FirstMaterialAlpha = MaterialAlpha;
+		return false;
 	}
 
-	Group.RepresentationId = RepresentationId;
-	Group.MaterialHash = MaterialHash;
-	Group.CachedMesh = Mesh;
-	Group.CachedMaterial = Material;
+	// The proxy row still answers queries about the fragment while it is hidden (no instance yet)
+	if (FFragmentProxyTable* Table = ProxyTables.Find(Pending.ModelKey))
+	{
+		Table->AddRow(Pending.LocalId, Pending.ItemIndex);
+	}
+	Group.HiddenInstances.FindOrAdd(Key).Add(MoveTemp(Pending));
+	return true;
+}
 
-	// Queue the instance data for batch addition later
-	Group.PendingInstances.Emplace(WorldTransform, Item.LocalId, Item.Guid, Item.Category, Item.ModelGuid, Item.Attributes);
-	TotalPendingInstances++;
+void UFragmentsImporter::RegisterGroupInstances(FInstancedMeshGroup& Group, const TArray<FPendingInstanceData>& Instances, const TArray<int32>& NewIndices)
+{
+	UHierarchicalInstancedStaticMeshComponent* ISMC = Group.ISMC;
+	const uint64 GroupKey = MakeInstanceGroupKey(Group.MeshKey, Group.MaterialHash);
 
-	// ==========================================
-	// INCREMENTAL FINALIZATION: Prevent OOM on large models
-	// ==========================================
+	for (int32 i = 0; i < Instances.Num(); i++)
+	{
+		const FPendingInstanceData& Pending = Instances[i];
+		const int32 InstanceIndex = NewIndices.IsValidIndex(i) ? NewIndices[i] : Group.InstanceOwners.Num();
 
-	// Check 1: If this group has too many pending instances, finalize it now
-	if (IncrementalFinalizationThreshold > 0 &&
-		Group.PendingInstances.Num() >= IncrementalFinalizationThreshold)
+		// Store LocalId in custom data
+		ISMC->SetCustomDataValue(InstanceIndex, 0, static_cast<float>(Pending.LocalId), /*bMarkRenderStateDirty=*/false);
+		SetInstanceColor(ISMC, InstanceIndex, Pending.Color, /*bMarkRenderStateDirty=*/false);
+
+		// Selected while hidden, evicted or still queued
+		const FFragmentKey Owner(Pending.ModelKey, Pending.LocalId);
+		if (SelectedFragments.Contains(Owner))
+		{
+			ISMC->SetCustomDataValue(InstanceIndex, GetInstanceSelectionCustomDataIndex(), 1.0f, /*bMarkRenderStateDirty=*/false);
+		}
+
+		// Update lookup maps
+		if (Group.InstanceOwners.Num() <= InstanceIndex)
+		{
+			Group.InstanceOwners.SetNum(InstanceIndex + 1);
+		}
+		Group.InstanceOwners[InstanceIndex] = Owner;
+		Group.InstanceToLocalId.Add(InstanceIndex, Pending.LocalId);
+		Group.LocalIdToInstance.Add(Pending.LocalId, InstanceIndex);
+
+		// Proxy row for the fragment's first instance; a row kept while hidden points back at the HISMC
+		if (FFragmentProxyTable* Table = ProxyTables.Find(Pending.ModelKey))
+		{
+			const int32 Row = Table->AddRow(Pending.LocalId, Pending.ItemIndex);
+			if (Table->GetInstanceIndex(Row) == INDEX_NONE)
+			{
+				Table->SetInstance(Row, GroupKey, InstanceIndex);
+			}
+		}
+	}
+}
+
+int32 UFragmentsImporter::RemoveGroupInstances(FInstancedMeshGroup& Group)
+{
+	UHierarchicalInstancedStaticMeshComponent* ISMC = Group.ISMC;
+
+	TArray<int32> Indices;
+	for (int32 Index = 0; Index < Group.InstanceOwners.Num(); Index++)
 	{
-		UE_LOG(LogFragments, Log, TEXT("Incremental finalization triggered: RepId=%d has %d pending instances (threshold=%d)"),
-			RepresentationId, Group.PendingInstances.Num(), IncrementalFinalizationThreshold);
-		FinalizeISMCGroup(ComboKey, Group);
-		return;
+		if (Group.PendingRemovals.Contains(Group.InstanceOwners[Index]))
+		{
+			Indices.Add(Index);
+		}
+	}
+	if (Indices.Num() == 0)
+	{
+		Group.PendingRemovals.Reset();
+		return 0;
 	}
 
-	// Check 2: If total pending instances exceed the global limit, finalize largest groups
-	if (MaxPendingInstancesTotal > 0 && TotalPendingInstances >= MaxPendingInstancesTotal)
+	// Same order as the HISMC removes them: each removal moves the current last instance into the freed
+	// slot, and descending order guarantees that instance is not one still to be removed
+	Indices.Sort(TGreater<int32>());
+
+	const uint64 GroupKey = MakeInstanceGroupKey(Group.MeshKey, Group.MaterialHash);
+	const int32 NumCustomData = ISMC->NumCustomDataFloats;
+	for (int32 Index : Indices)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("Global pending limit reached: %d instances (limit=%d) - finalizing groups"),
-			TotalPendingInstances, MaxPendingInstancesTotal);
+		const FFragmentKey Owner = Group.InstanceOwners[Index];
+		FFragmentProxyTable* OwnerTable = ProxyTables.Find(Owner.ModelKey);
+		const int32 OwnerRow = OwnerTable ? OwnerTable->FindRow(Owner.LocalId) : INDEX_NONE;
+
+		// Hidden, not evicted: keep what is needed to add the instance back
+		if (Group.PendingRemovals.FindRef(Owner))
+		{
+			FPendingInstanceData& Hidden = Group.HiddenInstances.FindOrAdd(Owner).AddDefaulted_GetRef();
+			ISMC->GetInstanceTransform(Index, Hidden.WorldTransform, /*bWorldSpace=*/true);
+			Hidden.LocalId = Owner.LocalId;
+			Hidden.ItemIndex = OwnerRow != INDEX_NONE ? OwnerTable->GetItemIndex(OwnerRow) : INDEX_NONE;
+			Hidden.ModelKey = Owner.ModelKey;
+			if (bSharedColorMaterialActive && NumCustomData >= InstanceColorCustomDataIndex + 4)
+			{
+				const float* Color = &ISMC->PerInstanceSMCustomData[Index * NumCustomData + InstanceColorCustomDataIndex];
+				Hidden.Color = FLinearColor(Color[0], Color[1], Color[2], Color[3]).ToFColor(/*bSRGB=*/false);
+			}
+		}
+
+		if (const int32* Mapped = Group.LocalIdToInstance.Find(Owner.LocalId))
+		{
+			if (*Mapped == Index)
+			{
+				Group.LocalIdToInstance.Remove(Owner.LocalId);
+			}
+		}
+		if (OwnerRow != INDEX_NONE && OwnerTable->GetGroupKey(OwnerRow) == GroupKey && OwnerTable->GetInstanceIndex(OwnerRow) == Index)
+		{
+			OwnerTable->SetInstance(OwnerRow, GroupKey, INDEX_NONE);
+		}
 
-		// Find and finalize groups with the most pending instances until under limit
-		while (TotalPendingInstances >= MaxPendingInstancesTotal * 0.8) // Target 80% to give headroom
+		const int32 Last = Group.InstanceOwners.Num() - 1;
+		if (Index != Last)
 		{
-			int64 LargestKey = 0;
-			int32 LargestCount = 0;
+			const FFragmentKey Moved = Group.InstanceOwners[Last];
+			Group.InstanceOwners[Index] = Moved;
+			Group.InstanceToLocalId.Add(Index, Moved.LocalId);
 
-			for (auto& Pair : InstancedMeshGroups)
+			if (int32* MovedIndex = Group.LocalIdToInstance.Find(Moved.LocalId))
 			{
-				if (Pair.Value.ISMC == nullptr && Pair.Value.PendingInstances.Num() > LargestCount)
+				if (*MovedIndex == Last)
 				{
-					LargestKey = Pair.Key;
-					LargestCount = Pair.Value.PendingInstances.Num();
+					*MovedIndex = Index;
 				}
 			}
-
-			if (LargestCount == 0)
+			FFragmentProxyTable* MovedTable = ProxyTables.Find(Moved.ModelKey);
+			const int32 MovedRow = MovedTable ? MovedTable->FindRow(Moved.LocalId) : INDEX_NONE;
+			if (MovedRow != INDEX_NONE && MovedTable->GetGroupKey(MovedRow) == GroupKey && MovedTable->GetInstanceIndex(MovedRow) == Last)
 			{
-				break; // No more groups to finalize
+				MovedTable->SetInstance(MovedRow, GroupKey, Index);
 			}
-
-			FInstancedMeshGroup& LargestGroup = InstancedMeshGroups[LargestKey];
-			FinalizeISMCGroup(LargestKey, LargestGroup);
 		}
+		Group.InstanceToLocalId.Remove(Last);
+		Group.InstanceOwners.RemoveAt(Last);
 	}
+
+	ISMC->RemoveInstances(Indices);
+	Group.PendingRemovals.Reset();
+	Group.InstanceCount = Group.InstanceOwners.Num();
+	return Indices.Num();
 }
 
-void UFragmentsImporter::FinalizeAllISMCs()
+void UFragmentsImporter::SetInstancedFragmentHidden(const FString& ModelGuid, int32 LocalId, bool bHidden)
 {
-	if (InstancedMeshGroups.Num() == 0)
+	const FFragmentKey Key = MakeFragmentKey(ModelGuid, LocalId);
+
+	// Tracked even before any instance is queued: samples whose mesh is still building stay hidden on arrival
+	if (bHidden)
+	{
+		bool bAlreadyInSet = false;
+		HiddenInstancedFragments.Add(Key, &bAlreadyInSet);
+		if (bAlreadyInSet)
+		{
+			return;
+		}
+	}
+	else if (HiddenInstancedFragments.Remove(Key) == 0)
 	{
 		return;
 	}
 
-	// Create host actor if needed
-	if (!ISMCHostActor && OwnerRef)
+	const TArray<uint64>* GroupKeys = InstancedFragmentGroups.Find(Key);
+	if (!GroupKeys)
 	{
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.Owner = OwnerRef;
-		ISMCHostActor = OwnerRef->GetWorld()->SpawnActor<AActor>(AActor::StaticClass(),
-			FTransform::Identity, SpawnParams);
-		if (ISMCHostActor)
+		return;
+	}
+
+	for (uint64 ComboKey : *GroupKeys)
+	{
+		FInstancedMeshGroup* Group = InstancedMeshGroups.Find(ComboKey);
+		if (!Group)
+		{
+			continue;
+		}
+
+		// A hide and a show in the same frame cancel out without touching the HISMC
+		if (bHidden)
+		{
+			if (Group->PendingShows.Remove(Key) == 0)
+			{
+				Group->PendingRemovals.Add(Key, true);
+			}
+		}
+		else if (Group->PendingRemovals.Remove(Key) == 0)
 		{
-#if WITH_EDITOR
-			ISMCHostActor->SetActorLabel(TEXT("FragmentISMCHost"));
-#endif
+			Group->PendingShows.Add(Key);
 		}
+		DirtyInstanceGroups.Add(ComboKey);
 	}
+}
 
-	if (!ISMCHostActor)
-	{
-		UE_LOG(LogFragments, Error, TEXT("FinalizeAllISMCs: Failed to create host actor"));
-		return;
-	}
+void UFragmentsImporter::RemoveInstancedFragment(const FString& ModelGuid, int32 LocalId)
+{
+	RemoveInstancedFragment(MakeFragmentKey(ModelGuid, LocalId));
+}
 
-	int32 TotalInstancesAdded = 0;
-	int32 TotalISMCsCreated = 0;
+void UFragmentsImporter::RemoveInstancedFragment(const FFragmentKey& Key)
+{
+	HiddenInstancedFragments.Remove(Key);
 
-	for (auto& Pair : InstancedMeshGroups)
+	// Samples still waiting for their mesh must not be added once it finishes; only the
+	// requests the fragment waits on are visited
+	TArray<uint64, TInlineAllocator<4>> WaitedMeshKeys;
+	WaitingFragmentMeshes.MultiFind(Key, WaitedMeshKeys);
+	for (uint64 MeshKey : WaitedMeshKeys)
 	{
-		FInstancedMeshGroup& Group = Pair.Value;
-
-		// Skip already-finalized groups (from incremental finalization)
-		if (Group.ISMC != nullptr)
+		FMeshBuildRequest* Request = MeshBuildRequests.Find(MeshKey);
+		if (!Request)
 		{
-			UE_LOG(LogFragments, Verbose, TEXT("FinalizeAllISMCs: Skipping already-finalized group RepId=%d (%d instances)"),
-				Group.RepresentationId, Group.InstanceCount);
 			continue;
 		}
 
-		if (Group.PendingInstances.Num() == 0)
+		Request->Waiters.RemoveAll([this, &Key, MeshKey](const FMeshBuildWaiter& Waiter)
 		{
-			continue;
-		}
+			if (!Waiter.bInstanced || !(Waiter.Fragment == Key))
+			{
+				return false;
+			}
+			WaitingFragmentMeshes.RemoveSingle(Key, MeshKey);
+			return true;
+		});
+	}
+
+	TArray<uint64> GroupKeys;
+	if (!InstancedFragmentGroups.RemoveAndCopyValue(Key, GroupKeys))
+	{
+		return;
+	}
 
-		if (!Group.CachedMesh)
+	for (uint64 ComboKey : GroupKeys)
+	{
+		FInstancedMeshGroup* Group = InstancedMeshGroups.Find(ComboKey);
+		if (!Group)
 		{
-			UE_LOG(LogFragments, Warning, TEXT("FinalizeAllISMCs: No cached mesh for RepId=%d"), Group.RepresentationId);
 			continue;
 		}
 
-		// Create HISMC (NOT registered yet - we'll register after adding all instances)
-		// HISMC provides per-cluster culling for better performance
-		UHierarchicalInstancedStaticMeshComponent* ISMC = NewObject<UHierarchicalInstancedStaticMeshComponent>(ISMCHostActor);
-		if (!ISMC)
+		Group->HiddenInstances.Remove(Key);
+		Group->PendingShows.Remove(Key);
+
+		const int32 Removed = Group->PendingInstances.RemoveAll([&Key](const FPendingInstanceData& Pending)
 		{
-			UE_LOG(LogFragments, Error, TEXT("FinalizeAllISMCs: Failed to create HISMC for RepId=%d"), Group.RepresentationId);
+			return Pending.ModelKey == Key.ModelKey && Pending.LocalId == Key.LocalId;
+		});
+		if (!Group->ISMC)
+		{
+			// Queued for a group not finalized yet
+			TotalPendingInstances -= Removed;
+			if (Removed > 0)
+			{
+				Group->PendingRevision++;
+			}
 			continue;
 		}
 
-		ISMC->SetStaticMesh(Group.CachedMesh);
-		ISMC->SetMobility(EComponentMobility::Static);
-
-		// Disable expensive Lumen/Distance Field features
-		ISMC->bAffectDistanceFieldLighting = false;
-		ISMC->bAffectDynamicIndirectLighting = false;
-		ISMC->bAffectIndirectLightingWhileHidden = false;
+		Group->PendingRemovals.Add(Key, false);
+		DirtyInstanceGroups.Add(ComboKey);
+	}
 
-		// Configure occlusion culling based on fragment classification
-		const EOcclusionRole Role = UFragmentOcclusionClassifier::ClassifyFragment(
-			Group.FirstCategory, Group.FirstMaterialAlpha);
+	if (FFragmentProxyTable* Table = ProxyTables.Find(Key.ModelKey))
+	{
+		Table->RemoveRow(Key.LocalId);
+	}
+}
 
-		switch (Role)
-		{
-		case EOcclusionRole::Occluder:
-			// Large structural elements that block visibility
-			ISMC->bUseAsOccluder = true;
-			ISMC->SetCastShadow(true);
-			ISMC->bCastDynamicShadow = true;
-			ISMC->bCastStaticShadow = true;
-			break;
+void UFragmentsImporter::FlushInstanceVisibility()
+{
+	if (DirtyInstanceGroups.Num() == 0)
+	{
+		return;
+	}
 
-		case EOcclusionRole::Occludee:
-			// Objects that can be hidden by occluders
-			ISMC->bUseAsOccluder = false;
-			ISMC->SetCastShadow(true);
-			ISMC->bCastDynamicShadow = true;
-			ISMC->bCastStaticShadow = true;
-			break;
+	int32 TotalRemoved = 0;
+	int32 TotalAdded = 0;
 
-		case EOcclusionRole::NonOccluder:
-			// Transparent/glass elements
-			ISMC->bUseAsOccluder = false;
-			ISMC->SetCastShadow(false);
-			ISMC->bCastDynamicShadow = false;
-			ISMC->bCastStaticShadow = false;
-			break;
+	for (uint64 ComboKey : DirtyInstanceGroups)
+	{
+		FInstancedMeshGroup* Group = InstancedMeshGroups.Find(ComboKey);
+		if (!Group)
+		{
+			continue;
 		}
 
-		// Custom data for picking
-		ISMC->NumCustomDataFloats = 1;
-
-		// Attach to host (still not registered)
-		ISMC->AttachToComponent(ISMCHostActor->GetRootComponent(),
-			FAttachmentTransformRules::KeepRelativeTransform);
-
-		// Build transform array for batch add
-		TArray<FTransform> Transforms;
-		Transforms.Reserve(Group.PendingInstances.Num());
-		for (const FPendingInstanceData& Pending : Group.PendingInstances)
+		UHierarchicalInstancedStaticMeshComponent* ISMC = Group->ISMC;
+		if (!ISMC || !IsValid(ISMC))
 		{
-			Transforms.Add(Pending.WorldTransform);
+			// Nothing in a HISMC yet: FinalizeISMCGroup picks up the pending instances
+			Group->PendingRemovals.Reset();
+			Group->PendingShows.Reset();
+			continue;
 		}
 
-		// BATCH ADD ALL INSTANCES AT ONCE (this is the key optimization!)
-		// This avoids the UE5 per-instance GPU buffer rebuild issue
-		TArray<int32> NewIndices = ISMC->AddInstances(Transforms, /*bShouldReturnIndices=*/true, /*bWorldSpace=*/true);
+		// Removals first so the shown instances are not swapped around
+		TotalRemoved += RemoveGroupInstances(*Group);
 
-		// NOW register the component (after all instances are added)
-		ISMC->RegisterComponent();
-		ISMCHostActor->AddInstanceComponent(ISMC);
-
-		// Set material AFTER registration - material overrides don't persist on unregistered components
-		if (Group.CachedMaterial)
+		TArray<FPendingInstanceData> Added;
+		for (const FFragmentKey& Key : Group->PendingShows)
 		{
-			ISMC->SetMaterial(0, Group.CachedMaterial);
+			TArray<FPendingInstanceData> Hidden;
+			if (Group->HiddenInstances.RemoveAndCopyValue(Key, Hidden))
+			{
+				Added.Append(MoveTemp(Hidden));
+			}
 		}
+		Group->PendingShows.Reset();
+		TakeVisiblePendingInstances(*Group, Added);
 
-		// Set custom data and build lookup maps (after registration, with dirty marking disabled)
-		for (int32 i = 0; i < Group.PendingInstances.Num(); i++)
+		if (Added.Num() > 0)
 		{
-			const FPendingInstanceData& Pending = Group.PendingInstances[i];
-			int32 InstanceIndex = (i < NewIndices.Num()) ? NewIndices[i] : i;
-
-			// Store LocalId in custom data
-			ISMC->SetCustomDataValue(InstanceIndex, 0, static_cast<float>(Pending.LocalId), /*bMarkRenderStateDirty=*/false);
-
-			// Update lookup maps
-			Group.InstanceToLocalId.Add(InstanceIndex, Pending.LocalId);
-			Group.LocalIdToInstance.Add(Pending.LocalId, InstanceIndex);
+			TArray<FTransform> Transforms;
+			Transforms.Reserve(Added.Num());
+			for (const FPendingInstanceData& Pending : Added)
+			{
+				Transforms.Add(Pending.WorldTransform);
+			}
 
-			// Create proxy for this instance
-			FFragmentProxy Proxy;
-			Proxy.ISMC = ISMC;
-			Proxy.InstanceIndex = InstanceIndex;
-			Proxy.LocalId = Pending.LocalId;
-			Proxy.GlobalId = Pending.GlobalId;
-			Proxy.Category = Pending.Category;
-			Proxy.ModelGuid = Pending.ModelGuid;
-			Proxy.Attributes = Pending.Attributes;
-			Proxy.WorldTransform = Pending.WorldTransform;
-			LocalIdToProxyMap.Add(Pending.LocalId, Proxy);
+			TArray<int32> NewIndices = ISMC->AddInstances(Transforms, /*bShouldReturnIndices=*/true, /*bWorldSpace=*/true);
+			RegisterGroupInstances(*Group, Added, NewIndices);
+			Group->InstanceCount = Group->InstanceOwners.Num();
+			TotalAdded += Added.Num();
 		}
 
-		// Mark render state dirty once for all custom data
 		ISMC->MarkRenderStateDirty();
-
-		Group.ISMC = ISMC;
-		Group.InstanceCount = Group.PendingInstances.Num();
-
-		TotalInstancesAdded += Group.PendingInstances.Num();
-		TotalISMCsCreated++;
-
-		// Clear pending instances to free memory
-		Group.PendingInstances.Empty();
-
-		UE_LOG(LogFragments, Log, TEXT("Created ISMC for RepId=%d with %d instances"),
-			Group.RepresentationId, Group.InstanceCount);
 	}
 
-	UE_LOG(LogFragments, Log, TEXT("=== ISMC FINALIZATION COMPLETE: %d ISMCs, %d total instances ==="),
-		TotalISMCsCreated, TotalInstancesAdded);
-
-	// Reset pending counter
-	TotalPendingInstances = 0;
+	UE_LOG(LogFragments, Verbose, TEXT("FlushInstanceVisibility: %d groups, %d instances added, %d removed"),
+		DirtyInstanceGroups.Num(), TotalAdded, TotalRemoved);
+	DirtyInstanceGroups.Reset();
 }
 
-int32 UFragmentsImporter::FinalizeISMCGroup(int64 ComboKey, FInstancedMeshGroup& Group)
+FFindResult UFragmentsImporter::FindFragmentByLocalIdUnified(int32 LocalId, const FString& ModelGuid)
 {
-	// Skip if already finalized or no pending instances
-	if (Group.ISMC != nullptr || Group.PendingInstances.Num() == 0)
+	// Check the model's proxy table first (instanced fragments)
+	if (const UFragmentModelWrapper* Wrapper = GetFragmentModel(ModelGuid))
 	{
-		return 0;
+		if (const FFragmentProxyTable* Table = ProxyTables.Find(Wrapper->GetContentHash()))
+		{
+			const int32 Row = Table->FindRow(LocalId);
+			if (Row != INDEX_NONE)
+			{
+				return FFindResult::FromProxy(MakeFragmentProxy(*Table, Row));
+			}
+		}
 	}
 
-	// Ensure host actor exists
-	if (!ISMCHostActor && OwnerRef)
+	// Check actor map (non-instanced fragments)
+	if (FFragmentLookup* Lookup = ModelFragmentsMap.Find(ModelGuid))
 	{
-		FActorSpawnParameters SpawnParams;
-		SpawnParams.Owner = OwnerRef;
-		ISMCHostActor = OwnerRef->GetWorld()->SpawnActor<AActor>(AActor::StaticClass(),
-			FTransform::Identity, SpawnParams);
-		if (ISMCHostActor)
+		if (AFragment** Actor = Lookup->Fragments.Find(LocalId))
 		{
-#if WITH_EDITOR
-			ISMCHostActor->SetActorLabel(TEXT("FragmentISMCHost"));
-#endif
+			if (*Actor)
+			{
+				return FFindResult::FromActor(*Actor);
+			}
 		}
 	}
 
-	if (!ISMCHostActor)
+	return FFindResult::NotFound();
+}
+
+FFindResult UFragmentsImporter::PickFragment(const FHitResult& Hit)
+{
+	const UPrimitiveComponent* Component = Hit.GetComponent();
+	if (!Component)
 	{
-		UE_LOG(LogFragments, Error, TEXT("FinalizeISMCGroup: Failed to create host actor"));
-		return -1;
+		return FFindResult::NotFound();
 	}
 
-	if (!Group.CachedMesh)
+	if (ISMCGroupKeys.Contains(Component))
 	{
-		UE_LOG(LogFragments, Warning, TEXT("FinalizeISMCGroup: No cached mesh for RepId=%d"), Group.RepresentationId);
-		return -1;
+		return PickInstancedFragment(Component, Hit.Item);
 	}
 
-	// Create HISMC (NOT registered yet - we'll register after adding all instances)
-	// HISMC provides per-cluster culling for better performance
-	UHierarchicalInstancedStaticMeshComponent* ISMC = NewObject<UHierarchicalInstancedStaticMeshComponent>(ISMCHostActor);
-	if (!ISMC)
+	// Sample components are attached to their fragment actor
+	if (AFragment* FragmentActor = Cast<AFragment>(Component->GetOwner()))
 	{
-		UE_LOG(LogFragments, Error, TEXT("FinalizeISMCGroup: Failed to create HISMC for RepId=%d"), Group.RepresentationId);
-		return -1;
+		return FFindResult::FromActor(FragmentActor);
 	}
 
-	ISMC->SetStaticMesh(Group.CachedMesh);
-	ISMC->SetMobility(EComponentMobility::Static);
-
-	// Disable expensive Lumen/Distance Field features
-	ISMC->bAffectDistanceFieldLighting = false;
-	ISMC->bAffectDynamicIndirectLighting = false;
-	ISMC->bAffectIndirectLightingWhileHidden = false;
-
-	// Configure occlusion culling based on fragment classification
-	const EOcclusionRole Role = UFragmentOcclusionClassifier::ClassifyFragment(
-		Group.FirstCategory, Group.FirstMaterialAlpha);
-
-	switch (Role)
+	// Merged tile meshes: the hit triangle maps back to its fragment
+	for (const TPair<FString, UFragmentTileManager*>& Pair : TileManagers)
 	{
-	case EOcclusionRole::Occluder:
-		// Large structural elements that block visibility
-		ISMC->bUseAsOccluder = true;
-		ISMC->SetCastShadow(true);
-		ISMC->bCastDynamicShadow = true;
-		ISMC->bCastStaticShadow = true;
-		break;
-
-	case EOcclusionRole::Occludee:
-		// Objects that can be hidden by occluders
-		ISMC->bUseAsOccluder = false;
-		ISMC->SetCastShadow(true);
-		ISMC->bCastDynamicShadow = true;
-		ISMC->bCastStaticShadow = true;
-		break;
+		const int32 LocalId = Pair.Value ? Pair.Value->FindMergedFragmentAtFace(Component, Hit.FaceIndex) : INDEX_NONE;
+		if (LocalId == INDEX_NONE)
+		{
+			continue;
+		}
 
-	case EOcclusionRole::NonOccluder:
-		// Transparent/glass elements
-		ISMC->bUseAsOccluder = false;
-		ISMC->SetCastShadow(false);
-		ISMC->bCastDynamicShadow = false;
-		ISMC->bCastStaticShadow = false;
+		if (const FFragmentItem* Item = GetFragmentItemByLocalId(LocalId, Pair.Key))
+		{
+			return FFindResult::FromProxy(MakeItemProxy(Pair.Key, *Item));
+		}
 		break;
 	}
 
-	// Custom data for picking
-	ISMC->NumCustomDataFloats = 1;
-
-	// Attach to host (still not registered)
-	ISMC->AttachToComponent(ISMCHostActor->GetRootComponent(),
-		FAttachmentTransformRules::KeepRelativeTransform);
+	return FFindResult::NotFound();
+}
 
-	// Build transform array for batch add
-	TArray<FTransform> Transforms;
-	Transforms.Reserve(Group.PendingInstances.Num());
-	for (const FPendingInstanceData& Pending : Group.PendingInstances)
+FFindResult UFragmentsImporter::PickInstancedFragment(const UPrimitiveComponent* Component, int32 InstanceIndex)
+{
+	const uint64* GroupKey = ISMCGroupKeys.Find(Component);
+	const FInstancedMeshGroup* Group = GroupKey ? InstancedMeshGroups.Find(*GroupKey) : nullptr;
+	if (!Group || !Group->ISMC || !Group->InstanceOwners.IsValidIndex(InstanceIndex))
 	{
-		Transforms.Add(Pending.WorldTransform);
+		return FFindResult::NotFound();
 	}
 
-	// BATCH ADD ALL INSTANCES AT ONCE
-	TArray<int32> NewIndices = ISMC->AddInstances(Transforms, /*bShouldReturnIndices=*/true, /*bWorldSpace=*/true);
-
-	// NOW register the component (after all instances are added)
-	ISMC->RegisterComponent();
-	ISMCHostActor->AddInstanceComponent(ISMC);
-
-	// Set material AFTER registration - material overrides don't persist on unregistered components
-	if (Group.CachedMaterial)
+	const FFragmentKey& Owner = Group->InstanceOwners[InstanceIndex];
+	const FFragmentProxyTable* Table = ProxyTables.Find(Owner.ModelKey);
+	const int32 Row = Table ? Table->FindRow(Owner.LocalId) : INDEX_NONE;
+	if (Row == INDEX_NONE)
 	{
-		ISMC->SetMaterial(0, Group.CachedMaterial);
+		UE_LOG(LogFragments, Warning, TEXT("PickInstancedFragment: Instance %d of Mesh=%016llx has no proxy row (LocalId %d)"),
+			InstanceIndex, Group->MeshKey, Owner.LocalId);
+		return FFindResult::NotFound();
 	}
 
-	// Set custom data and build lookup maps
-	for (int32 i = 0; i < Group.PendingInstances.Num(); i++)
+	// The row points at the fragment's first instance; report the one that was hit
+	FFragmentProxy Proxy = MakeFragmentProxy(*Table, Row);
+	Proxy.ISMC = Group->ISMC;
+	Proxy.InstanceIndex = InstanceIndex;
+	Group->ISMC->GetInstanceTransform(InstanceIndex, Proxy.WorldTransform, /*bWorldSpace=*/true);
+	return FFindResult::FromProxy(Proxy);
+}
+
+int32 UFragmentsImporter::SetFragmentsSelected(const FString& ModelGuid, const TArray<int32>& LocalIds, bool bSelected)
+{
+	const UFragmentModelWrapper* Wrapper = GetFragmentModel(ModelGuid);
+	if (!Wrapper)
 	{
-		const FPendingInstanceData& Pending = Group.PendingInstances[i];
-		int32 InstanceIndex = (i < NewIndices.Num()) ? NewIndices[i] : i;
+		UE_LOG(LogFragments, Warning, TEXT("SetFragmentsSelected: Model %s is not loaded"), *ModelGuid);
+		return 0;
+	}
 
-		// Store LocalId in custom data
-		ISMC->SetCustomDataValue(InstanceIndex, 0, static_cast<float>(Pending.LocalId), /*bMarkRenderStateDirty=*/false);
+	const uint64 ModelKey = Wrapper->GetContentHash();
+	const FFragmentLookup* Lookup = ModelFragmentsMap.Find(ModelGuid);
+	UFragmentTileManager* TileManager = TileManagers.FindRef(ModelGuid);
 
-		// Update lookup maps
-		Group.InstanceToLocalId.Add(InstanceIndex, Pending.LocalId);
-		Group.LocalIdToInstance.Add(Pending.LocalId, InstanceIndex);
+	// Changed fragments per instanced group, so each group is walked and updated once
+	TMap<uint64, TSet<FFragmentKey>> ChangedPerGroup;
+	int32 Changed = 0;
 
-		// Create proxy for this instance
-		FFragmentProxy Proxy;
-		Proxy.ISMC = ISMC;
-		Proxy.InstanceIndex = InstanceIndex;
-		Proxy.LocalId = Pending.LocalId;
-		Proxy.GlobalId = Pending.GlobalId;
-		Proxy.Category = Pending.Category;
-		Proxy.ModelGuid = Pending.ModelGuid;
-		Proxy.Attributes = Pending.Attributes;
-		Proxy.WorldTransform = Pending.WorldTransform;
-		LocalIdToProxyMap.Add(Pending.LocalId, Proxy);
-	}
+	for (int32 LocalId : LocalIds)
+	{
+		const FFragmentKey Key(ModelKey, LocalId);
+		bool bAlreadySet = false;
+		if (bSelected)
+		{
+			SelectedFragments.Add(Key, &bAlreadySet);
+		}
+		else
+		{
+			bAlreadySet = SelectedFragments.Remove(Key) == 0;
+		}
+		if (bAlreadySet)
+		{
+			continue;
+		}
+		Changed++;
 
-	// Mark render state dirty once for all custom data
-	ISMC->MarkRenderStateDirty();
+		if (const TArray<uint64>* GroupKeys = InstancedFragmentGroups.Find(Key))
+		{
+			for (uint64 GroupKey : *GroupKeys)
+			{
+				ChangedPerGroup.FindOrAdd(GroupKey).Add(Key);
+			}
+		}
 
-	Group.ISMC = ISMC;
-	int32 InstancesAdded = Group.PendingInstances.Num();
-	Group.InstanceCount = InstancesAdded;
+		AFragment* const* FragmentActor = Lookup ? Lookup->Fragments.Find(LocalId) : nullptr;
+		if (FragmentActor && *FragmentActor)
+		{
+			SetActorSelectionFlag(*FragmentActor, bSelected);
+		}
 
-	// Update pending counter
-	TotalPendingInstances -= InstancesAdded;
-	TotalPendingInstances = FMath::Max(0, TotalPendingInstances);
+		// Box proxies and merged tile meshes
+		if (TileManager)
+		{
+			TileManager->SetFragmentSelected(LocalId, bSelected);
+		}
+	}
 
-	// Clear pending instances to free memory
-	Group.PendingInstances.Empty();
-	Group.PendingInstances.Shrink();  // Release allocated memory
+	// Instances not in a HISMC yet (queued or hidden) get the flag when they are added
+	const int32 FlagIndex = GetInstanceSelectionCustomDataIndex();
+	const float Flag = bSelected ? 1.0f : 0.0f;
+	for (const TPair<uint64, TSet<FFragmentKey>>& Pair : ChangedPerGroup)
+	{
+		FInstancedMeshGroup* Group = InstancedMeshGroups.Find(Pair.Key);
+		UHierarchicalInstancedStaticMeshComponent* ISMC = Group ? Group->ISMC : nullptr;
+		if (!ISMC || ISMC->NumCustomDataFloats <= FlagIndex)
+		{
+			continue;
+		}
 
-	UE_LOG(LogFragments, Log, TEXT("FinalizeISMCGroup: Created ISMC for RepId=%d with %d instances (incremental)"),
-		Group.RepresentationId, InstancesAdded);
+		for (int32 Index = 0; Index < Group->InstanceOwners.Num(); Index++)
+		{
+			if (Pair.Value.Contains(Group->InstanceOwners[Index]))
+			{
+				ISMC->SetCustomDataValue(Index, FlagIndex, Flag, /*bMarkRenderStateDirty=*/false);
+			}
+		}
+		ISMC->MarkRenderStateDirty();
+	}
 
-	return InstancesAdded;
+	UE_LOG(LogFragments, Verbose, TEXT("SetFragmentsSelected: %d fragments %s, %d instanced groups updated"),
+		Changed, bSelected ? TEXT("selected") : TEXT("deselected"), ChangedPerGroup.Num());
+	return Changed;
 }
 
-bool UFragmentsImporter::AddInstanceToExistingISMC(int32 RepresentationId, uint32 MaterialHash,
-	const FTransform& WorldTransform, const FFragmentItem& Item,
-	UStaticMesh* Mesh, UMaterialInstanceDynamic* Material, uint8 MaterialAlpha)
+void UFragmentsImporter::ClearFragmentSelection()
 {
-	int64 ComboKey = ((int64)RepresentationId) | ((int64)MaterialHash << 32);
-
-	FInstancedMeshGroup* Group = InstancedMeshGroups.Find(ComboKey);
-	if (!Group || !Group->ISMC)
+	if (SelectedFragments.Num() == 0)
 	{
-		// ISMC not yet created - queue for batch addition instead
-		QueueInstanceForBatchAdd(RepresentationId, MaterialHash, WorldTransform, Item, Mesh, Material, MaterialAlpha);
-		return false;
+		return;
 	}
 
-	UHierarchicalInstancedStaticMeshComponent* ISMC = Group->ISMC;
-	if (!ISMC || !IsValid(ISMC))
+	TMap<uint64, TArray<int32>> SelectedPerModel;
+	for (const FFragmentKey& Key : SelectedFragments)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("AddInstanceToExistingISMC: HISMC invalid for RepId=%d"), RepresentationId);
-		return false;
+		SelectedPerModel.FindOrAdd(Key.ModelKey).Add(Key.LocalId);
 	}
 
-	// Add single instance to existing HISMC
-	// Note: This is less efficient than batch add, but necessary for streaming
-	int32 NewIndex = ISMC->AddInstance(WorldTransform, /*bWorldSpace=*/true);
-	if (NewIndex == INDEX_NONE)
+	for (const TPair<FString, UFragmentModelWrapper*>& Pair : FragmentModels)
 	{
-		UE_LOG(LogFragments, Warning, TEXT("AddInstanceToExistingISMC: Failed to add instance for RepId=%d"), RepresentationId);
-		return false;
+		if (const TArray<int32>* LocalIds = Pair.Value ? SelectedPerModel.Find(Pair.Value->GetContentHash()) : nullptr)
+		{
+			SetFragmentsSelected(Pair.Key, *LocalIds, false);
+		}
 	}
+	SelectedFragments.Reset();
+}
 
-	// Set custom data
-	ISMC->SetCustomDataValue(NewIndex, 0, static_cast<float>(Item.LocalId), /*bMarkRenderStateDirty=*/true);
-
-	// Update lookup maps
-	Group->InstanceToLocalId.Add(NewIndex, Item.LocalId);
-	Group->LocalIdToInstance.Add(Item.LocalId, NewIndex);
-	Group->InstanceCount++;
-
-	// Create proxy
-	FFragmentProxy Proxy;
-	Proxy.ISMC = ISMC;
-	Proxy.InstanceIndex = NewIndex;
-	Proxy.LocalId = Item.LocalId;
-	Proxy.GlobalId = Item.Guid;
-	Proxy.Category = Item.Category;
-	Proxy.ModelGuid = Item.ModelGuid;
-	Proxy.Attributes = Item.Attributes;
-	Proxy.WorldTransform = WorldTransform;
-	LocalIdToProxyMap.Add(Item.LocalId, Proxy);
-
-	return true;
+bool UFragmentsImporter::IsFragmentSelected(const FString& ModelGuid, int32 LocalId) const
+{
+	return SelectedFragments.Contains(MakeFragmentKey(ModelGuid, LocalId));
 }
 
-FFindResult UFragmentsImporter::FindFragmentByLocalIdUnified(int32 LocalId, const FString& ModelGuid)
+void UFragmentsImporter::SetFragmentsHidden(const FString& ModelGuid, const TArray<int32>& LocalIds, bool bHidden)
 {
-	// Check proxy map first (instanced fragments)
-	if (FFragmentProxy* Proxy = LocalIdToProxyMap.Find(LocalId))
+	UFragmentTileManager* TileManager = TileManagers.FindRef(ModelGuid);
+	if (!TileManager)
 	{
-		if (Proxy->ModelGuid == ModelGuid)
-		{
-			return FFindResult::FromProxy(*Proxy);
-		}
+		UE_LOG(LogFragments, Warning, TEXT("SetFragmentsHidden: Model %s is not loaded"), *ModelGuid);
+		return;
 	}
 
-	// Check actor map (non-instanced fragments)
-	if (FFragmentLookup* Lookup = ModelFragmentsMap.Find(ModelGuid))
+	for (int32 LocalId : LocalIds)
 	{
-		if (AFragment** Actor = Lookup->Fragments.Find(LocalId))
-		{
-			if (*Actor)
-			{
-				return FFindResult::FromActor(*Actor);
-			}
-		}
+		TileManager->SetFragmentHidden(LocalId, bHidden);
 	}
 
-	return FFindResult::NotFound();
-}
\ No newline at end of file
+	// Instances hidden above leave their HISMCs in one update per group
+	FlushInstanceVisibility();
+}
+
+void UFragmentsImporter::SetActorSelectionFlag(AFragment* FragmentActor, bool bSelected) const
+{
+	const int32 FlagIndex = GetInstanceSelectionCustomDataIndex();
+	TInlineComponentArray<UStaticMeshComponent*> MeshComponents(FragmentActor);
+	for (UStaticMeshComponent* MeshComp : MeshComponents)
+	{
+		MeshComp->SetCustomPrimitiveDataFloat(FlagIndex, bSelected ? 1.0f : 0.0f);
+	}
+}
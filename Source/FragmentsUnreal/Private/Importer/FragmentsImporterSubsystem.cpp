@@ -53,6 +53,13 @@ TArray<int32> UFragmentsImporterSubsystem::GetElementsByCategory(const FString&
     return Importer->GetElementsByCategory(InCategory, ModelGuid);
 }
 
+FString UFragmentsImporterSubsystem::BenchmarkTriangulation(const FString& ModelGuid, int32 Iterations)
+{
+    check(Importer);
+
+    return Importer->BenchmarkTriangulation(ModelGuid, Iterations);
+}
+
 FFragmentItem* UFragmentsImporterSubsystem::GetFragmentItemByLocalId(int32 InLocalId, const FString& InModelGuid)
 {
     check(Importer);
@@ -60,9 +60,8 @@ uint32 UDynamicTileGenerator::ComputeTileId(int32 MaterialIndex, EFragmentLod Lo
 {
 	// Port of engine_fragment's CRC tile ID generation
 	// Snap center to grid, then hash (material, lod, grid coords)
-	// Note: Wires LOD removed, always use geometry tile dimension
 
-	const float TileDim = GeometryTileDimension;
+	const float TileDim = (Lod == EFragmentLod::Wires) ? WiresTileDimension : GeometryTileDimension;
 
 	// Snap to grid (in cm, then convert to integer grid coords)
 	// Use floor to ensure consistent grid cell assignment
@@ -102,6 +101,7 @@ void UDynamicTileGenerator::GenerateTiles(const TArray<FFragmentVisibilityResult
 	Tiles.Empty();
 	FragmentToTileId.Empty();
 	AllTiledFragments.Empty();
+	WiresFragments.Empty();
 
 	if (!Registry || VisibleSamples.Num() == 0)
 	{
@@ -151,7 +151,14 @@ void UDynamicTileGenerator::GenerateTiles(const TArray<FFragmentVisibilityResult
 
 		// Track fragment -> tile mapping
 		FragmentToTileId.Add(Sample.LocalId, TileId);
-		AllTiledFragments.Add(Sample.LocalId);
+		if (Sample.LodLevel == EFragmentLod::Wires)
+		{
+			WiresFragments.Add(Sample.LocalId);
+		}
+		else
+		{
+			AllTiledFragments.Add(Sample.LocalId);
+		}
 	}
 
 	const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
@@ -0,0 +1,232 @@
+#include "Spatial/FragmentProxyBoxRenderer.h"
+#include "Spatial/FragmentRegistry.h"
+#include "Importer/FragmentsImporter.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Algo/BinarySearch.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFragmentProxyBoxes, Log, All);
+
+UFragmentProxyBoxRenderer::UFragmentProxyBoxRenderer()
+{
+}
+
+void UFragmentProxyBoxRenderer::Initialize(UFragmentsImporter* InImporter, UFragmentRegistry* InRegistry)
+{
+	Importer = InImporter;
+	Registry = InRegistry;
+
+	BoxMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (!BoxMesh)
+	{
+		UE_LOG(LogFragmentProxyBoxes, Warning, TEXT("Initialize: Failed to load cube mesh, box proxies disabled"));
+	}
+}
+
+void UFragmentProxyBoxRenderer::UpdateBoxes(const TSet<int32>& BoxFragments)
+{
+	if (!Registry || !BoxMesh)
+	{
+		return;
+	}
+
+	// Group the requested fragments by color
+	TMap<uint32, TArray<int32>> NewGroups;
+	TMap<uint32, FColor> GroupColors;
+	for (int32 LocalId : BoxFragments)
+	{
+		const FFragmentVisibilityData* Data = Registry->FindFragment(LocalId);
+		if (!Data || !Data->WorldBounds.IsValid)
+		{
+			continue;
+		}
+
+		const uint32 Key = Data->MaterialColor.ToPackedARGB();
+		NewGroups.FindOrAdd(Key).Add(LocalId);
+		GroupColors.Add(Key, Data->MaterialColor);
+	}
+
+	// Empty batches whose color is no longer drawn (components are kept for reuse)
+	for (TPair<uint32, FFragmentProxyBoxBatch>& Pair : Batches)
+	{
+		if (!NewGroups.Contains(Pair.Key) && Pair.Value.LocalIds.Num() > 0)
+		{
+			if (Pair.Value.Component)
+			{
+				Pair.Value.Component->ClearInstances();
+			}
+			Pair.Value.LocalIds.Reset();
+		}
+	}
+
+	const FVector BoxMeshSize = BoxMesh->GetBounds().BoxExtent * 2.0;
+	int32 RebuiltBatches = 0;
+
+	for (TPair<uint32, TArray<int32>>& Pair : NewGroups)
+	{
+		TArray<int32>& LocalIds = Pair.Value;
+		LocalIds.Sort();
+
+		FFragmentProxyBoxBatch& Batch = Batches.FindOrAdd(Pair.Key);
+		if (Batch.Component && Batch.LocalIds == LocalIds)
+		{
+			continue;
+		}
+
+		if (!Batch.Component)
+		{
+			Batch.Color = GroupColors[Pair.Key];
+			Batch.Component = CreateBatchComponent(Batch.Color);
+			if (!Batch.Component)
+			{
+				continue;
+			}
+		}
+
+		// Flat fragments still get a sliver of thickness so the box stays visible
+		TArray<FTransform> Transforms;
+		Transforms.Reserve(LocalIds.Num());
+		for (int32 LocalId : LocalIds)
+		{
+			const FBox& Bounds = Registry->FindFragment(LocalId)->WorldBounds;
+			const FVector Scale = Bounds.GetSize().ComponentMax(FVector(1.0)) / BoxMeshSize;
+			Transforms.Add(FTransform(FQuat::Identity, Bounds.GetCenter(), Scale));
+		}
+
+		Batch.Component->ClearInstances();
+		Batch.Component->AddInstances(Transforms, /*bShouldReturnIndices=*/false, /*bWorldSpace=*/true);
+
+		// Store LocalId in custom data for picking support (same layout as the HISMC groups)
+		const int32 SelectionIndex = Importer->GetInstanceSelectionCustomDataIndex();
+		for (int32 InstanceIndex = 0; InstanceIndex < LocalIds.Num(); InstanceIndex++)
+		{
+			Batch.Component->SetCustomDataValue(InstanceIndex, 0, static_cast<float>(LocalIds[InstanceIndex]), /*bMarkRenderStateDirty=*/false);
+			Importer->SetInstanceColor(Batch.Component, InstanceIndex, Batch.Color, /*bMarkRenderStateDirty=*/false);
+			if (SelectedFragments.Contains(LocalIds[InstanceIndex]))
+			{
+				Batch.Component->SetCustomDataValue(InstanceIndex, SelectionIndex, 1.0f, /*bMarkRenderStateDirty=*/false);
+			}
+		}
+		Batch.Component->MarkRenderStateDirty();
+
+		Batch.LocalIds = MoveTemp(LocalIds);
+		RebuiltBatches++;
+	}
+
+	if (RebuiltBatches > 0)
+	{
+		UE_LOG(LogFragmentProxyBoxes, Verbose, TEXT("Rebuilt %d box batches, %d boxes in %d batches"),
+		       RebuiltBatches, GetBoxCount(), Batches.Num());
+	}
+}
+
+void UFragmentProxyBoxRenderer::SetFragmentSelected(int32 LocalId, bool bSelected)
+{
+	if (bSelected)
+	{
+		SelectedFragments.Add(LocalId);
+	}
+	else
+	{
+		SelectedFragments.Remove(LocalId);
+	}
+
+	// Boxes are batched by color: only the fragment's own batch can hold it
+	const FFragmentVisibilityData* Data = Registry ? Registry->FindFragment(LocalId) : nullptr;
+	FFragmentProxyBoxBatch* Batch = Data ? Batches.Find(Data->MaterialColor.ToPackedARGB()) : nullptr;
+	const int32 InstanceIndex = Batch ? Algo::BinarySearch(Batch->LocalIds, LocalId) : INDEX_NONE;
+	if (InstanceIndex == INDEX_NONE || !Batch->Component)
+	{
+		return;
+	}
+
+	Batch->Component->SetCustomDataValue(InstanceIndex, Importer->GetInstanceSelectionCustomDataIndex(),
+		bSelected ? 1.0f : 0.0f, /*bMarkRenderStateDirty=*/true);
+}
+
+void UFragmentProxyBoxRenderer::Clear()
+{
+	for (TPair<uint32, FFragmentProxyBoxBatch>& Pair : Batches)
+	{
+		if (Pair.Value.Component)
+		{
+			Importer->ReleaseComponentResources(Pair.Value.Component);
+			Pair.Value.Component->DestroyComponent();
+		}
+	}
+	Batches.Empty();
+
+	if (HostActor)
+	{
+		HostActor->Destroy();
+		HostActor = nullptr;
+	}
+}
+
+int32 UFragmentProxyBoxRenderer::GetBoxCount() const
+{
+	int32 Count = 0;
+	for (const TPair<uint32, FFragmentProxyBoxBatch>& Pair : Batches)
+	{
+		Count += Pair.Value.LocalIds.Num();
+	}
+	return Count;
+}
+
+UInstancedStaticMeshComponent* UFragmentProxyBoxRenderer::CreateBatchComponent(const FColor& Color)
+{
+	if (!Importer)
+	{
+		return nullptr;
+	}
+
+	// Create host actor if needed (one actor holds every batch of this model)
+	if (!HostActor)
+	{
+		AActor* OwnerActor = Importer->GetOwnerRef();
+		UWorld* World = OwnerActor ? OwnerActor->GetWorld() : nullptr;
+		if (!World)
+		{
+			return nullptr;
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = OwnerActor;
+		HostActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!HostActor)
+		{
+			UE_LOG(LogFragmentProxyBoxes, Warning, TEXT("CreateBatchComponent: Failed to create host actor"));
+			return nullptr;
+		}
+
+		USceneComponent* Root = NewObject<USceneComponent>(HostActor);
+		HostActor->SetRootComponent(Root);
+		Root->RegisterComponent();
+
+#if WITH_EDITOR
+		HostActor->SetActorLabel(TEXT("FragmentProxyBoxHost"));
+#endif
+	}
+
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(HostActor);
+	Component->SetStaticMesh(BoxMesh);
+	Component->SetMobility(EComponentMobility::Movable);
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	// Boxes stand in for far, small fragments: no shadows, distance fields or occlusion
+	Component->SetCastShadow(false);
+	Component->bAffectDistanceFieldLighting = false;
+	Component->bAffectDynamicIndirectLighting = false;
+	Component->bUseAsOccluder = false;
+	Component->NumCustomDataFloats = Importer->GetInstanceCustomDataFloats();
+
+	Component->AttachToComponent(HostActor->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	Component->RegisterComponent();
+	HostActor->AddInstanceComponent(Component);
+
+	// Set material AFTER registration - material overrides don't persist on unregistered components
+	Importer->ApplyColorMaterial(Component, Color);
+
+	return Component;
+}
@@ -3,9 +3,54 @@
 #include "Utils/FragmentsUtils.h"
 #include "Utils/FragmentOcclusionClassifier.h"
 #include "Index/index_generated.h"
+#include <cmath>
 
 DEFINE_LOG_CATEGORY_STATIC(LogFragmentRegistry, Log, All);
 
+namespace
+{
+	/** Largest float not above V (lower bounds must not shrink when narrowed) */
+	float FloatBelow(double V)
+	{
+		const float F = static_cast<float>(V);
+		return static_cast<double>(F) > V ? std::nextafter(F, -MAX_flt) : F;
+	}
+
+	/** Smallest float not below V */
+	float FloatAbove(double V)
+	{
+		const float F = static_cast<float>(V);
+		return static_cast<double>(F) < V ? std::nextafter(F, MAX_flt) : F;
+	}
+}
+
+void FFragmentCullingData::Add(const FFragmentVisibilityData& Data)
+{
+	const FBox& Box = Data.WorldBounds;
+	BoundsMin.Add(FVector3f(FloatBelow(Box.Min.X), FloatBelow(Box.Min.Y), FloatBelow(Box.Min.Z)));
+	BoundsMax.Add(FVector3f(FloatAbove(Box.Max.X), FloatAbove(Box.Max.Y), FloatAbove(Box.Max.Z)));
+	MaxDimensions.Add(Data.MaxDimension);
+	LocalIds.Add(Data.LocalId);
+	MaterialIndices.Add(Data.MaterialIndex);
+	Flags.Add(Data.bIsSmallObject ? EFragmentCullFlags::SmallObject : EFragmentCullFlags::None);
+}
+
+void FFragmentCullingData::Reset()
+{
+	BoundsMin.Reset();
+	BoundsMax.Reset();
+	MaxDimensions.Reset();
+	LocalIds.Reset();
+	MaterialIndices.Reset();
+	Flags.Reset();
+}
+
+SIZE_T FFragmentCullingData::GetAllocatedSize() const
+{
+	return BoundsMin.GetAllocatedSize() + BoundsMax.GetAllocatedSize() + MaxDimensions.GetAllocatedSize()
+		+ LocalIds.GetAllocatedSize() + MaterialIndices.GetAllocatedSize() + Flags.GetAllocatedSize();
+}
+
 UFragmentRegistry::UFragmentRegistry()
 	: WorldBounds(ForceInit)
 	, bIsBuilt(false)
@@ -40,7 +85,7 @@ void UFragmentRegistry::BuildFromModel(const UFragmentModelWrapper* ModelWrapper
 	const FFragmentItem& RootItem = ModelWrapper->GetModelItemRef();
 	CollectFragmentData(RootItem, ParsedModel);
 
-	// Calculate combined world bounds
+	// Calculate combined world bounds and the hot culling arrays
 	for (const FFragmentVisibilityData& Data : Fragments)
 	{
 		if (Data.WorldBounds.IsValid)
@@ -48,6 +93,7 @@ void UFragmentRegistry::BuildFromModel(const UFragmentModelWrapper* ModelWrapper
 			WorldBounds += Data.WorldBounds;
 		}
 	}
+	RebuildCullingData();
 
 	const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
 
@@ -63,6 +109,23 @@ void UFragmentRegistry::BuildFromModel(const UFragmentModelWrapper* ModelWrapper
 	       GetMemoryUsage() / 1024);
 }
 
+void UFragmentRegistry::PostLoad()
+{
+	Super::PostLoad();
+
+	// Only Fragments is serialized: derive the hot arrays from it again
+	RebuildCullingData();
+}
+
+void UFragmentRegistry::RebuildCullingData()
+{
+	CullingData.Reset();
+	for (const FFragmentVisibilityData& Data : Fragments)
+	{
+		CullingData.Add(Data);
+	}
+}
+
 void UFragmentRegistry::CollectFragmentData(const FFragmentItem& Item, const Model* ParsedModel)
 {
 	// Only process fragments with valid LocalId and at least one sample (representation)
@@ -77,6 +140,7 @@ void UFragmentRegistry::CollectFragmentData(const FFragmentItem& Item, const Mod
 		bool bHasValidBounds = false;
 		int32 PrimaryMaterialIndex = 0;
 		uint8 PrimaryMaterialAlpha = 255;  // Default to fully opaque
+		FColor PrimaryMaterialColor = FColor::White;
 
 		// Iterate through all samples (representations) for this fragment
 		for (const FFragmentSample& Sample : Item.Samples)
@@ -125,6 +189,7 @@ void UFragmentRegistry::CollectFragmentData(const FFragmentItem& Item, const Mod
 					if (Mat)
 					{
 						PrimaryMaterialAlpha = Mat->a();
+						PrimaryMaterialColor = FColor(Mat->r(), Mat->g(), Mat->b(), Mat->a());
 					}
 				}
 			}
@@ -177,6 +242,7 @@ void UFragmentRegistry::CollectFragmentData(const FFragmentItem& Item, const Mod
 			// Store material index and alpha
 			VisData.MaterialIndex = PrimaryMaterialIndex;
 			VisData.MaterialAlpha = PrimaryMaterialAlpha;
+			VisData.MaterialColor = PrimaryMaterialColor;
 
 			// Classify occlusion role based on category and material transparency
 			VisData.OcclusionRole = UFragmentOcclusionClassifier::ClassifyFragment(
@@ -212,6 +278,7 @@ void UFragmentRegistry::CollectFragmentData(const FFragmentItem& Item, const Mod
 			VisData.bIsSmallObject = true; // Point-based = small
 			VisData.MaterialIndex = 0;
 			VisData.MaterialAlpha = PrimaryMaterialAlpha;
+			VisData.MaterialColor = PrimaryMaterialColor;
 
 			// Classify occlusion role (fallback fragments are typically small occludees)
 			VisData.OcclusionRole = UFragmentOcclusionClassifier::ClassifyFragment(
@@ -267,6 +334,9 @@ int64 UFragmentRegistry::GetMemoryUsage() const
 		TotalBytes += Data.Category.GetAllocatedSize();
 	}
 
+	// Hot culling arrays
+	TotalBytes += CullingData.GetAllocatedSize();
+
 	// LocalIdToIndex map
 	TotalBytes += LocalIdToIndex.GetAllocatedSize();
 
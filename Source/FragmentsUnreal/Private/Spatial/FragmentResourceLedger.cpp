@@ -0,0 +1,149 @@
+#include "Spatial/FragmentResourceLedger.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "Materials/MaterialInterface.h"
+#include "GameFramework/Actor.h"
+
+void FFragmentResourceLedger::AddFragment(int32 LocalId, const AActor* Actor, int64 InstanceBytes)
+{
+	RemoveFragment(LocalId);
+	if (!Actor && InstanceBytes <= 0)
+	{
+		return;
+	}
+
+	FFragmentEntry& Fragment = Fragments.Add(LocalId);
+	Fragment.ObjectBytes = InstanceBytes;
+	if (!Actor)
+	{
+		ObjectBytes += Fragment.ObjectBytes;
+		return;
+	}
+	Fragment.ObjectBytes += Actor->GetClass()->GetStructureSize();
+
+	TInlineComponentArray<UStaticMeshComponent*> MeshComponents(Actor);
+	for (const UStaticMeshComponent* MeshComp : MeshComponents)
+	{
+		Fragment.ObjectBytes += MeshComp->GetClass()->GetStructureSize();
+		Fragment.ComponentCount++;
+
+		if (const UStaticMesh* Mesh = MeshComp->GetStaticMesh())
+		{
+			AddResource(Fragment, Mesh, true);
+		}
+
+		const int32 MaterialCount = MeshComp->GetNumMaterials();
+		for (int32 MaterialIndex = 0; MaterialIndex < MaterialCount; MaterialIndex++)
+		{
+			if (const UMaterialInterface* Material = MeshComp->GetMaterial(MaterialIndex))
+			{
+				AddResource(Fragment, Material, false);
+			}
+		}
+	}
+
+	ObjectBytes += Fragment.ObjectBytes;
+	ComponentCount += Fragment.ComponentCount;
+}
+
+int64 FFragmentResourceLedger::RemoveFragment(int32 LocalId)
+{
+	FFragmentEntry Fragment;
+	if (!Fragments.RemoveAndCopyValue(LocalId, Fragment))
+	{
+		return 0;
+	}
+
+	int64 FreedBytes = Fragment.ObjectBytes;
+	ObjectBytes -= Fragment.ObjectBytes;
+	ComponentCount -= Fragment.ComponentCount;
+
+	for (const UObject* Resource : Fragment.Resources)
+	{
+		FResourceEntry* Entry = Resources.Find(Resource);
+		if (!Entry || --Entry->RefCount > 0)
+		{
+			continue;
+		}
+
+		FreedBytes += Entry->Bytes;
+		ResourceBytes -= Entry->Bytes;
+		(Entry->bIsMesh ? MeshCount : MaterialCount)--;
+		Resources.Remove(Resource);
+	}
+
+	return FreedBytes;
+}
+
+void FFragmentResourceLedger::Reset()
+{
+	Resources.Empty();
+	Fragments.Empty();
+	ResourceBytes = 0;
+	ObjectBytes = 0;
+	ComponentCount = 0;
+	MeshCount = 0;
+	MaterialCount = 0;
+}
+
+void FFragmentResourceLedger::AddResource(FFragmentEntry& Fragment, const UObject* Resource, bool bIsMesh)
+{
+	// Several samples of one fragment may share a mesh or material: one reference per fragment
+	if (Fragment.Resources.Contains(Resource))
+	{
+		return;
+	}
+	Fragment.Resources.Add(Resource);
+
+	FResourceEntry& Entry = Resources.FindOrAdd(Resource);
+	if (Entry.RefCount++ > 0)
+	{
+		return;
+	}
+
+	Entry.bIsMesh = bIsMesh;
+	Entry.Bytes = bIsMesh
+		? GetMeshBytes(static_cast<const UStaticMesh*>(Resource))
+		: GetMaterialBytes(static_cast<const UMaterialInterface*>(Resource));
+	ResourceBytes += Entry.Bytes;
+	(bIsMesh ? MeshCount : MaterialCount)++;
+}
+
+int64 FFragmentResourceLedger::GetMeshBytes(const UStaticMesh* Mesh)
+{
+	const FStaticMeshRenderData* RenderData = Mesh ? Mesh->GetRenderData() : nullptr;
+	if (!RenderData)
+	{
+		return 0;
+	}
+
+	int64 Bytes = 0;
+	for (const FStaticMeshLODResources& Lod : RenderData->LODResources)
+	{
+		Bytes += Lod.VertexBuffers.PositionVertexBuffer.GetNumVertices() * Lod.VertexBuffers.PositionVertexBuffer.GetStride();
+		Bytes += Lod.VertexBuffers.StaticMeshVertexBuffer.GetResourceSize();
+		Bytes += Lod.VertexBuffers.ColorVertexBuffer.GetNumVertices() * Lod.VertexBuffers.ColorVertexBuffer.GetStride();
+		Bytes += Lod.IndexBuffer.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+int64 FFragmentResourceLedger::GetMaterialBytes(const UMaterialInterface* Material)
+{
+	if (!Material)
+	{
+		return 0;
+	}
+
+	// Exclusive size covers the instance's parameters and render proxy, not the shared parent material
+	return Material->GetClass()->GetStructureSize()
+		+ static_cast<int64>(const_cast<UMaterialInterface*>(Material)->GetResourceSizeBytes(EResourceSizeMode::Exclusive));
+}
+
+int64 FFragmentResourceLedger::GetInstanceBytes(int32 NumCustomDataFloats)
+{
+	// Game thread copy plus the render thread instance buffer
+	return 2 * (static_cast<int64>(sizeof(FInstancedStaticMeshInstanceData)) + NumCustomDataFloats * static_cast<int64>(sizeof(float)));
+}
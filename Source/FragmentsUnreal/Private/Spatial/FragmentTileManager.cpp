@@ -3,6 +3,8 @@
 #include "Spatial/PerSampleVisibilityController.h"
 #include "Spatial/DynamicTileGenerator.h"
 #include "Spatial/OcclusionSpawnController.h"
+#include "Spatial/FragmentProxyBoxRenderer.h"
+#include "Spatial/FragmentTileMerger.h"
 #include "Importer/FragmentsImporter.h"
 #include "Importer/FragmentModelWrapper.h"
 #include "Fragment/Fragment.h"
@@ -104,16 +106,49 @@ void UFragmentTileManager::UpdateVisibleTiles(const FVector& CameraLocation, con
 	// === STEP 1: Per-sample visibility evaluation ===
 	SampleVisibility->bShowAllVisible = bShowAllVisible;
 	SampleVisibility->GraphicsQuality = GraphicsQuality;
+	SampleVisibility->GeometryScreenSize = GeometryScreenSize;
 	SampleVisibility->UpdateVisibility(CameraLocation, CameraRotation, FOV, AspectRatio, ViewportHeight);
+	RefreshCullDistances();
 
 	// === STEP 2: Generate dynamic tiles from visible samples ===
 	const TArray<FFragmentVisibilityResult>& VisibleSamples = SampleVisibility->GetVisibleSamples();
 	TileGenerator->GenerateTiles(VisibleSamples, FragmentRegistry);
 
+	// Non-instanced fragments of visible tiles go to merged meshes instead of actors
+	if (TileMerger)
+	{
+		if (bMergeTileFragments)
+		{
+			TileMerger->UpdateTiles(TileGenerator->GetTiles());
+		}
+		else
+		{
+			TileMerger->Clear();
+		}
+	}
+
 	// === STEP 3: Determine fragments to spawn/show/hide ===
 	TArray<int32> ToSpawn = TileGenerator->GetFragmentsToSpawn(SpawnedFragments);
 	TArray<int32> ToHide = TileGenerator->GetFragmentsToUnload(SpawnedFragments);
 
+	// Merged fragments never spawn; cached actors keep showing until their merged mesh draws them,
+	// then they are hidden by HideMergedFragmentActors
+	if (TileMerger && TileMerger->GetMergedFragments().Num() > 0)
+	{
+		const TSet<int32>& MergedFragments = TileMerger->GetMergedFragments();
+		const TSet<int32>& DrawnFragments = TileMerger->GetDrawnFragments();
+		ToSpawn.RemoveAll([this, &MergedFragments, &DrawnFragments](int32 LocalId)
+		{
+			return MergedFragments.Contains(LocalId) && (DrawnFragments.Contains(LocalId) || !HiddenFragments.Contains(LocalId));
+		});
+	}
+
+	// Fragments hidden on request are never shown by streaming
+	if (ForcedHiddenFragments.Num() > 0)
+	{
+		ToSpawn.RemoveAll([this](int32 LocalId) { return ForcedHiddenFragments.Contains(LocalId); });
+	}
+
 	// Check how many can be shown from cache vs need actual spawning
 	int32 CacheHits = 0;
 	TArray<int32> ActuallyNeedSpawn;
@@ -134,8 +169,9 @@ void UFragmentTileManager::UpdateVisibleTiles(const FVector& CameraLocation, con
 	FragmentsSpawned = 0;
 
 	UE_LOG(LogFragmentTileManager, Verbose,
-	       TEXT("Visibility: %d visible, %d tiles, %d to show (%d cache hits), %d to hide"),
-	       VisibleSamples.Num(), TileGenerator->GetTileCount(), ToSpawn.Num(), CacheHits, ToHide.Num());
+	       TEXT("Visibility: %d visible, %d tiles, %d to show (%d cache hits), %d to hide, %d as boxes, %d merged"),
+	       VisibleSamples.Num(), TileGenerator->GetTileCount(), ToSpawn.Num(), CacheHits, ToHide.Num(),
+	       TileGenerator->GetWiresFragments().Num(), TileMerger ? TileMerger->GetMergedFragments().Num() : 0);
 
 	// === STEP 4: Show cached fragments immediately (cache hits) ===
 	for (int32 LocalId : ToSpawn)
@@ -151,8 +187,25 @@ void UFragmentTileManager::UpdateVisibleTiles(const FVector& CameraLocation, con
 	{
 		HideFragmentById(LocalId);
 	}
+	HideMergedFragmentActors();
 
-	// === STEP 6: Evict hidden fragments if memory over budget ===
+	// === STEP 6: Draw the Wires tier as boxes ===
+	// Geometry of demoted fragments was hidden above (instanced ones once the importer flushes)
+	if (ProxyBoxes)
+	{
+		TSet<int32> BoxFragments;
+		BoxFragments.Reserve(TileGenerator->GetWiresFragments().Num());
+		for (int32 LocalId : TileGenerator->GetWiresFragments())
+		{
+			if (!SpawnedFragments.Contains(LocalId) && !ForcedHiddenFragments.Contains(LocalId))
+			{
+				BoxFragments.Add(LocalId);
+			}
+		}
+		ProxyBoxes->UpdateBoxes(BoxFragments);
+	}
+
+	// === STEP 7: Evict hidden fragments if memory over budget ===
 	EvictFragmentsToFitBudget();
 
 	// Update last camera state
@@ -184,14 +237,21 @@ float UFragmentTileManager::ProcessSpawnChunkWithBudget(float BudgetMs)
 		return 0.0f;
 	}
 
+	// Swap in finished tile merges first; they replace many spawns each
+	if (TileMerger && TileMerger->CommitFinishedBuilds(StartTime + BudgetMs / 1000.0) > 0)
+	{
+		HideMergedFragmentActors();
+	}
+
 	// Get fragments to spawn - filter out those already spawned or in hidden cache
 	TArray<int32> ToSpawn = TileGenerator->GetFragmentsToSpawn(SpawnedFragments);
 
-	// Filter out fragments that are in hidden cache (already handled)
+	// Filter out fragments that are in hidden cache (already handled), drawn by merged meshes or hidden on request
 	TArray<int32> ActuallyNeedSpawn;
 	for (int32 LocalId : ToSpawn)
 	{
-		if (!HiddenFragments.Contains(LocalId))
+		if (!HiddenFragments.Contains(LocalId) && !ForcedHiddenFragments.Contains(LocalId) &&
+			!(TileMerger && TileMerger->GetMergedFragments().Contains(LocalId)))
 		{
 			ActuallyNeedSpawn.Add(LocalId);
 		}
@@ -211,29 +271,34 @@ float UFragmentTileManager::ProcessSpawnChunkWithBudget(float BudgetMs)
 		return 0.0f;
 	}
 
-	// Sort by priority: non-deferred first, then by distance (closest first)
-	ActuallyNeedSpawn.Sort([this](const int32& A, const int32& B)
+	// Priority: non-deferred first, then by distance (closest first)
+	// Also passed on to the mesh builds these fragments end up waiting for
+	TMap<int32, float> SpawnPriorities;
+	SpawnPriorities.Reserve(ActuallyNeedSpawn.Num());
+	for (int32 LocalId : ActuallyNeedSpawn)
 	{
-		const FFragmentVisibilityData* DataA = FragmentRegistry ? FragmentRegistry->FindFragment(A) : nullptr;
-		const FFragmentVisibilityData* DataB = FragmentRegistry ? FragmentRegistry->FindFragment(B) : nullptr;
-
-		if (!DataA || !DataB) return false;
+		const FFragmentVisibilityData* Data = FragmentRegistry ? FragmentRegistry->FindFragment(LocalId) : nullptr;
+		if (!Data)
+		{
+			SpawnPriorities.Add(LocalId, TNumericLimits<float>::Max());
+			continue;
+		}
 
-		// Calculate base distances
-		const float DistA = FVector::DistSquared(DataA->WorldBounds.GetCenter(), LastPriorityCameraLocation);
-		const float DistB = FVector::DistSquared(DataB->WorldBounds.GetCenter(), LastPriorityCameraLocation);
+		// Calculate base distance
+		const float Dist = FVector::DistSquared(Data->WorldBounds.GetCenter(), LastPriorityCameraLocation);
 
 		// Apply occlusion deferral priority adjustment
-		float PriorityA = DistA;
-		float PriorityB = DistB;
-
+		float Priority = Dist;
 		if (OcclusionController && bEnableOcclusionDeferral)
 		{
-			PriorityA = OcclusionController->GetSpawnPriority(A, DistA);
-			PriorityB = OcclusionController->GetSpawnPriority(B, DistB);
+			Priority = OcclusionController->GetSpawnPriority(LocalId, Dist);
 		}
+		SpawnPriorities.Add(LocalId, Priority);
+	}
 
-		return PriorityA < PriorityB;
+	ActuallyNeedSpawn.Sort([&SpawnPriorities](const int32& A, const int32& B)
+	{
+		return SpawnPriorities[A] < SpawnPriorities[B];
 	});
 
 	// Time-based spawning within frame budget (use provided budget)
@@ -252,7 +317,7 @@ float UFragmentTileManager::ProcessSpawnChunkWithBudget(float BudgetMs)
 			break;
 		}
 
-		if (SpawnFragmentById(LocalId))
+		if (SpawnFragmentById(LocalId, SpawnPriorities[LocalId]))
 		{
 			SpawnedThisFrame++;
 			FragmentsSpawned++;
@@ -262,14 +327,8 @@ float UFragmentTileManager::ProcessSpawnChunkWithBudget(float BudgetMs)
 	// Update occlusion tracking based on render results
 	UpdateOcclusionTracking();
 
-	// Finalize any pending ISMCs periodically during streaming
-	// This is called when spawning happened this frame to ensure ISMCs are created
-	// even if individual group thresholds aren't reached. The function is fast
-	// since it skips already-finalized groups.
-	if (Importer && SpawnedThisFrame > 0)
-	{
-		Importer->FinalizeAllISMCs();
-	}
+	// HISMCs of the instances queued above are created by the importer once per frame,
+	// after all tile managers, within what is left of the frame budget (FinalizeISMCsWithBudget)
 
 	// Update loading stage
 	if (FragmentsSpawned < TotalFragmentsToSpawn)
@@ -313,19 +372,71 @@ void UFragmentTileManager::InitializePerSampleVisibility(UFragmentRegistry* InRe
 	OcclusionController->Initialize(FragmentRegistry);
 	OcclusionController->bEnableOcclusionDeferral = bEnableOcclusionDeferral;
 
+	// Create box proxy renderer for the Wires LOD tier
+	if (ProxyBoxes)
+	{
+		ProxyBoxes->Clear();
+	}
+	ProxyBoxes = NewObject<UFragmentProxyBoxRenderer>(this);
+	ProxyBoxes->Initialize(Importer, FragmentRegistry);
+
+	// Create tile merger (only fed while bMergeTileFragments is set)
+	if (TileMerger)
+	{
+		TileMerger->Clear();
+	}
+	TileMerger = NewObject<UFragmentTileMerger>(this);
+	TileMerger->Initialize(Importer, ModelGuid);
+
 	// Clear per-sample state
 	SpawnedFragments.Empty();
 	HiddenFragments.Empty();
 	SpawnedFragmentActors.Empty();
+	InstancedFragments.Empty();
+	ForcedHiddenFragments.Empty();
 	FragmentLastUsedTime.Empty();
-	PerSampleCacheBytes = 0;
+	ResourceLedger.Reset();
 
 	UE_LOG(LogFragmentTileManager, Log, TEXT("Per-sample visibility initialized: %d fragments in registry, Cache budget: %lld MB, OcclusionDeferral: %s"),
 	       FragmentRegistry->GetFragmentCount(), MaxCachedBytes / (1024 * 1024),
 	       bEnableOcclusionDeferral ? TEXT("Enabled") : TEXT("Disabled"));
 }
 
-bool UFragmentTileManager::SpawnFragmentById(int32 LocalId)
+void UFragmentTileManager::Shutdown()
+{
+	if (ProxyBoxes)
+	{
+		ProxyBoxes->Clear();
+		ProxyBoxes = nullptr;
+	}
+	if (TileMerger)
+	{
+		TileMerger->Clear();
+		TileMerger = nullptr;
+	}
+
+	SampleVisibility = nullptr;
+	TileGenerator = nullptr;
+	OcclusionController = nullptr;
+	FragmentRegistry = nullptr;
+
+	SpawnedFragments.Empty();
+	HiddenFragments.Empty();
+	SpawnedFragmentActors.Empty();
+	InstancedFragments.Empty();
+	ForcedHiddenFragments.Empty();
+	FragmentLastUsedTime.Empty();
+	ResourceLedger.Reset();
+
+	TotalFragmentsToSpawn = 0;
+	FragmentsSpawned = 0;
+	SpawnProgress = 0.0f;
+	LoadingStage = TEXT("Idle");
+
+	UE_LOG(LogFragmentTileManager, Log, TEXT("TileManager shut down for model: %s"), *ModelGuid);
+}
+
+bool UFragmentTileManager::SpawnFragmentById(int32 LocalId, float SpawnPriority)
 {
 	// Skip if already spawned (visible)
 	if (SpawnedFragments.Contains(LocalId))
@@ -402,7 +513,8 @@ bool UFragmentTileManager::SpawnFragmentById(int32 LocalId)
 
 	// Spawn fragment - pass bWasInstanced to track GPU instanced fragments
 	bool bWasInstanced = false;
-	AFragment* SpawnedActor = Importer->SpawnSingleFragment(*FragmentItem, ParentActor, MeshesRef, false, &bWasInstanced);
+	AFragment* SpawnedActor = Importer->SpawnSingleFragment(*FragmentItem, ParentActor, MeshesRef, Wrapper->GetContentHash(), false, &bWasInstanced,
+		nullptr, nullptr, SpawnPriority);
 
 	if (SpawnedActor)
 	{
@@ -410,15 +522,22 @@ bool UFragmentTileManager::SpawnFragmentById(int32 LocalId)
 		SpawnedFragments.Add(LocalId);
 		SpawnedFragmentActors.Add(LocalId, SpawnedActor);
 
-		// Track memory usage
-		int64 FragmentMemory = CalculateFragmentMemoryUsage(SpawnedActor);
-		PerSampleCacheBytes += FragmentMemory;
+		// Samples of shapes instanced elsewhere are drawn by HISMCs, not the actor
+		const int64 InstanceBytes = GetInstanceBytes(FragmentItem->Samples, FragmentItem->Category);
+		if (InstanceBytes > 0)
+		{
+			InstancedFragments.Add(LocalId);
+		}
+
+		// Track memory usage (meshes and materials shared with other fragments are only charged once)
+		const int64 BytesBefore = ResourceLedger.GetTotalBytes();
+		ResourceLedger.AddFragment(LocalId, SpawnedActor, InstanceBytes);
 
 		// Update LRU tracking
 		TouchFragment(LocalId);
 
 		UE_LOG(LogFragmentTileManager, Verbose, TEXT("Spawned fragment LocalId %d (%lld KB)"),
-		       LocalId, FragmentMemory / 1024);
+		       LocalId, (ResourceLedger.GetTotalBytes() - BytesBefore) / 1024);
 		return true;
 	}
 	else if (bWasInstanced)
@@ -427,7 +546,11 @@ bool UFragmentTileManager::SpawnFragmentById(int32 LocalId)
 		// CRITICAL: Must track to prevent re-spawning every frame (memory leak!)
 		SpawnedFragments.Add(LocalId);
 		// Don't add to SpawnedFragmentActors since there's no actor
-		// Memory is tracked by the ISMC, not per-fragment
+		InstancedFragments.Add(LocalId);
+
+		// Charge its per-instance data; the group mesh and material are shared and stay resident
+		ResourceLedger.AddFragment(LocalId, nullptr, GetInstanceBytes(FragmentItem->Samples, FragmentItem->Category));
+		TouchFragment(LocalId);
 
 		UE_LOG(LogFragmentTileManager, Verbose, TEXT("Spawned GPU-instanced fragment LocalId %d (no actor)"), LocalId);
 		return true;
@@ -438,16 +561,25 @@ bool UFragmentTileManager::SpawnFragmentById(int32 LocalId)
 
 void UFragmentTileManager::HideFragmentById(int32 LocalId)
 {
-	AFragment** ActorPtr = SpawnedFragmentActors.Find(LocalId);
-	if (!ActorPtr || !*ActorPtr)
+	AFragment* const* ActorPtr = SpawnedFragmentActors.Find(LocalId);
+	AFragment* Actor = ActorPtr ? *ActorPtr : nullptr;
+	const bool bHasInstances = InstancedFragments.Contains(LocalId);
+	if (!Actor && !bHasInstances)
 	{
 		return;
 	}
 
-	AFragment* Actor = *ActorPtr;
-
 	// Just hide the actor, don't destroy (matches engine_fragment behavior)
-	Actor->SetActorHiddenInGame(true);
+	if (Actor)
+	{
+		Actor->SetActorHiddenInGame(true);
+	}
+
+	// Instances leave their HISMCs at the importer's next flush and are kept for showing again
+	if (bHasInstances && Importer)
+	{
+		Importer->SetInstancedFragmentHidden(ModelGuid, LocalId, true);
+	}
 
 	// Move from spawned to hidden set
 	SpawnedFragments.Remove(LocalId);
@@ -464,16 +596,30 @@ bool UFragmentTileManager::ShowFragmentById(int32 LocalId)
 		return false;
 	}
 
-	AFragment** ActorPtr = SpawnedFragmentActors.Find(LocalId);
-	if (!ActorPtr || !*ActorPtr)
+	AFragment* const* ActorPtr = SpawnedFragmentActors.Find(LocalId);
+	AFragment* Actor = ActorPtr ? *ActorPtr : nullptr;
+	const bool bHasInstances = InstancedFragments.Contains(LocalId);
+	if (ActorPtr && !Actor)
 	{
-		// Actor was destroyed, need to respawn
-		HiddenFragments.Remove(LocalId);
+		// Actor was destroyed, need to respawn (its instances are dropped with it)
+		UnloadFragmentById(LocalId);
+		return false;
+	}
+	if (!ActorPtr && !bHasInstances)
+	{
+		// Fully instanced fragment whose instances are gone: nothing left to show, respawn
+		UnloadFragmentById(LocalId);
 		return false;
 	}
 
-	AFragment* Actor = *ActorPtr;
-	Actor->SetActorHiddenInGame(false);
+	if (Actor)
+	{
+		Actor->SetActorHiddenInGame(false);
+	}
+	if (bHasInstances && Importer)
+	{
+		Importer->SetInstancedFragmentHidden(ModelGuid, LocalId, false);
+	}
 
 	// Move from hidden to spawned set
 	HiddenFragments.Remove(LocalId);
@@ -486,8 +632,41 @@ bool UFragmentTileManager::ShowFragmentById(int32 LocalId)
 	return true;
 }
 
+void UFragmentTileManager::RefreshCullDistances()
+{
+	const float Scale = Importer && Importer->bAutoCullDistances ? SampleVisibility->GetCullDistanceScale() : 0.0f;
+
+	// Small view changes (a resize by a few pixels) are not worth touching every component
+	if (AppliedCullDistanceScale >= 0.0f && FMath::IsNearlyEqual(Scale, AppliedCullDistanceScale, AppliedCullDistanceScale * 0.02f))
+	{
+		return;
+	}
+
+	AppliedCullDistanceScale = Scale;
+	if (!Importer)
+	{
+		return;
+	}
+
+	for (const auto& Pair : SpawnedFragmentActors)
+	{
+		if (IsValid(Pair.Value))
+		{
+			Importer->RefreshFragmentCullDistance(Pair.Value);
+		}
+	}
+	UE_LOG(LogFragmentTileManager, Verbose, TEXT("Cull distance scale changed to %.1f: refreshed %d fragment actors"),
+	       Scale, SpawnedFragmentActors.Num());
+}
+
 void UFragmentTileManager::UnloadFragmentById(int32 LocalId)
 {
+	// Instanced fragments leave their HISMCs at the importer's next flush
+	if (InstancedFragments.Remove(LocalId) > 0 && Importer)
+	{
+		Importer->RemoveInstancedFragment(ModelGuid, LocalId);
+	}
+
 	AFragment** ActorPtr = SpawnedFragmentActors.Find(LocalId);
 	if (!ActorPtr || !*ActorPtr)
 	{
@@ -495,16 +674,21 @@ void UFragmentTileManager::UnloadFragmentById(int32 LocalId)
 		HiddenFragments.Remove(LocalId);
 		SpawnedFragmentActors.Remove(LocalId);
 		FragmentLastUsedTime.Remove(LocalId);
+		ResourceLedger.RemoveFragment(LocalId);
 		return;
 	}
 
 	AFragment* Actor = *ActorPtr;
 
-	// Calculate memory before destroying
-	int64 FragmentMemory = CalculateFragmentMemoryUsage(Actor);
-
-	// Destroy the actor
-	Actor->Destroy();
+	// Destroy the actor; its meshes and materials stay cached until the importer needs the memory
+	if (Importer)
+	{
+		Importer->DestroyFragmentActor(Actor);
+	}
+	else
+	{
+		Actor->Destroy();
+	}
 
 	// Remove from all tracking
 	SpawnedFragments.Remove(LocalId);
@@ -513,54 +697,34 @@ void UFragmentTileManager::UnloadFragmentById(int32 LocalId)
 	FragmentLastUsedTime.Remove(LocalId);
 
 	// Update cache memory tracking
-	PerSampleCacheBytes = FMath::Max((int64)0, PerSampleCacheBytes - FragmentMemory);
+	const int64 FragmentMemory = ResourceLedger.RemoveFragment(LocalId);
 
 	UE_LOG(LogFragmentTileManager, Verbose, TEXT("Unloaded fragment LocalId %d (%lld KB freed)"), LocalId, FragmentMemory / 1024);
 }
 
-int64 UFragmentTileManager::CalculateFragmentMemoryUsage(AFragment* Actor) const
+void UFragmentTileManager::RefreshFragmentResources(int32 LocalId, const AActor* Actor)
 {
-	if (!Actor)
+	// Only fragments this manager spawned are charged
+	if (SpawnedFragmentActors.Contains(LocalId))
 	{
-		return 0;
+		const AFragment* Fragment = Cast<AFragment>(Actor);
+		ResourceLedger.AddFragment(LocalId, Actor, Fragment ? GetInstanceBytes(Fragment->GetSamples(), Fragment->GetCategory()) : 0);
 	}
+}
 
-	int64 TotalBytes = 0;
-
-	// Get all static mesh components
-	TArray<UStaticMeshComponent*> MeshComponents;
-	Actor->GetComponents<UStaticMeshComponent>(MeshComponents);
-
-	for (UStaticMeshComponent* MeshComp : MeshComponents)
+int64 UFragmentTileManager::GetInstanceBytes(const TArray<FFragmentSample>& Samples, const FString& Category) const
+{
+	if (!Importer)
 	{
-		if (!MeshComp || !MeshComp->GetStaticMesh())
-		{
-			continue;
-		}
-
-		UStaticMesh* Mesh = MeshComp->GetStaticMesh();
-
-		// Get mesh resource size
-		if (Mesh->GetRenderData())
-		{
-			for (const FStaticMeshLODResources& LOD : Mesh->GetRenderData()->LODResources)
-			{
-				TotalBytes += LOD.VertexBuffers.PositionVertexBuffer.GetNumVertices() * sizeof(FVector);
-				TotalBytes += LOD.VertexBuffers.StaticMeshVertexBuffer.GetResourceSize();
-				TotalBytes += LOD.VertexBuffers.ColorVertexBuffer.GetNumVertices() * sizeof(FColor);
-				TotalBytes += LOD.IndexBuffer.GetAllocatedSize();
-			}
-		}
-
-		// Material instances
-		TArray<UMaterialInterface*> Materials = MeshComp->GetMaterials();
-		TotalBytes += Materials.Num() * 1024;
+		return 0;
 	}
 
-	// Actor overhead
-	TotalBytes += 4096;
-
-	return TotalBytes;
+	int32 InstanceCount = 0;
+	for (const FFragmentSample& Sample : Samples)
+	{
+		InstanceCount += Sample.ExtractedGeometry.bIsValid && Importer->IsSampleInstanced(Sample, Category) ? 1 : 0;
+	}
+	return InstanceCount * FFragmentResourceLedger::GetInstanceBytes(Importer->GetInstanceCustomDataFloats());
 }
 
 FFragmentItem* UFragmentTileManager::FindParentFragmentItem(const FFragmentItem* Root, const FFragmentItem* Target)
@@ -602,6 +766,77 @@ void UFragmentTileManager::UpdateSpawnProgress()
 	}
 }
 
+int32 UFragmentTileManager::GetProxyBoxCount() const
+{
+	return ProxyBoxes ? ProxyBoxes->GetBoxCount() : 0;
+}
+
+int32 UFragmentTileManager::GetMergedMeshCount() const
+{
+	return TileMerger ? TileMerger->GetMergedMeshCount() : 0;
+}
+
+void UFragmentTileManager::SetFragmentHidden(int32 LocalId, bool bHidden)
+{
+	if (bHidden)
+	{
+		bool bAlreadyHidden = false;
+		ForcedHiddenFragments.Add(LocalId, &bAlreadyHidden);
+		if (bAlreadyHidden)
+		{
+			return;
+		}
+	}
+	else if (ForcedHiddenFragments.Remove(LocalId) == 0)
+	{
+		return;
+	}
+
+	if (TileMerger)
+	{
+		TileMerger->SetFragmentHidden(LocalId, bHidden);
+	}
+
+	// Shown fragments come back with the next visibility update if they are still in view
+	if (bHidden && SpawnedFragments.Contains(LocalId))
+	{
+		HideFragmentById(LocalId);
+	}
+}
+
+void UFragmentTileManager::SetFragmentSelected(int32 LocalId, bool bSelected)
+{
+	if (ProxyBoxes)
+	{
+		ProxyBoxes->SetFragmentSelected(LocalId, bSelected);
+	}
+	if (TileMerger)
+	{
+		TileMerger->SetFragmentSelected(LocalId, bSelected);
+	}
+}
+
+void UFragmentTileManager::HideMergedFragmentActors()
+{
+	if (!TileMerger)
+	{
+		return;
+	}
+
+	for (int32 LocalId : TileMerger->GetDrawnFragments())
+	{
+		if (SpawnedFragments.Contains(LocalId) && SpawnedFragmentActors.Contains(LocalId))
+		{
+			HideFragmentById(LocalId);
+		}
+	}
+}
+
+int32 UFragmentTileManager::FindMergedFragmentAtFace(const UPrimitiveComponent* Component, int32 FaceIndex) const
+{
+	return TileMerger ? TileMerger->FindLocalIdForTriangle(Component, FaceIndex) : INDEX_NONE;
+}
+
 bool UFragmentTileManager::IsLoading() const
 {
 	return TotalFragmentsToSpawn > 0 && FragmentsSpawned < TotalFragmentsToSpawn;
@@ -623,7 +858,7 @@ void UFragmentTileManager::TouchFragment(int32 LocalId)
 
 bool UFragmentTileManager::IsPerSampleMemoryOverBudget() const
 {
-	return PerSampleCacheBytes > MaxCachedBytes;
+	return ResourceLedger.GetTotalBytes() > MaxCachedBytes;
 }
 
 void UFragmentTileManager::EvictFragmentsToFitBudget()
@@ -648,7 +883,7 @@ void UFragmentTileManager::EvictFragmentsToFitBudget()
 	const double CurrentTime = World->GetTimeSeconds();
 
 	UE_LOG(LogFragmentTileManager, Warning, TEXT("Cache over budget: %lld MB / %lld MB - evicting hidden fragments"),
-	       PerSampleCacheBytes / (1024 * 1024), MaxCachedBytes / (1024 * 1024));
+	       ResourceLedger.GetTotalBytes() / (1024 * 1024), MaxCachedBytes / (1024 * 1024));
 
 	// Build list of eviction candidates from HIDDEN fragments only
 	TArray<int32> EvictionCandidates;
@@ -688,7 +923,7 @@ void UFragmentTileManager::EvictFragmentsToFitBudget()
 	if (EvictedCount > 0)
 	{
 		UE_LOG(LogFragmentTileManager, Log, TEXT("Evicted %d hidden fragments - Cache now: %lld MB"),
-		       EvictedCount, PerSampleCacheBytes / (1024 * 1024));
+		       EvictedCount, ResourceLedger.GetTotalBytes() / (1024 * 1024));
 	}
 }
 
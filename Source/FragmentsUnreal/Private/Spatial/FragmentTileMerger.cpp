@@ -0,0 +1,546 @@
+#include "Spatial/FragmentTileMerger.h"
+#include "Spatial/DynamicTileGenerator.h"
+#include "Importer/FragmentsImporter.h"
+#include "Importer/FragmentModelWrapper.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "StaticMeshResources.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Algo/BinarySearch.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogFragmentTileMerger, Log, All);
+
+namespace
+{
+	uint64 MakeGroupKey(uint32 TileId, const FColor& Color)
+	{
+		return static_cast<uint64>(TileId) | (static_cast<uint64>(Color.ToPackedARGB()) << 32);
+	}
+
+	FColor GetSampleColor(const FFragmentSample& Sample)
+	{
+		const FPreExtractedGeometry& Geometry = Sample.ExtractedGeometry;
+		return FColor(Geometry.R, Geometry.G, Geometry.B, Geometry.A);
+	}
+
+	void IndexItems(const FFragmentItem* Item, TMap<int32, const FFragmentItem*>& OutItems)
+	{
+		if (Item->LocalId >= 0)
+		{
+			OutItems.Add(Item->LocalId, Item);
+		}
+		for (const FFragmentItem* Child : Item->FragmentChildren)
+		{
+			if (Child)
+			{
+				IndexItems(Child, OutItems);
+			}
+		}
+	}
+}
+
+UFragmentTileMerger::UFragmentTileMerger()
+{
+}
+
+void UFragmentTileMerger::Initialize(UFragmentsImporter* InImporter, const FString& InModelGuid)
+{
+	Importer = InImporter;
+	ModelGuid = InModelGuid;
+
+	Items.Empty();
+	MergeableCache.Empty();
+}
+
+void UFragmentTileMerger::UpdateTiles(const TMap<uint32, FDynamicRenderTile>& Tiles)
+{
+	if (!Importer)
+	{
+		return;
+	}
+
+	BuildItemIndex();
+
+	// Models loaded or unloaded since the last update may have changed which shapes are instanced
+	const uint32 DecisionSerial = Importer->GetInstancingDecisionSerial();
+	if (DecisionSerial != MergeableCacheSerial)
+	{
+		MergeableCache.Reset();
+		MergeableCacheSerial = DecisionSerial;
+	}
+
+	// Regroup the mergeable fragments of every visible tile by sample color
+	TMap<uint64, TArray<int32>> NewGroups;
+	TMap<uint64, const FDynamicRenderTile*> GroupTiles;
+	TMap<uint64, FColor> GroupColors;
+	MergedFragments.Reset();
+
+	for (const TPair<uint32, FDynamicRenderTile>& TilePair : Tiles)
+	{
+		const FDynamicRenderTile& Tile = TilePair.Value;
+		if (Tile.LodLevel != EFragmentLod::Visible)
+		{
+			continue;
+		}
+
+		for (int32 LocalId : Tile.FragmentLocalIds)
+		{
+			if (!IsMergeable(LocalId))
+			{
+				continue;
+			}
+
+			MergedFragments.Add(LocalId);
+			for (const FFragmentSample& Sample : Items[LocalId]->Samples)
+			{
+				if (!Sample.ExtractedGeometry.bIsValid)
+				{
+					continue;
+				}
+
+				const FColor Color = GetSampleColor(Sample);
+				const uint64 Key = MakeGroupKey(Tile.TileId, Color);
+				TArray<int32>& LocalIds = NewGroups.FindOrAdd(Key);
+				if (LocalIds.Num() == 0 || LocalIds.Last() != LocalId)
+				{
+					LocalIds.Add(LocalId);
+				}
+				GroupTiles.Add(Key, &Tile);
+				GroupColors.Add(Key, Color);
+			}
+		}
+	}
+
+	// Groups whose tile is gone are destroyed with their mesh; a returning tile is merged again
+	for (auto It = Groups.CreateIterator(); It; ++It)
+	{
+		if (!NewGroups.Contains(It.Key()))
+		{
+			PendingBuilds.Remove(It.Key());
+			DestroyGroupComponent(It.Value());
+			It.RemoveCurrent();
+		}
+	}
+
+	int32 RequestedBuilds = 0;
+	for (TPair<uint64, TArray<int32>>& Pair : NewGroups)
+	{
+		TArray<int32>& LocalIds = Pair.Value;
+		LocalIds.Sort();
+
+		FFragmentMergedMesh* Group = Groups.Find(Pair.Key);
+		if (!Group)
+		{
+			Group = &Groups.Add(Pair.Key);
+			Group->Color = GroupColors[Pair.Key];
+			Group->Origin = GroupTiles[Pair.Key]->Bounds.GetCenter();
+		}
+
+		if (Group->LocalIds == LocalIds)
+		{
+			continue;
+		}
+
+		Group->LocalIds = MoveTemp(LocalIds);
+		RequestBuild(Pair.Key, *Group);
+		RequestedBuilds++;
+	}
+
+	RefreshDrawnFragments();
+
+	if (RequestedBuilds > 0)
+	{
+		UE_LOG(LogFragmentTileMerger, Verbose, TEXT("Requested %d merges, %d fragments in %d groups, %d builds pending"),
+		       RequestedBuilds, MergedFragments.Num(), NewGroups.Num(), PendingBuilds.Num());
+	}
+}
+
+int32 UFragmentTileMerger::CommitFinishedBuilds(double Deadline)
+{
+	if (!Importer)
+	{
+		return 0;
+	}
+
+	int32 Committed = 0;
+	for (auto It = PendingBuilds.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().Future.IsReady())
+		{
+			continue;
+		}
+
+		if (Committed > 0 && FPlatformTime::Seconds() >= Deadline)
+		{
+			break;
+		}
+
+		FFragmentMergedMesh* Group = Groups.Find(It.Key());
+		FFragmentMeshBuildDataPtr Data = It.Value().Future.Get();
+		TArray<int32> BuiltLocalIds = MoveTemp(It.Value().LocalIds);
+		const FVector Origin = It.Value().Origin;
+		It.RemoveCurrent();
+
+		if (!Group)
+		{
+			continue;
+		}
+
+		Group->BuiltLocalIds = MoveTemp(BuiltLocalIds);
+		Committed++;
+
+		if (!Data.IsValid() || !Data->IsValid() || !Data->RenderData.IsValid())
+		{
+			Group->Elements.Reset();
+			if (Group->Component)
+			{
+				Group->Component->SetVisibility(false);
+			}
+			continue;
+		}
+
+		if (!Group->Component)
+		{
+			Group->Component = CreateGroupComponent();
+			if (!Group->Component)
+			{
+				continue;
+			}
+		}
+
+		UMaterialInstanceDynamic* Material = Importer->GetColorMaterial(Group->Color);
+
+		// Same runtime path as representation meshes: buffers were written on the worker
+		UStaticMesh* Mesh = NewObject<UStaticMesh>(this, NAME_None, RF_Transient);
+		Mesh->AddMaterial(Material);
+		Mesh->SetRenderData(MoveTemp(Data->RenderData));
+		Importer->BuildRuntimeCollision(Mesh);
+		Mesh->CalculateExtendedBounds();
+		Mesh->InitResources();
+
+		// The previous mesh stays referenced by nothing once swapped and is collected
+		Group->Component->SetWorldLocation(Origin);
+		Group->Component->SetStaticMesh(Mesh);
+		Importer->ApplyColorMaterial(Group->Component, Group->Color);
+		Group->Component->SetVisibility(Group->LocalIds.Num() > 0);
+		Group->Elements = MoveTemp(Data->Elements);
+	}
+
+	if (Committed > 0)
+	{
+		RefreshDrawnFragments();
+		UE_LOG(LogFragmentTileMerger, Verbose, TEXT("Committed %d merged meshes, %d pending"), Committed, PendingBuilds.Num());
+	}
+
+	return Committed;
+}
+
+void UFragmentTileMerger::SetFragmentHidden(int32 LocalId, bool bHidden)
+{
+	const bool bChanged = bHidden ? !HiddenFragments.Contains(LocalId) : HiddenFragments.Contains(LocalId);
+	if (!bChanged)
+	{
+		return;
+	}
+
+	if (bHidden)
+	{
+		HiddenFragments.Add(LocalId);
+	}
+	else
+	{
+		HiddenFragments.Remove(LocalId);
+	}
+
+	for (TPair<uint64, FFragmentMergedMesh>& Pair : Groups)
+	{
+		if (Algo::BinarySearch(Pair.Value.LocalIds, LocalId) != INDEX_NONE)
+		{
+			RequestBuild(Pair.Key, Pair.Value);
+		}
+	}
+}
+
+int32 UFragmentTileMerger::FindLocalIdForTriangle(const UPrimitiveComponent* Component, int32 TriangleIndex) const
+{
+	if (!Component || TriangleIndex < 0)
+	{
+		return INDEX_NONE;
+	}
+
+	for (const TPair<uint64, FFragmentMergedMesh>& Pair : Groups)
+	{
+		const FFragmentMergedMesh& Group = Pair.Value;
+		if (Group.Component != Component)
+		{
+			continue;
+		}
+
+		// Last range starting at or before the triangle
+		const int32 Index = Algo::UpperBoundBy(Group.Elements, TriangleIndex,
+			[](const FFragmentMeshElementRange& Range) { return Range.FirstTriangle; }) - 1;
+		if (Group.Elements.IsValidIndex(Index) &&
+			TriangleIndex < Group.Elements[Index].FirstTriangle + Group.Elements[Index].NumTriangles)
+		{
+			return Group.Elements[Index].LocalId;
+		}
+		return INDEX_NONE;
+	}
+
+	return INDEX_NONE;
+}
+
+void UFragmentTileMerger::Clear()
+{
+	PendingBuilds.Empty();
+
+	for (TPair<uint64, FFragmentMergedMesh>& Pair : Groups)
+	{
+		DestroyGroupComponent(Pair.Value);
+	}
+	Groups.Empty();
+	MergedFragments.Empty();
+	DrawnFragments.Empty();
+
+	if (HostActor)
+	{
+		HostActor->Destroy();
+		HostActor = nullptr;
+	}
+}
+
+int32 UFragmentTileMerger::GetMergedMeshCount() const
+{
+	int32 Count = 0;
+	for (const TPair<uint64, FFragmentMergedMesh>& Pair : Groups)
+	{
+		if (Pair.Value.Component && Pair.Value.Component->IsVisible())
+		{
+			Count++;
+		}
+	}
+	return Count;
+}
+
+void UFragmentTileMerger::BuildItemIndex()
+{
+	if (Items.Num() > 0 || !Importer)
+	{
+		return;
+	}
+
+	UFragmentModelWrapper* Wrapper = Importer->GetFragmentModel(ModelGuid);
+	if (!Wrapper)
+	{
+		UE_LOG(LogFragmentTileMerger, Warning, TEXT("BuildItemIndex: No model wrapper for %s"), *ModelGuid);
+		return;
+	}
+
+	IndexItems(&Wrapper->GetModelItemRef(), Items);
+}
+
+void UFragmentTileMerger::SetFragmentSelected(int32 LocalId, bool bSelected)
+{
+	if (bSelected)
+	{
+		SelectedFragments.Add(LocalId);
+	}
+	else
+	{
+		SelectedFragments.Remove(LocalId);
+	}
+}
+
+bool UFragmentTileMerger::IsMergeable(int32 LocalId)
+{
+	// Not cached: selection changes without a new instancing decision
+	if (SelectedFragments.Contains(LocalId))
+	{
+		return false;
+	}
+
+	if (const bool* Cached = MergeableCache.Find(LocalId))
+	{
+		return *Cached;
+	}
+
+	// Cached until the importer re-takes its instancing decisions (see UpdateTiles)
+	bool bMergeable = false;
+	if (const FFragmentItem* const* Item = Items.Find(LocalId))
+	{
+		for (const FFragmentSample& Sample : (*Item)->Samples)
+		{
+			if (!Sample.ExtractedGeometry.bIsValid)
+			{
+				continue;
+			}
+
+			if (Importer->IsSampleInstanced(Sample, (*Item)->Category))
+			{
+				bMergeable = false;
+				break;
+			}
+			bMergeable = true;
+		}
+	}
+
+	MergeableCache.Add(LocalId, bMergeable);
+	return bMergeable;
+}
+
+void UFragmentTileMerger::GetDrawnLocalIds(const FFragmentMergedMesh& Group, TArray<int32>& OutLocalIds) const
+{
+	// Group.LocalIds is sorted, so the result is too
+	OutLocalIds.Reset(Group.LocalIds.Num());
+	for (int32 LocalId : Group.LocalIds)
+	{
+		if (!HiddenFragments.Contains(LocalId))
+		{
+			OutLocalIds.Add(LocalId);
+		}
+	}
+}
+
+void UFragmentTileMerger::RefreshDrawnFragments()
+{
+	DrawnFragments.Reset();
+	for (const TPair<uint64, FFragmentMergedMesh>& Pair : Groups)
+	{
+		const FFragmentMergedMesh& Group = Pair.Value;
+		if (Group.Component && Group.Component->IsVisible())
+		{
+			for (const FFragmentMeshElementRange& Element : Group.Elements)
+			{
+				DrawnFragments.Add(Element.LocalId);
+			}
+		}
+	}
+}
+
+void UFragmentTileMerger::DestroyGroupComponent(FFragmentMergedMesh& Group)
+{
+	if (!Group.Component)
+	{
+		return;
+	}
+
+	if (Importer)
+	{
+		Importer->ReleaseComponentResources(Group.Component);
+	}
+	Group.Component->DestroyComponent();
+	Group.Component = nullptr;
+}
+
+void UFragmentTileMerger::RequestBuild(uint64 Key, const FFragmentMergedMesh& Group)
+{
+	TArray<int32> DrawnLocalIds;
+	GetDrawnLocalIds(Group, DrawnLocalIds);
+
+	// The committed mesh already draws this set: a build for another set is stale
+	if (Group.Component && Group.BuiltLocalIds == DrawnLocalIds)
+	{
+		PendingBuilds.Remove(Key);
+		return;
+	}
+
+	const FPendingMerge* Pending = PendingBuilds.Find(Key);
+	if (Pending && Pending->LocalIds == DrawnLocalIds)
+	{
+		return;
+	}
+
+	// Collect the drawn samples of the group relative to its origin
+	TArray<FFragmentMergeElement> Elements;
+	for (int32 LocalId : DrawnLocalIds)
+	{
+		const FFragmentItem* Item = Items.FindRef(LocalId);
+		if (!Item)
+		{
+			continue;
+		}
+
+		for (int32 SampleIndex = 0; SampleIndex < Item->Samples.Num(); SampleIndex++)
+		{
+			const FFragmentSample& Sample = Item->Samples[SampleIndex];
+			if (!Sample.ExtractedGeometry.bIsValid || GetSampleColor(Sample) != Group.Color)
+			{
+				continue;
+			}
+
+			FFragmentMergeElement Element;
+			Element.LocalId = LocalId;
+			Element.RepresentationId = Sample.ExtractedGeometry.SourceRepresentationIndex;
+			if (!Sample.ExtractedGeometry.bFromDerivedCache)
+			{
+				Element.Geometry = Sample.ExtractedGeometry;
+			}
+			else if (Importer->IsDerivedMeshCacheCurrent(ModelGuid))
+			{
+				Element.Geometry = Sample.ExtractedGeometry;
+				Element.DerivedCacheFile = Importer->GetDerivedMeshCacheFile(ModelGuid, Element.RepresentationId);
+			}
+			else if (!Importer->RestoreSampleGeometry(ModelGuid, LocalId, SampleIndex, Element.Geometry))
+			{
+				continue;
+			}
+			Element.Transform = Sample.ExtractedGeometry.LocalTransform * Item->GlobalTransform;
+			Element.Transform.AddToTranslation(-Group.Origin);
+			Elements.Add(MoveTemp(Element));
+		}
+	}
+
+	// Replacing the pending entry drops the stale build; its result is discarded when it finishes
+	FPendingMerge& NewPending = PendingBuilds.Add(Key);
+	NewPending.LocalIds = MoveTemp(DrawnLocalIds);
+	NewPending.Origin = Group.Origin;
+	NewPending.Future = FFragmentMeshBuilder::BuildMergedAsync(MoveTemp(Elements),
+		Importer->MakeMeshBuildOptions(EFragmentMeshBuildProfile::Runtime));
+}
+
+UStaticMeshComponent* UFragmentTileMerger::CreateGroupComponent()
+{
+	if (!Importer)
+	{
+		return nullptr;
+	}
+
+	// Create host actor if needed (one actor holds every merged mesh of this model)
+	if (!HostActor)
+	{
+		AActor* OwnerActor = Importer->GetOwnerRef();
+		UWorld* World = OwnerActor ? OwnerActor->GetWorld() : nullptr;
+		if (!World)
+		{
+			return nullptr;
+		}
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = OwnerActor;
+		HostActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!HostActor)
+		{
+			UE_LOG(LogFragmentTileMerger, Warning, TEXT("CreateGroupComponent: Failed to create host actor"));
+			return nullptr;
+		}
+
+		USceneComponent* Root = NewObject<USceneComponent>(HostActor);
+		HostActor->SetRootComponent(Root);
+		Root->RegisterComponent();
+
+#if WITH_EDITOR
+		HostActor->SetActorLabel(TEXT("FragmentMergedMeshHost"));
+#endif
+	}
+
+	// Query-only: traces hit the merged triangles and resolve them through FindLocalIdForTriangle
+	UStaticMeshComponent* Component = NewObject<UStaticMeshComponent>(HostActor);
+	Component->SetMobility(EComponentMobility::Movable);
+	Component->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	Component->AttachToComponent(HostActor->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	Component->RegisterComponent();
+	HostActor->AddInstanceComponent(Component);
+
+	return Component;
+}
@@ -49,8 +49,10 @@ void UPerSampleVisibilityController::UpdateVisibility(const FVector& CameraPos,
 	// Clear previous results
 	VisibleSamples.Reset();
 
-	const TArray<FFragmentVisibilityData>& AllFragments = Registry->GetAllFragments();
-	const int32 TotalFragments = AllFragments.Num();
+	// Hot arrays only: the cold FFragmentVisibilityData table is never touched here
+	const FFragmentCullingData& Culling = Registry->GetCullingData();
+	const int32 TotalFragments = Culling.Num();
+	check(TotalFragments == Registry->GetFragmentCount());
 
 	// Calculate range for frame spreading (if enabled)
 	int32 StartIndex = 0;
@@ -65,40 +67,42 @@ void UPerSampleVisibilityController::UpdateVisibility(const FVector& CameraPos,
 		CurrentFrameIndex = (CurrentFrameIndex + 1) % FrameSpreadCount;
 	}
 
-	// Pre-compute quality-adjusted threshold
+	// Pre-compute quality-adjusted thresholds
 	const float MinScreen = MinScreenSize * GraphicsQuality;
+	const float GeometryScreen = GeometryScreenSize * GraphicsQuality;
 
 	// === MAIN VISIBILITY LOOP ===
 	// This is the core per-sample evaluation that tests EACH fragment individually
 	for (int32 i = StartIndex; i < EndIndex; ++i)
 	{
-		const FFragmentVisibilityData& Sample = AllFragments[i];
+		const FBox Bounds(FVector(Culling.BoundsMin[i]), FVector(Culling.BoundsMax[i]));
+		const bool bIsSmallObject = EnumHasAnyFlags(Culling.Flags[i], EFragmentCullFlags::SmallObject);
 
 		// === DEBUG MODE: SHOW ALL ===
 		if (bShowAllVisible)
 		{
 			// Skip frustum test, show everything
 			FFragmentVisibilityResult Result;
-			Result.LocalId = Sample.LocalId;
+			Result.LocalId = Culling.LocalIds[i];
 			Result.LodLevel = EFragmentLod::Visible;
 			Result.ScreenSize = ViewportHeight; // Max screen size
 			Result.Distance = 0.0f;
-			Result.MaterialIndex = Sample.MaterialIndex;
-			Result.bIsSmallObject = Sample.bIsSmallObject;
-			Result.BoundsCenter = Sample.WorldBounds.GetCenter();
+			Result.MaterialIndex = Culling.MaterialIndices[i];
+			Result.bIsSmallObject = bIsSmallObject;
+			Result.BoundsCenter = Bounds.GetCenter();
 			VisibleSamples.Add(Result);
 			continue;
 		}
 
 		// === FRUSTUM TEST (per-fragment, not per-tile!) ===
-		if (!IsInFrustum(Sample.WorldBounds))
+		if (!IsInFrustum(Bounds))
 		{
 			continue;
 		}
 
 		// === DISTANCE AND SCREEN SIZE CALCULATION ===
-		const float Distance = GetDistanceToBox(Sample.WorldBounds);
-		const float ScreenSize = CalculateScreenSize(Sample.MaxDimension, Distance);
+		const float Distance = GetDistanceToBox(Bounds);
+		const float ScreenSize = CalculateScreenSize(Culling.MaxDimensions[i], Distance);
 
 		// === SCREEN SIZE CULLING ===
 		if (ScreenSize < MinScreen)
@@ -107,14 +111,15 @@ void UPerSampleVisibilityController::UpdateVisibility(const FVector& CameraPos,
 		}
 
 		// === ADD TO VISIBLE SAMPLES ===
+		// Between the two thresholds only the bounds are worth drawing
 		FFragmentVisibilityResult Result;
-		Result.LocalId = Sample.LocalId;
-		Result.LodLevel = EFragmentLod::Visible;
+		Result.LocalId = Culling.LocalIds[i];
+		Result.LodLevel = (ScreenSize < GeometryScreen) ? EFragmentLod::Wires : EFragmentLod::Visible;
 		Result.ScreenSize = ScreenSize;
 		Result.Distance = Distance;
-		Result.MaterialIndex = Sample.MaterialIndex;
-		Result.bIsSmallObject = Sample.bIsSmallObject;
-		Result.BoundsCenter = Sample.WorldBounds.GetCenter();
+		Result.MaterialIndex = Culling.MaterialIndices[i];
+		Result.bIsSmallObject = bIsSmallObject;
+		Result.BoundsCenter = Bounds.GetCenter();
 
 		VisibleSamples.Add(Result);
 	}
@@ -144,6 +149,40 @@ bool UPerSampleVisibilityController::NeedsUpdate(const FVector& NewPosition, con
 	return RotationChange >= MinCameraRotation;
 }
 
+float UPerSampleVisibilityController::GetCullDistance(float MaxDimension) const
+{
+	return GetCullDistanceAtScale(MaxDimension, GetCullDistanceScale());
+}
+
+float UPerSampleVisibilityController::GetCullDistanceAtScale(float MaxDimension, float Scale)
+{
+	if (Scale <= 0.0f || MaxDimension <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	// The engine measures from the bounds center: add half the bounds diagonal (at most sqrt(3) / 2 * MaxDimension)
+	return MaxDimension * Scale + MaxDimension * 0.866f;
+}
+
+float UPerSampleVisibilityController::GetCullDistanceScale() const
+{
+	if (bShowAllVisible || ViewState.OrthogonalDimension > 0.0f)
+	{
+		return 0.0f;
+	}
+
+	// ScreenSize = MaxDimension / (Distance * tan(FOV / 2)) * ViewportHeight, solved for ScreenSize = MinScreen
+	const float MinScreen = MinScreenSize * GraphicsQuality;
+	const float TanHalfFOV = FMath::Tan(FMath::DegreesToRadians(ViewState.FOV * 0.5f));
+	if (MinScreen <= KINDA_SMALL_NUMBER || TanHalfFOV <= KINDA_SMALL_NUMBER)
+	{
+		return 0.0f;
+	}
+
+	return ViewState.ViewportHeight / (MinScreen * TanHalfFOV);
+}
+
 int32 UPerSampleVisibilityController::GetCountByLod(EFragmentLod LodLevel) const
 {
 	int32 Count = 0;
@@ -157,8 +196,6 @@ int32 UPerSampleVisibilityController::GetCountByLod(EFragmentLod LodLevel) const
 	return Count;
 }
 
-// EvaluateLod removed - simplified to just Visible/Invisible based on frustum and screen size
-
 float UPerSampleVisibilityController::GetViewDimension(float Distance) const
 {
 	// Port of engine_fragment's getViewDimension()
@@ -0,0 +1,213 @@
+#include "Misc/AutomationTest.h"
+#include "Utils/TriangulationBackend.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/** Normal the prepared polygon was projected along; backends emit triangles CCW around it */
+	FVector GetProjectionNormal(const FTriangulationPolygon& Polygon)
+	{
+		return FVector::CrossProduct(Polygon.Projection.AxisX, Polygon.Projection.AxisY);
+	}
+
+	/**
+	 * Sum the area of a triangle list.
+	 * @param OutFlipped Receives the number of triangles not CCW around PlaneNormal
+	 * @return Total area in cm²
+	 */
+	double SumTriangleArea(const TArray<FVector>& Vertices, const TArray<int32>& Indices, const FVector& PlaneNormal, int32& OutFlipped)
+	{
+		OutFlipped = 0;
+		double Area = 0.0;
+		for (int32 i = 0; i + 2 < Indices.Num(); i += 3)
+		{
+			const FVector Cross = FVector::CrossProduct(Vertices[Indices[i + 1]] - Vertices[Indices[i]], Vertices[Indices[i + 2]] - Vertices[Indices[i]]);
+			OutFlipped += FVector::DotProduct(Cross, PlaneNormal) > 0.0 ? 0 : 1;
+			Area += Cross.Size() * 0.5;
+		}
+		return Area;
+	}
+
+	/** Append an axis-aligned square contour in the XY plane, counter-clockwise seen from +Z */
+	TArray<int32> AddSquare(TArray<FVector>& Points, double MinX, double MinY, double Size)
+	{
+		const int32 Base = Points.Num();
+		Points.Add(FVector(MinX, MinY, 0));
+		Points.Add(FVector(MinX + Size, MinY, 0));
+		Points.Add(FVector(MinX + Size, MinY + Size, 0));
+		Points.Add(FVector(MinX, MinY + Size, 0));
+		return { Base, Base + 1, Base + 2, Base + 3 };
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFragmentsEarClippingSquareWithHoleTest,
+	"FragmentsUnreal.Triangulation.EarClippingSquareWithHole",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFragmentsEarClippingSquareWithHoleTest::RunTest(const FString& Parameters)
+{
+	// 100 cm square with a centered 50 cm hole, both authored in the same direction
+	TArray<FVector> Points;
+	const TArray<int32> Profile = AddSquare(Points, 0, 0, 100);
+	const TArray<TArray<int32>> Holes = { AddSquare(Points, 25, 25, 50) };
+
+	FTriangulationPolygon Polygon;
+	if (!TestTrue(TEXT("Polygon prepared"), FTriangulation::PreparePolygon(Points, Profile, Holes, Polygon)))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Auto mode selects ear clipping"), FTriangulation::SelectBackend(Polygon), ETriangulationBackend::EarClipping);
+
+	// Call the backend directly: FTriangulation::Triangulate would hide a failure behind the libtess2 fallback
+	TArray<FVector> Vertices;
+	TArray<int32> Indices;
+	if (!TestTrue(TEXT("Ear clipping succeeds"),
+		FTriangulation::GetBackend(ETriangulationBackend::EarClipping).Triangulate(Polygon, Points, Vertices, Indices)))
+	{
+		return false;
+	}
+
+	// Outer ring plus one bridged hole: n + 2h - 2 triangles
+	TestEqual(TEXT("Triangle count"), Indices.Num() / 3, 8);
+
+	int32 Flipped = 0;
+	const double Area = SumTriangleArea(Vertices, Indices, GetProjectionNormal(Polygon), Flipped);
+	TestEqual(TEXT("Triangles are CCW around the plane normal"), Flipped, 0);
+	TestEqual(TEXT("Triangles cover the square minus the hole"), Area, 7500.0, 0.01);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFragmentsTriangulationDegenerateContourTest,
+	"FragmentsUnreal.Triangulation.DegenerateContour",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFragmentsTriangulationDegenerateContourTest::RunTest(const FString& Parameters)
+{
+	// An outer contour on one line has no area: rejected before any backend runs
+	{
+		const TArray<FVector> Points = { FVector(0, 0, 0), FVector(50, 0, 0), FVector(100, 0, 0), FVector(150, 0, 0) };
+		const TArray<int32> Profile = { 0, 1, 2, 3 };
+
+		AddExpectedError(TEXT("Failed to find non-collinear points"), EAutomationExpectedErrorFlags::Contains, 1);
+		AddExpectedError(TEXT("Contour is colinear"), EAutomationExpectedErrorFlags::Contains, 1);
+
+		TArray<FVector> Vertices;
+		TArray<int32> Indices;
+		TestFalse(TEXT("Collinear profile is rejected"),
+			FTriangulation::Triangulate(ETriangulationBackend::Auto, Points, Profile, {}, Vertices, Indices));
+		TestEqual(TEXT("No triangles for a collinear profile"), Indices.Num(), 0);
+	}
+
+	// A collinear midpoint and a repeated closing point are cleaned up, not fatal
+	{
+		const TArray<FVector> Points = {
+			FVector(0, 0, 0), FVector(50, 0, 0), FVector(100, 0, 0), FVector(100, 100, 0), FVector(0, 100, 0), FVector(0, 0, 0)
+		};
+		const TArray<int32> Profile = { 0, 1, 2, 3, 4, 5 };
+
+		FTriangulationPolygon Polygon;
+		if (!TestTrue(TEXT("Polygon with a collinear midpoint prepared"), FTriangulation::PreparePolygon(Points, Profile, {}, Polygon)))
+		{
+			return false;
+		}
+		TestEqual(TEXT("Repeated closing point dropped"), Polygon.Points2D.Num(), 5);
+
+		TArray<FVector> Vertices;
+		TArray<int32> Indices;
+		if (!TestTrue(TEXT("Ear clipping succeeds around the collinear midpoint"),
+			FTriangulation::GetBackend(ETriangulationBackend::EarClipping).Triangulate(Polygon, Points, Vertices, Indices)))
+		{
+			return false;
+		}
+
+		int32 Flipped = 0;
+		const double Area = SumTriangleArea(Vertices, Indices, GetProjectionNormal(Polygon), Flipped);
+		TestEqual(TEXT("Triangle count"), Indices.Num() / 3, 3);
+		TestEqual(TEXT("Triangles are CCW around the plane normal"), Flipped, 0);
+		TestEqual(TEXT("Triangles cover the square"), Area, 10000.0, 0.01);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFragmentsTriangulationLibTess2SelectionTest,
+	"FragmentsUnreal.Triangulation.LibTess2Selection",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FFragmentsTriangulationLibTess2SelectionTest::RunTest(const FString& Parameters)
+{
+	// More holes than ear clipping takes: 300 cm square with a 3x3 grid of 50 cm openings
+	{
+		TArray<FVector> Points;
+		const TArray<int32> Profile = AddSquare(Points, 0, 0, 300);
+		TArray<TArray<int32>> Holes;
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			for (int32 Col = 0; Col < 3; ++Col)
+			{
+				Holes.Add(AddSquare(Points, 25 + Col * 100, 25 + Row * 100, 50));
+			}
+		}
+
+		FTriangulationPolygon Polygon;
+		if (!TestTrue(TEXT("Polygon with nine holes prepared"), FTriangulation::PreparePolygon(Points, Profile, Holes, Polygon)))
+		{
+			return false;
+		}
+		TestTrue(TEXT("Hole count exceeds the ear clipping limit"), Polygon.GetContourCount() - 1 > FTriangulation::EarClippingMaxHoles);
+		TestEqual(TEXT("Auto mode selects libtess2 for many holes"), FTriangulation::SelectBackend(Polygon), ETriangulationBackend::LibTess2);
+
+		TArray<FVector> Vertices;
+		TArray<int32> Indices;
+		if (!TestTrue(TEXT("Auto triangulation succeeds with nine holes"),
+			FTriangulation::Triangulate(ETriangulationBackend::Auto, Points, Profile, Holes, Vertices, Indices)))
+		{
+			return false;
+		}
+
+		int32 Flipped = 0;
+		const double Area = SumTriangleArea(Vertices, Indices, GetProjectionNormal(Polygon), Flipped);
+		TestEqual(TEXT("Triangles are CCW around the plane normal"), Flipped, 0);
+		TestEqual(TEXT("Triangles cover the square minus the holes"), Area, 90000.0 - 9 * 2500.0, 0.01);
+	}
+
+	// More points than ear clipping takes: a 72-sided disc of radius 100 cm
+	{
+		constexpr int32 Sides = 72;
+		TArray<FVector> Points;
+		TArray<int32> Profile;
+		for (int32 i = 0; i < Sides; ++i)
+		{
+			const double Angle = 2.0 * UE_DOUBLE_PI * i / Sides;
+			Profile.Add(Points.Add(FVector(100.0 * FMath::Cos(Angle), 100.0 * FMath::Sin(Angle), 0)));
+		}
+
+		FTriangulationPolygon Polygon;
+		if (!TestTrue(TEXT("Disc prepared"), FTriangulation::PreparePolygon(Points, Profile, {}, Polygon)))
+		{
+			return false;
+		}
+		TestTrue(TEXT("Point count exceeds the ear clipping limit"), Polygon.Points2D.Num() > FTriangulation::EarClippingMaxPoints);
+		TestEqual(TEXT("Auto mode selects libtess2 for many points"), FTriangulation::SelectBackend(Polygon), ETriangulationBackend::LibTess2);
+
+		TArray<FVector> Vertices;
+		TArray<int32> Indices;
+		if (!TestTrue(TEXT("Auto triangulation succeeds for the disc"),
+			FTriangulation::Triangulate(ETriangulationBackend::Auto, Points, Profile, {}, Vertices, Indices)))
+		{
+			return false;
+		}
+
+		int32 Flipped = 0;
+		const double Area = SumTriangleArea(Vertices, Indices, GetProjectionNormal(Polygon), Flipped);
+		const double ExpectedArea = 0.5 * Sides * 100.0 * 100.0 * FMath::Sin(2.0 * UE_DOUBLE_PI / Sides);
+		TestEqual(TEXT("Triangles are CCW around the plane normal"), Flipped, 0);
+		TestEqual(TEXT("Triangles cover the disc"), Area, ExpectedArea, 0.01);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
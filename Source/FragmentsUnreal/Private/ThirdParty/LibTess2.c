@@ -0,0 +1,30 @@
+/*
+ * libtess2 compiled into the module from ThirdParty/libtess2/Source so every
+ * target platform gets the same tesselator (no prebuilt per-platform libs).
+ * Kept as a single C translation unit so unity builds cannot mix it with C++.
+ * Sources are included by relative path so libtess2's internal headers
+ * (mesh.h, dict.h, geom.h, ...) never end up on the module include path.
+ */
+
+#if defined(_MSC_VER)
+#pragma warning(push, 0)
+#elif defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#endif
+
+#include "../../../../ThirdParty/libtess2/Source/bucketalloc.c"
+#include "../../../../ThirdParty/libtess2/Source/dict.c"
+#include "../../../../ThirdParty/libtess2/Source/geom.c"
+#include "../../../../ThirdParty/libtess2/Source/mesh.c"
+/* geom.c and priorityq.c both define a local Swap macro */
+#undef Swap
+#include "../../../../ThirdParty/libtess2/Source/priorityq.c"
+#include "../../../../ThirdParty/libtess2/Source/sweep.c"
+#include "../../../../ThirdParty/libtess2/Source/tess.c"
+
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#elif defined(__clang__)
+#pragma clang diagnostic pop
+#endif
@@ -0,0 +1,438 @@
+#include "Utils/ShellCanonicalForm.h"
+#include "Utils/FragmentsUtils.h"
+#include "Hash/CityHash.h"
+#include "Algo/Sort.h"
+
+namespace
+{
+	/** Principal axes closer than this fraction of the largest variance are treated as degenerate */
+	constexpr double DegenerateAxisRatio = 1e-2;
+
+	/** Extents are rounded to this many tolerances for the bucket key */
+	constexpr double ExtentStepInTolerances = 20.0;
+
+	uint64 HashValue(int64 Value, uint64 Hash)
+	{
+		return CityHash64WithSeed(reinterpret_cast<const char*>(&Value), sizeof(Value), Hash);
+	}
+
+	/**
+	 * Eigen decomposition of a symmetric 3x3 matrix (cyclic Jacobi).
+	 * @param A Matrix, destroyed; its diagonal holds the eigenvalues on return
+	 * @param OutVectors Eigenvector of each diagonal entry
+	 */
+	void SolveSymmetricEigen(double A[3][3], FVector OutVectors[3])
+	{
+		double V[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+		static constexpr int32 Pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+
+		for (int32 Sweep = 0; Sweep < 32; ++Sweep)
+		{
+			const double Off = A[0][1] * A[0][1] + A[0][2] * A[0][2] + A[1][2] * A[1][2];
+			const double Diag = A[0][0] * A[0][0] + A[1][1] * A[1][1] + A[2][2] * A[2][2];
+			if (Off <= 1e-30 * Diag)
+			{
+				break;
+			}
+
+			for (const auto& Pair : Pairs)
+			{
+				const int32 P = Pair[0];
+				const int32 Q = Pair[1];
+				const double Apq = A[P][Q];
+				if (Apq == 0.0)
+				{
+					continue;
+				}
+
+				const double Theta = (A[Q][Q] - A[P][P]) / (2.0 * Apq);
+				const double T = (Theta >= 0.0 ? 1.0 : -1.0) / (FMath::Abs(Theta) + FMath::Sqrt(Theta * Theta + 1.0));
+				const double C = 1.0 / FMath::Sqrt(T * T + 1.0);
+				const double S = T * C;
+
+				A[P][P] -= T * Apq;
+				A[Q][Q] += T * Apq;
+				A[P][Q] = A[Q][P] = 0.0;
+
+				const int32 R = 3 - P - Q;
+				const double Arp = A[R][P];
+				const double Arq = A[R][Q];
+				A[R][P] = A[P][R] = C * Arp - S * Arq;
+				A[R][Q] = A[Q][R] = S * Arp + C * Arq;
+
+				for (int32 Row = 0; Row < 3; ++Row)
+				{
+					const double Vrp = V[Row][P];
+					const double Vrq = V[Row][Q];
+					V[Row][P] = C * Vrp - S * Vrq;
+					V[Row][Q] = S * Vrp + C * Vrq;
+				}
+			}
+		}
+
+		for (int32 Col = 0; Col < 3; ++Col)
+		{
+			OutVectors[Col] = FVector(V[0][Col], V[1][Col], V[2][Col]).GetSafeNormal();
+		}
+	}
+
+	/**
+	 * Orient an isolated axis so the vertices are skewed towards +Axis.
+	 * Shells symmetric along the axis fall back to the farthest vertex; if that ties too,
+	 * both orientations give the same canonical shape.
+	 * @param OutSkew Normalized third moment along the axis (how reliable the chosen sign is)
+	 */
+	FVector OrientAxis(const TArray<FVector>& Centered, const FVector& Axis, double Tolerance, double& OutSkew)
+	{
+		double M2 = 0.0;
+		double M3 = 0.0;
+		double MaxD = 0.0;
+		double MinD = 0.0;
+		for (const FVector& P : Centered)
+		{
+			const double D = FVector::DotProduct(P, Axis);
+			M2 += D * D;
+			M3 += D * D * D;
+			MaxD = FMath::Max(MaxD, D);
+			MinD = FMath::Min(MinD, D);
+		}
+
+		const double Sigma3 = FMath::Pow(M2 / Centered.Num(), 1.5) * Centered.Num();
+		OutSkew = Sigma3 > 0.0 ? FMath::Abs(M3) / Sigma3 : 0.0;
+		if (OutSkew > 1e-3)
+		{
+			return M3 < 0.0 ? -Axis : Axis;
+		}
+		return (-MinD > MaxD + Tolerance) ? -Axis : Axis;
+	}
+
+	/**
+	 * Direction to the vertex farthest from Axis (from the centroid if Axis is zero),
+	 * perpendicular to Axis. Distances are compared in Tolerance steps so symmetric
+	 * candidates tie; ties prefer the vertex farther along Axis.
+	 * @return Unit direction, or zero if every vertex lies on the axis
+	 */
+	FVector FarthestDirection(const TArray<FVector>& Centered, const FVector& Axis, double Tolerance)
+	{
+		int64 BestRadius = 0;
+		int64 BestHeight = TNumericLimits<int64>::Lowest();
+		FVector Best = FVector::ZeroVector;
+
+		for (const FVector& P : Centered)
+		{
+			const double Along = FVector::DotProduct(P, Axis);
+			const FVector Radial = P - Along * Axis;
+			const int64 Radius = FMath::RoundToInt64(Radial.Size() / Tolerance);
+			const int64 Height = FMath::RoundToInt64(Along / Tolerance);
+			if (Radius > BestRadius || (Radius == BestRadius && Radius > 0 && Height > BestHeight))
+			{
+				BestRadius = Radius;
+				BestHeight = Height;
+				Best = Radial;
+			}
+		}
+
+		return BestRadius > 0 ? Best.GetSafeNormal() : FVector::ZeroVector;
+	}
+
+	/**
+	 * Hash of a closed loop of remapped vertex indices, started at its smallest index so the
+	 * result does not depend on where the loop was authored to begin. Winding is kept.
+	 * @return 0 if the loop references a vertex that does not exist
+	 */
+	uint64 HashLoop(const TArray<int32>& Loop, const TArray<int32>& Remap)
+	{
+		int32 Start = 0;
+		for (int32 i = 0; i < Loop.Num(); ++i)
+		{
+			if (!Remap.IsValidIndex(Loop[i]))
+			{
+				return 0;
+			}
+			if (Remap[Loop[i]] < Remap[Loop[Start]])
+			{
+				Start = i;
+			}
+		}
+
+		uint64 Hash = HashValue(Loop.Num(), 0);
+		for (int32 k = 0; k < Loop.Num(); ++k)
+		{
+			Hash = HashValue(Remap[Loop[(Start + k) % Loop.Num()]], Hash);
+		}
+		return Hash;
+	}
+
+	/**
+	 * Sorted hashes of every profile together with its holes, over remapped vertex indices.
+	 * @return false if a loop references a missing vertex
+	 */
+	bool HashProfiles(const FPreExtractedGeometry& Geometry, const TArray<int32>& Remap, TArray<uint64>& OutHashes)
+	{
+		OutHashes.Reset(Geometry.ProfileIndices.Num());
+		TArray<uint64> HoleHashes;
+
+		for (int32 ProfileIndex = 0; ProfileIndex < Geometry.ProfileIndices.Num(); ++ProfileIndex)
+		{
+			uint64 Hash = HashLoop(Geometry.ProfileIndices[ProfileIndex], Remap);
+			if (Hash == 0)
+			{
+				return false;
+			}
+
+			HoleHashes.Reset();
+			if (Geometry.ProfileHoles.IsValidIndex(ProfileIndex))
+			{
+				for (const TArray<int32>& Hole : Geometry.ProfileHoles[ProfileIndex])
+				{
+					const uint64 HoleHash = HashLoop(Hole, Remap);
+					if (HoleHash == 0)
+					{
+						return false;
+					}
+					HoleHashes.Add(HoleHash);
+				}
+			}
+			HoleHashes.Sort();
+			for (uint64 HoleHash : HoleHashes)
+			{
+				Hash = HashValue(static_cast<int64>(HoleHash), Hash);
+			}
+
+			OutHashes.Add(Hash);
+		}
+
+		OutHashes.Sort();
+		return true;
+	}
+
+	/** Vertices bucketed into cubes of one tolerance, for nearest-vertex lookups */
+	struct FVertexGrid
+	{
+		TMultiMap<FIntVector, int32> Cells;
+		const TArray<FVector>* Points = nullptr;
+		double Tolerance = 1.0;
+
+		FVertexGrid(const TArray<FVector>& InPoints, double InTolerance)
+			: Points(&InPoints), Tolerance(InTolerance)
+		{
+			Cells.Reserve(InPoints.Num());
+			for (int32 i = 0; i < InPoints.Num(); ++i)
+			{
+				Cells.Add(ToCell(InPoints[i]), i);
+			}
+		}
+
+		FIntVector ToCell(const FVector& P) const
+		{
+			return FIntVector(FMath::FloorToInt(P.X / Tolerance), FMath::FloorToInt(P.Y / Tolerance), FMath::FloorToInt(P.Z / Tolerance));
+		}
+
+		/** @return Lowest index among the closest vertices within Tolerance of P, or INDEX_NONE */
+		int32 FindNearest(const FVector& P) const
+		{
+			const FIntVector Cell = ToCell(P);
+			int32 Best = INDEX_NONE;
+			double BestDistSq = Tolerance * Tolerance;
+
+			for (int32 X = -1; X <= 1; ++X)
+			for (int32 Y = -1; Y <= 1; ++Y)
+			for (int32 Z = -1; Z <= 1; ++Z)
+			{
+				for (auto It = Cells.CreateConstKeyIterator(Cell + FIntVector(X, Y, Z)); It; ++It)
+				{
+					const double DistSq = FVector::DistSquared((*Points)[It.Value()], P);
+					if (DistSq < BestDistSq || (DistSq == BestDistSq && Best != INDEX_NONE && It.Value() < Best))
+					{
+						BestDistSq = DistSq;
+						Best = It.Value();
+					}
+				}
+			}
+			return Best;
+		}
+	};
+}
+
+bool FShellCanonicalForm::Compute(const FPreExtractedGeometry& Geometry, double Tolerance, FShellCanonicalForm& OutForm)
+{
+	OutForm = FShellCanonicalForm();
+
+	const TArray<FVector>& Vertices = Geometry.Vertices;
+	if (Vertices.Num() < 3 || Geometry.ProfileIndices.Num() == 0 || Tolerance <= 0.0)
+	{
+		return false;
+	}
+
+	FVector Centroid = FVector::ZeroVector;
+	for (const FVector& V : Vertices)
+	{
+		Centroid += V;
+	}
+	Centroid /= Vertices.Num();
+
+	TArray<FVector> Centered;
+	Centered.Reserve(Vertices.Num());
+	double Cov[3][3] = {};
+	for (const FVector& V : Vertices)
+	{
+		const FVector& D = Centered.Add_GetRef(V - Centroid);
+		for (int32 Row = 0; Row < 3; ++Row)
+		{
+			for (int32 Col = Row; Col < 3; ++Col)
+			{
+				Cov[Row][Col] += D[Row] * D[Col];
+			}
+		}
+	}
+	Cov[1][0] = Cov[0][1];
+	Cov[2][0] = Cov[0][2];
+	Cov[2][1] = Cov[1][2];
+
+	FVector Axes[3];
+	SolveSymmetricEigen(Cov, Axes);
+
+	// Sort the principal axes by decreasing variance
+	int32 Order[3] = { 0, 1, 2 };
+	Algo::Sort(Order, [&Cov](int32 A, int32 B) { return Cov[A][A] > Cov[B][B]; });
+	const double L0 = Cov[Order[0]][Order[0]];
+	const double L1 = Cov[Order[1]][Order[1]];
+	const double L2 = Cov[Order[2]][Order[2]];
+	if (L0 <= Tolerance * Tolerance * Vertices.Num() * KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	const double Gap = DegenerateAxisRatio * L0;
+	const bool bFirstIsolated = L0 - L1 > Gap;
+	const bool bLastIsolated = L1 - L2 > Gap;
+
+	FVector X, Y, Z;
+	double SkewX = 0.0;
+	double SkewY = 0.0;
+	double SkewZ = 0.0;
+	if (bFirstIsolated && bLastIsolated)
+	{
+		X = OrientAxis(Centered, Axes[Order[0]], Tolerance, SkewX);
+		Y = OrientAxis(Centered, Axes[Order[1]], Tolerance, SkewY);
+		Z = OrientAxis(Centered, Axes[Order[2]], Tolerance, SkewZ);
+
+		// Keep the frame right-handed by flipping the axis whose sign is least certain
+		// (a symmetric one, where either sign gives the same shape)
+		if (FVector::DotProduct(FVector::CrossProduct(X, Y), Z) < 0.0)
+		{
+			if (SkewX <= SkewY && SkewX <= SkewZ)
+			{
+				X = -X;
+			}
+			else if (SkewY <= SkewZ)
+			{
+				Y = -Y;
+			}
+		}
+		Z = FVector::CrossProduct(X, Y);
+	}
+	else if (bFirstIsolated)
+	{
+		X = OrientAxis(Centered, Axes[Order[0]], Tolerance, SkewX);
+		Y = FarthestDirection(Centered, X, Tolerance);
+		Z = FVector::CrossProduct(X, Y);
+	}
+	else if (bLastIsolated)
+	{
+		Z = OrientAxis(Centered, Axes[Order[2]], Tolerance, SkewZ);
+		X = FarthestDirection(Centered, Z, Tolerance);
+		Y = FVector::CrossProduct(Z, X);
+	}
+	else
+	{
+		X = FarthestDirection(Centered, FVector::ZeroVector, Tolerance);
+		Y = FarthestDirection(Centered, X, Tolerance);
+		Z = FVector::CrossProduct(X, Y);
+	}
+
+	if (!X.IsNormalized() || !Y.IsNormalized() || !Z.IsNormalized())
+	{
+		return false;
+	}
+
+	// Rows of the matrix are the canonical axes in shell coordinates (right-handed, so no mirroring)
+	OutForm.Frame = FTransform(FQuat(FMatrix(X, Y, Z, FVector::ZeroVector)).GetNormalized(), Centroid);
+
+	FBox Extents(ForceInit);
+	OutForm.CanonicalVertices.Reserve(Centered.Num());
+	for (const FVector& D : Centered)
+	{
+		const FVector& C = OutForm.CanonicalVertices.Add_GetRef(FVector(FVector::DotProduct(D, X), FVector::DotProduct(D, Y), FVector::DotProduct(D, Z)));
+		Extents += C;
+	}
+
+	// Bucket key: only values that equal shapes reproduce regardless of authoring order
+	uint64 Hash = HashValue(Vertices.Num(), 0);
+
+	TArray<int64> LoopSizes;
+	LoopSizes.Reserve(Geometry.ProfileIndices.Num());
+	for (int32 ProfileIndex = 0; ProfileIndex < Geometry.ProfileIndices.Num(); ++ProfileIndex)
+	{
+		int64 Size = Geometry.ProfileIndices[ProfileIndex].Num();
+		if (Geometry.ProfileHoles.IsValidIndex(ProfileIndex))
+		{
+			for (const TArray<int32>& Hole : Geometry.ProfileHoles[ProfileIndex])
+			{
+				Size += static_cast<int64>(Hole.Num()) << 32;
+			}
+		}
+		LoopSizes.Add(Size);
+	}
+	LoopSizes.Sort();
+	for (int64 Size : LoopSizes)
+	{
+		Hash = HashValue(Size, Hash);
+	}
+
+	const double ExtentStep = Tolerance * ExtentStepInTolerances;
+	const FVector Size = Extents.GetSize();
+	Hash = HashValue(FMath::RoundToInt64(Size.X / ExtentStep), Hash);
+	Hash = HashValue(FMath::RoundToInt64(Size.Y / ExtentStep), Hash);
+	Hash = HashValue(FMath::RoundToInt64(Size.Z / ExtentStep), Hash);
+
+	OutForm.ShapeHash = Hash != 0 ? Hash : 1;
+	return true;
+}
+
+bool FShellCanonicalForm::Matches(const FPreExtractedGeometry& Geometry, const FShellCanonicalForm& Other,
+	const FPreExtractedGeometry& OtherGeometry, double Tolerance) const
+{
+	if (ShapeHash != Other.ShapeHash || CanonicalVertices.Num() != Other.CanonicalVertices.Num()
+		|| Geometry.ProfileIndices.Num() != OtherGeometry.ProfileIndices.Num())
+	{
+		return false;
+	}
+
+	// Map both vertex sets onto the other shell's vertices; coincident vertices collapse to one index
+	const FVertexGrid Grid(Other.CanonicalVertices, Tolerance);
+
+	TArray<int32> Remap;
+	Remap.SetNumUninitialized(CanonicalVertices.Num());
+	for (int32 i = 0; i < CanonicalVertices.Num(); ++i)
+	{
+		Remap[i] = Grid.FindNearest(CanonicalVertices[i]);
+		if (Remap[i] == INDEX_NONE)
+		{
+			return false;
+		}
+	}
+
+	TArray<int32> OtherRemap;
+	OtherRemap.SetNumUninitialized(Other.CanonicalVertices.Num());
+	for (int32 i = 0; i < Other.CanonicalVertices.Num(); ++i)
+	{
+		OtherRemap[i] = Grid.FindNearest(Other.CanonicalVertices[i]);
+	}
+
+	TArray<uint64> ProfileHashes;
+	TArray<uint64> OtherProfileHashes;
+	return HashProfiles(Geometry, Remap, ProfileHashes)
+		&& HashProfiles(OtherGeometry, OtherRemap, OtherProfileHashes)
+		&& ProfileHashes == OtherProfileHashes;
+}
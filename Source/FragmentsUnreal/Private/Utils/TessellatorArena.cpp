@@ -0,0 +1,129 @@
+#include "Utils/TessellatorArena.h"
+
+namespace
+{
+	// Every allocation is prefixed with its size so realloc can copy the old payload
+	constexpr SIZE_T TessAllocAlignment = 16;
+	constexpr SIZE_T TessAllocHeader = 16;
+}
+
+FTessellatorArena::FTessellatorArena()
+{
+	FMemory::Memzero(&AllocDesc, sizeof(TESSalloc));
+	AllocDesc.memalloc = &FTessellatorArena::TessAlloc;
+	AllocDesc.memrealloc = &FTessellatorArena::TessRealloc;
+	AllocDesc.memfree = &FTessellatorArena::TessFree;
+	AllocDesc.userData = this;
+	// Building profiles are small; smaller buckets keep the arena footprint tight
+	AllocDesc.meshEdgeBucketSize = 128;
+	AllocDesc.meshVertexBucketSize = 128;
+	AllocDesc.meshFaceBucketSize = 64;
+	AllocDesc.dictNodeBucketSize = 128;
+	AllocDesc.regionBucketSize = 64;
+	AllocDesc.extraVertices = 256;
+}
+
+FTessellatorArena::~FTessellatorArena()
+{
+	for (FBlock& Block : Blocks)
+	{
+		FMemory::Free(Block.Data);
+	}
+	Blocks.Empty();
+}
+
+FTessellatorArena& FTessellatorArena::Get()
+{
+	static thread_local FTessellatorArena Arena;
+	return Arena;
+}
+
+TESStesselator* FTessellatorArena::Acquire()
+{
+	Reset();
+	return tessNewTess(&AllocDesc);
+}
+
+int64 FTessellatorArena::GetReservedBytes() const
+{
+	int64 Total = 0;
+	for (const FBlock& Block : Blocks)
+	{
+		Total += Block.Size;
+	}
+	return Total;
+}
+
+void FTessellatorArena::Reset()
+{
+	if (Blocks.Num() > 1)
+	{
+		// Last polygon spilled into extra blocks: replace them with one block
+		// big enough for that polygon so the next one stays in a single block
+		const SIZE_T Total = (SIZE_T)GetReservedBytes();
+		for (FBlock& Block : Blocks)
+		{
+			FMemory::Free(Block.Data);
+		}
+		Blocks.Reset();
+
+		FBlock& Block = Blocks.AddDefaulted_GetRef();
+		Block.Size = Total;
+		Block.Data = (uint8*)FMemory::Malloc(Total, TessAllocAlignment);
+	}
+
+	for (FBlock& Block : Blocks)
+	{
+		Block.Used = 0;
+	}
+	CurrentBlock = 0;
+}
+
+void* FTessellatorArena::Allocate(SIZE_T Size)
+{
+	const SIZE_T Needed = Align(Size + TessAllocHeader, TessAllocAlignment);
+
+	while (CurrentBlock < Blocks.Num() && Blocks[CurrentBlock].Used + Needed > Blocks[CurrentBlock].Size)
+	{
+		++CurrentBlock;
+	}
+
+	if (CurrentBlock >= Blocks.Num())
+	{
+		FBlock& Block = Blocks.AddDefaulted_GetRef();
+		Block.Size = FMath::Max(DefaultBlockSize, Needed);
+		Block.Data = (uint8*)FMemory::Malloc(Block.Size, TessAllocAlignment);
+		CurrentBlock = Blocks.Num() - 1;
+	}
+
+	FBlock& Block = Blocks[CurrentBlock];
+	uint8* Header = Block.Data + Block.Used;
+	Block.Used += Needed;
+
+	*reinterpret_cast<SIZE_T*>(Header) = Size;
+	return Header + TessAllocHeader;
+}
+
+void* FTessellatorArena::TessAlloc(void* UserData, unsigned int Size)
+{
+	return static_cast<FTessellatorArena*>(UserData)->Allocate(Size);
+}
+
+void* FTessellatorArena::TessRealloc(void* UserData, void* Ptr, unsigned int Size)
+{
+	FTessellatorArena* Arena = static_cast<FTessellatorArena*>(UserData);
+	void* NewPtr = Arena->Allocate(Size);
+
+	if (Ptr)
+	{
+		const SIZE_T OldSize = *reinterpret_cast<SIZE_T*>(static_cast<uint8*>(Ptr) - TessAllocHeader);
+		FMemory::Memcpy(NewPtr, Ptr, FMath::Min<SIZE_T>(OldSize, Size));
+	}
+
+	return NewPtr;
+}
+
+void FTessellatorArena::TessFree(void* UserData, void* Ptr)
+{
+	// Memory is reclaimed in bulk by Reset()
+}
@@ -0,0 +1,614 @@
+#include "Utils/TriangulationBackend.h"
+#include "Utils/TessellatorArena.h"
+#include "Utils/FragmentsLog.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+	/** Twice the signed area of triangle (O, A, B); positive when CCW */
+	FORCEINLINE double Cross2D(const FVector2D& O, const FVector2D& A, const FVector2D& B)
+	{
+		return (A.X - O.X) * (B.Y - O.Y) - (A.Y - O.Y) * (B.X - O.X);
+	}
+
+	/** Twice the signed area of a closed contour; positive when CCW (UFragmentsUtils::IsClockwise with the sign flipped) */
+	double ContourArea2(const FVector2D* P, int32 Num)
+	{
+		double Area = 0.0;
+		for (int32 i = 0, j = Num - 1; i < Num; j = i++)
+		{
+			Area += (P[j].X - P[i].X) * (P[j].Y + P[i].Y);
+		}
+		return Area;
+	}
+
+	/** Append the prepared points as one shared vertex ring; returns the index of its first vertex */
+	int32 AppendRing(const FTriangulationPolygon& Polygon, const TArray<FVector>& Points, TArray<FVector>& OutVertices)
+	{
+		const int32 VertexBase = OutVertices.Num();
+		OutVertices.Reserve(VertexBase + Polygon.SourceIndices.Num());
+		for (int32 SourceIndex : Polygon.SourceIndices)
+		{
+			OutVertices.Add(Points[SourceIndex]);
+		}
+		return VertexBase;
+	}
+
+	// ==========================================
+	// LIBTESS2 BACKEND
+	// ==========================================
+
+	class FLibTess2Backend final : public ITriangulationBackend
+	{
+	public:
+		virtual bool Triangulate(const FTriangulationPolygon& Polygon, const TArray<FVector>& Points,
+			TArray<FVector>& OutVertices, TArray<int32>& OutIndices) override
+		{
+			// Tesselator and contour buffer live in a per-thread arena, rewound for every polygon
+			FTessellatorArena& Arena = FTessellatorArena::Get();
+			TESStesselator* Tess = Arena.Acquire();
+			if (!Tess)
+			{
+				UE_LOG(LogFragments, Error, TEXT("Failed to create tesselator."));
+				return false;
+			}
+
+			TArray<float>& Contour = Arena.ContourScratch;
+			for (int32 C = 0; C < Polygon.GetContourCount(); ++C)
+			{
+				const int32 Start = Polygon.GetContourStart(C);
+				const int32 Num = Polygon.GetContourNum(C);
+
+				Contour.Reset(Num * 2);
+				for (int32 i = Start; i < Start + Num; ++i)
+				{
+					Contour.Add(Polygon.Points2D[i].X);
+					Contour.Add(Polygon.Points2D[i].Y);
+				}
+
+				tessAddContour(Tess, 2, Contour.GetData(), sizeof(float) * 2, Num);
+			}
+
+			// A fixed +Z normal keeps the output CCW in the projection plane, like ear clipping
+			// (a computed normal lets libtess2 pick the orientation from the contour areas)
+			static const TESSreal PlaneNormal[3] = { 0.0f, 0.0f, 1.0f };
+			if (!tessTesselate(Tess, TESS_WINDING_ODD, TESS_POLYGONS, 3, 2, PlaneNormal))
+			{
+				UE_LOG(LogFragments, Error, TEXT("tessTesselate failed."));
+				return false;
+			}
+
+			const int32 VertexCount = tessGetVertexCount(Tess);
+			const TESSreal* Vertices = tessGetVertices(Tess);
+
+			if (VertexCount == 0)
+			{
+				for (int32 C = 0; C < Polygon.GetContourCount(); ++C)
+				{
+					const int32 Start = Polygon.GetContourStart(C);
+					for (int32 i = Start; i < Start + Polygon.GetContourNum(C); ++i)
+					{
+						const FVector& P = Points[Polygon.SourceIndices[i]];
+						UE_LOG(LogFragments, Warning, TEXT("\tPoints of Contour %d X: %.6f, Y: %.6f, Z: %.6f"), C, P.X, P.Y, P.Z);
+					}
+				}
+				return false;
+			}
+
+			// Map tesselator vertices back onto the ring; only vertices created at
+			// contour intersections get a position of their own
+			const TESSindex* VertexIndices = tessGetVertexIndices(Tess);
+			const int32 VertexBase = AppendRing(Polygon, Points, OutVertices);
+
+			TArray<int32, TInlineAllocator<256>> Remap;
+			Remap.SetNumUninitialized(VertexCount);
+			for (int32 i = 0; i < VertexCount; i++)
+			{
+				const int32 Source = VertexIndices[i];
+				if (Source != TESS_UNDEF && Source < Polygon.Points2D.Num())
+				{
+					Remap[i] = VertexBase + Source;
+				}
+				else
+				{
+					Remap[i] = OutVertices.Add(Polygon.Projection.Unproject(FVector2D(Vertices[i * 2], Vertices[i * 2 + 1])));
+				}
+			}
+
+			const int32* Indices = tessGetElements(Tess);
+			const int32 ElementCount = tessGetElementCount(Tess);
+			OutIndices.Reserve(OutIndices.Num() + ElementCount * 3);
+
+			for (int32 i = 0; i < ElementCount; ++i)
+			{
+				const int32* Poly = &Indices[i * 3];
+				for (int j = 0; j < 3; ++j)
+				{
+					int32 Idx = Poly[j];
+					if (Idx != TESS_UNDEF)
+					{
+						OutIndices.Add(Remap[Idx]);
+					}
+				}
+			}
+
+			return true;
+		}
+
+		virtual const TCHAR* GetName() const override { return TEXT("LibTess2"); }
+	};
+
+	// ==========================================
+	// EAR CLIPPING BACKEND
+	// ==========================================
+
+	/**
+	 * Ear clipping with hole bridging (Eberly, "Triangulation by Ear Clipping").
+	 * Holes are spliced into the outer ring through a mutually visible vertex pair,
+	 * then the resulting weakly simple polygon is clipped ear by ear.
+	 */
+	class FEarClippingBackend final : public ITriangulationBackend
+	{
+	public:
+		using FRing = TArray<int32, TInlineAllocator<128>>;
+
+		virtual bool Triangulate(const FTriangulationPolygon& Polygon, const TArray<FVector>& Points,
+			TArray<FVector>& OutVertices, TArray<int32>& OutIndices) override
+		{
+			const TArray<FVector2D>& P = Polygon.Points2D;
+
+			FRing Ring;
+			for (int32 i = 0; i < Polygon.GetContourNum(0); ++i)
+			{
+				Ring.Add(i);
+			}
+
+			// Bridge holes right to left so a bridge never crosses a hole that is not merged yet
+			TArray<TPair<int32, int32>, TInlineAllocator<16>> HoleOrder; // (Contour, rightmost point)
+			for (int32 C = 1; C < Polygon.GetContourCount(); ++C)
+			{
+				int32 Rightmost = Polygon.GetContourStart(C);
+				for (int32 i = Rightmost + 1; i < Polygon.GetContourStart(C) + Polygon.GetContourNum(C); ++i)
+				{
+					if (P[i].X > P[Rightmost].X)
+					{
+						Rightmost = i;
+					}
+				}
+				HoleOrder.Emplace(C, Rightmost);
+			}
+			HoleOrder.Sort([&P](const TPair<int32, int32>& A, const TPair<int32, int32>& B)
+				{
+					return P[A.Value].X > P[B.Value].X;
+				});
+
+			for (const TPair<int32, int32>& Hole : HoleOrder)
+			{
+				if (!BridgeHole(Polygon, Hole.Key, Hole.Value, Ring))
+				{
+					return false;
+				}
+			}
+
+			TArray<int32, TInlineAllocator<384>> Triangles;
+			if (!ClipEars(P, Ring, Triangles))
+			{
+				return false;
+			}
+
+			// Reject results that do not cover the polygon (self-intersections, overlapping holes)
+			double ExpectedArea = 0.0;
+			for (int32 C = 0; C < Polygon.GetContourCount(); ++C)
+			{
+				const double Area = FMath::Abs(ContourArea2(&P[Polygon.GetContourStart(C)], Polygon.GetContourNum(C)));
+				ExpectedArea += (C == 0) ? Area : -Area;
+			}
+			double ClippedArea = 0.0;
+			for (int32 i = 0; i < Triangles.Num(); i += 3)
+			{
+				ClippedArea += Cross2D(P[Triangles[i]], P[Triangles[i + 1]], P[Triangles[i + 2]]);
+			}
+			if (ExpectedArea <= 0.0 || FMath::Abs(ClippedArea - ExpectedArea) > ExpectedArea * 1e-3)
+			{
+				return false;
+			}
+
+			const int32 VertexBase = AppendRing(Polygon, Points, OutVertices);
+
+			OutIndices.Reserve(OutIndices.Num() + Triangles.Num());
+			for (int32 Index : Triangles)
+			{
+				OutIndices.Add(VertexBase + Index);
+			}
+
+			return true;
+		}
+
+		virtual const TCHAR* GetName() const override { return TEXT("EarClipping"); }
+
+	private:
+		/** Splice a hole into the ring through a vertex visible from its rightmost point */
+		static bool BridgeHole(const FTriangulationPolygon& Polygon, int32 Contour, int32 M, FRing& Ring)
+		{
+			const TArray<FVector2D>& P = Polygon.Points2D;
+			const FVector2D& Mp = P[M];
+
+			// Cast a ray from M towards +X and find the closest ring edge it hits
+			double HitX = TNumericLimits<double>::Max();
+			int32 BridgePos = INDEX_NONE;
+
+			for (int32 i = 0; i < Ring.Num(); ++i)
+			{
+				const FVector2D& A = P[Ring[i]];
+				const FVector2D& B = P[Ring[(i + 1) % Ring.Num()]];
+
+				if (A.Y == B.Y || (A.Y > Mp.Y && B.Y > Mp.Y) || (A.Y < Mp.Y && B.Y < Mp.Y))
+				{
+					continue;
+				}
+
+				const double X = A.X + (Mp.Y - A.Y) * (B.X - A.X) / (B.Y - A.Y);
+				if (X >= Mp.X && X < HitX)
+				{
+					HitX = X;
+					// Candidate is the edge endpoint furthest along the ray
+					BridgePos = (A.X > B.X) ? i : (i + 1) % Ring.Num();
+				}
+			}
+
+			if (BridgePos == INDEX_NONE)
+			{
+				return false;
+			}
+
+			// Any ring vertex inside triangle (M, hit, candidate) may block the bridge;
+			// the one with the smallest angle to the ray is always visible from M
+			const FVector2D Hit(HitX, Mp.Y);
+			const FVector2D Candidate = P[Ring[BridgePos]];
+
+			if (!Candidate.Equals(Hit, KINDA_SMALL_NUMBER))
+			{
+				const bool bCCW = Cross2D(Mp, Hit, Candidate) > 0.0;
+				double BestTan = TNumericLimits<double>::Max();
+				double BestDist = TNumericLimits<double>::Max();
+				int32 BestPos = BridgePos;
+
+				for (int32 i = 0; i < Ring.Num(); ++i)
+				{
+					const FVector2D& R = P[Ring[i]];
+					if (i == BridgePos || R.X <= Mp.X)
+					{
+						continue;
+					}
+
+					const double D0 = Cross2D(Mp, Hit, R);
+					const double D1 = Cross2D(Hit, Candidate, R);
+					const double D2 = Cross2D(Candidate, Mp, R);
+					const bool bInside = bCCW
+						? (D0 >= 0.0 && D1 >= 0.0 && D2 >= 0.0)
+						: (D0 <= 0.0 && D1 <= 0.0 && D2 <= 0.0);
+
+					if (!bInside)
+					{
+						continue;
+					}
+
+					const double Tan = FMath::Abs(R.Y - Mp.Y) / (R.X - Mp.X);
+					const double Dist = FVector2D::DistSquared(Mp, R);
+					if (Tan < BestTan || (Tan == BestTan && Dist < BestDist))
+					{
+						BestTan = Tan;
+						BestDist = Dist;
+						BestPos = i;
+					}
+				}
+
+				BridgePos = BestPos;
+			}
+
+			// Ring becomes: ..., Bridge, M, hole..., M, Bridge, ...
+			const int32 Start = Polygon.GetContourStart(Contour);
+			const int32 Num = Polygon.GetContourNum(Contour);
+
+			FRing Splice;
+			Splice.Reserve(Num + 2);
+			for (int32 k = 0; k <= Num; ++k)
+			{
+				Splice.Add(Start + (M - Start + k) % Num);
+			}
+			Splice.Add(Ring[BridgePos]);
+
+			Ring.Insert(Splice.GetData(), Splice.Num(), BridgePos + 1);
+			return true;
+		}
+
+		/** Clip ears from a CCW ring, writing triangle point ids */
+		template <typename OutArrayType>
+		static bool ClipEars(const TArray<FVector2D>& P, const FRing& Ring, OutArrayType& OutTriangles)
+		{
+			const int32 N = Ring.Num();
+			if (N < 3)
+			{
+				return false;
+			}
+
+			// Scale-aware epsilon for degenerate corners
+			FBox2D Bounds(ForceInit);
+			for (int32 Id : Ring)
+			{
+				Bounds += P[Id];
+			}
+			const double Eps = FMath::Max(Bounds.GetSize().SizeSquared() * 1e-12, 1e-12);
+
+			TArray<int32, TInlineAllocator<128>> Prev;
+			TArray<int32, TInlineAllocator<128>> Next;
+			Prev.SetNumUninitialized(N);
+			Next.SetNumUninitialized(N);
+			for (int32 i = 0; i < N; ++i)
+			{
+				Prev[i] = (i + N - 1) % N;
+				Next[i] = (i + 1) % N;
+			}
+
+			auto IsEar = [&](int32 A, int32 B, int32 C) -> bool
+				{
+					const FVector2D& Pa = P[Ring[A]];
+					const FVector2D& Pb = P[Ring[B]];
+					const FVector2D& Pc = P[Ring[C]];
+
+					if (Cross2D(Pa, Pb, Pc) <= Eps)
+					{
+						return false;
+					}
+
+					for (int32 V = Next[C]; V != A; V = Next[V])
+					{
+						const int32 Id = Ring[V];
+						// Bridge duplicates share ids with the corners and never block
+						if (Id == Ring[A] || Id == Ring[B] || Id == Ring[C])
+						{
+							continue;
+						}
+
+						const FVector2D& Pv = P[Id];
+						if (Pv == Pa || Pv == Pb || Pv == Pc)
+						{
+							continue;
+						}
+
+						if (Cross2D(Pa, Pb, Pv) >= 0.0 && Cross2D(Pb, Pc, Pv) >= 0.0 && Cross2D(Pc, Pa, Pv) >= 0.0)
+						{
+							return false;
+						}
+					}
+					return true;
+				};
+
+			auto Unlink = [&](int32 V)
+				{
+					Next[Prev[V]] = Next[V];
+					Prev[Next[V]] = Prev[V];
+				};
+
+			int32 Remaining = N;
+			int32 Cur = 0;
+			int32 Stall = 0;
+
+			while (Remaining > 3)
+			{
+				const int32 A = Prev[Cur];
+				const int32 C = Next[Cur];
+
+				if (IsEar(A, Cur, C))
+				{
+					OutTriangles.Add(Ring[A]);
+					OutTriangles.Add(Ring[Cur]);
+					OutTriangles.Add(Ring[C]);
+					Unlink(Cur);
+					--Remaining;
+					Cur = C;
+					Stall = 0;
+					continue;
+				}
+
+				Cur = C;
+				if (++Stall <= Remaining)
+				{
+					continue;
+				}
+
+				// No ear in a full pass: drop a degenerate corner if there is one, otherwise give up
+				int32 Degenerate = INDEX_NONE;
+				int32 V = Cur;
+				for (int32 k = 0; k < Remaining; ++k, V = Next[V])
+				{
+					if (FMath::Abs(Cross2D(P[Ring[Prev[V]]], P[Ring[V]], P[Ring[Next[V]]])) <= Eps)
+					{
+						Degenerate = V;
+						break;
+					}
+				}
+
+				if (Degenerate == INDEX_NONE)
+				{
+					return false;
+				}
+
+				Cur = Next[Degenerate];
+				Unlink(Degenerate);
+				--Remaining;
+				Stall = 0;
+			}
+
+			const int32 A = Prev[Cur];
+			const int32 C = Next[Cur];
+			if (Cross2D(P[Ring[A]], P[Ring[Cur]], P[Ring[C]]) > Eps)
+			{
+				OutTriangles.Add(Ring[A]);
+				OutTriangles.Add(Ring[Cur]);
+				OutTriangles.Add(Ring[C]);
+			}
+
+			return OutTriangles.Num() > 0;
+		}
+	};
+}
+
+bool FTriangulation::PreparePolygon(const TArray<FVector>& Points,
+	const TArray<int32>& Profile,
+	const TArray<TArray<int32>>& Holes,
+	FTriangulationPolygon& OutPolygon)
+{
+	OutPolygon.Reset();
+	OutPolygon.Projection = UFragmentsUtils::BuildProjectionPlane(Points, Profile);
+
+	auto AddContour = [&](const TArray<int32>& Indices, bool bIsHole) -> bool
+		{
+			TArray<FVector2D>& P = OutPolygon.Points2D;
+			TArray<int32>& Src = OutPolygon.SourceIndices;
+			const int32 Start = P.Num();
+
+			// Project and drop consecutive duplicates (including a repeated closing point)
+			for (int32 Index : Indices)
+			{
+				if (!Points.IsValidIndex(Index))
+				{
+					continue;
+				}
+
+				FVector2D P2d = OutPolygon.Projection.Project(Points[Index]);
+				if (P.Num() == Start || !P2d.Equals(P.Last(), 0.001))
+				{
+					P.Add(P2d);
+					Src.Add(Index);
+				}
+			}
+			if (P.Num() - Start > 1 && P.Last().Equals(P[Start], 0.001))
+			{
+				P.Pop();
+				Src.Pop();
+			}
+
+			const int32 Num = P.Num() - Start;
+			auto Discard = [&]()
+				{
+					P.SetNum(Start);
+					Src.SetNum(Start);
+					return false;
+				};
+
+			if (Num < 3)
+			{
+				UE_LOG(LogFragments, Error, TEXT("Contour has fewer than 3 points, skipping."));
+				return Discard();
+			}
+
+			// Check for colinearity
+			bool bColinear = true;
+			const FVector2D& A = P[Start];
+
+			for (int32 i = Start + 1; i < Start + Num - 1; ++i)
+			{
+				FVector2D Dir1 = (P[i] - A).GetSafeNormal();
+				FVector2D Dir2 = (P[i + 1] - P[i]).GetSafeNormal();
+				if (!Dir1.Equals(Dir2, 0.001f))
+				{
+					bColinear = false;
+					break;
+				}
+			}
+			if (bColinear)
+			{
+				UE_LOG(LogFragments, Error, TEXT("Contour is colinear in 2D projection, skipping."));
+				return Discard();
+			}
+
+			// Fix winding: outer CCW, holes CW
+			const bool bClockwise = ContourArea2(&P[Start], Num) < 0.0;
+			if (!bIsHole)
+			{
+				OutPolygon.bOuterReversed = bClockwise;
+			}
+			if (bIsHole != bClockwise)
+			{
+				TArrayView<FVector2D> PointsView(P.GetData() + Start, Num);
+				TArrayView<int32> SourceView(Src.GetData() + Start, Num);
+				Algo::Reverse(PointsView);
+				Algo::Reverse(SourceView);
+			}
+
+			OutPolygon.ContourStarts.Add(P.Num());
+			return true;
+		};
+
+	if (!AddContour(Profile, false))
+	{
+		return false;
+	}
+
+	for (const TArray<int32>& Hole : Holes)
+	{
+		AddContour(Hole, true);
+	}
+
+	return true;
+}
+
+ETriangulationBackend FTriangulation::SelectBackend(const FTriangulationPolygon& Polygon)
+{
+	// Ear clipping is quadratic in the point count but allocation-free; it wins
+	// comfortably on the small profiles with a few openings that dominate BIM models
+	if (Polygon.Points2D.Num() <= EarClippingMaxPoints && Polygon.GetContourCount() - 1 <= EarClippingMaxHoles)
+	{
+		return ETriangulationBackend::EarClipping;
+	}
+	return ETriangulationBackend::LibTess2;
+}
+
+ITriangulationBackend& FTriangulation::GetBackend(ETriangulationBackend Mode)
+{
+	static FLibTess2Backend LibTess2Backend;
+	static FEarClippingBackend EarClippingBackend;
+
+	return (Mode == ETriangulationBackend::EarClipping)
+		? static_cast<ITriangulationBackend&>(EarClippingBackend)
+		: static_cast<ITriangulationBackend&>(LibTess2Backend);
+}
+
+bool FTriangulation::Triangulate(ETriangulationBackend Mode,
+	const TArray<FVector>& Points,
+	const TArray<int32>& Profile,
+	const TArray<TArray<int32>>& Holes,
+	TArray<FVector>& OutVertices,
+	TArray<int32>& OutIndices)
+{
+	static thread_local FTriangulationPolygon Polygon;
+
+	if (!PreparePolygon(Points, Profile, Holes, Polygon))
+	{
+		return false;
+	}
+
+	return TriangulatePrepared(Mode, Polygon, Points, OutVertices, OutIndices);
+}
+
+bool FTriangulation::TriangulatePrepared(ETriangulationBackend Mode,
+	const FTriangulationPolygon& Polygon,
+	const TArray<FVector>& Points,
+	TArray<FVector>& OutVertices,
+	TArray<int32>& OutIndices)
+{
+	const ETriangulationBackend Selected = (Mode == ETriangulationBackend::Auto) ? SelectBackend(Polygon) : Mode;
+
+	if (Selected == ETriangulationBackend::EarClipping)
+	{
+		if (GetBackend(ETriangulationBackend::EarClipping).Triangulate(Polygon, Points, OutVertices, OutIndices))
+		{
+			return true;
+		}
+		UE_LOG(LogFragments, Verbose, TEXT("Ear clipping failed for %d-point polygon, falling back to libtess2"),
+			Polygon.Points2D.Num());
+	}
+
+	return GetBackend(ETriangulationBackend::LibTess2).Triangulate(Polygon, Points, OutVertices, OutIndices);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FFragmentMeshBuildOptions;
+struct FFragmentMeshBuildData;
+
+/**
+ * Built representation buffers persisted under Saved/FragmentsMeshCache, so later
+ * loads of the same model skip extraction and triangulation of cached representations.
+ *
+ * Entries live in one directory per model content hash, one file per representation:
+ * <RepresentationIndex>_<OptionsHash>.bin. Only the geometry-affecting build options
+ * go into the options hash; the build profile does not, since both profiles start
+ * from the same buffers. Trim keeps the directory under a size budget.
+ *
+ * Every function is thread-safe and may run on a worker thread.
+ */
+class FRAGMENTSUNREAL_API FFragmentDerivedMeshCache
+{
+public:
+	/** Hash of the options that change the built buffers (includes the cache format version) */
+	static uint32 HashOptions(const FFragmentMeshBuildOptions& Options);
+
+	/** Directory holding the entries of one model */
+	static FString GetModelDirectory(uint64 ModelHash);
+
+	/** File of one representation built with options of the given hash */
+	static FString GetEntryFile(uint64 ModelHash, int32 RepresentationIndex, uint32 OptionsHash);
+
+	/**
+	 * List the representations of a model cached for the given options (one directory scan).
+	 * @return Representation indices with an entry on disk
+	 */
+	static TSet<int32> FindCachedRepresentations(uint64 ModelHash, uint32 OptionsHash);
+
+	/**
+	 * Read the LOD buffers and bounds of an entry into OutData.
+	 * @return false if the file is missing, outdated or damaged (OutData is reset)
+	 */
+	static bool Load(const FString& File, FFragmentMeshBuildData& OutData);
+
+	/**
+	 * Write the LOD buffers and bounds of a built representation.
+	 * The file is written under a temporary name and moved in place, so concurrent
+	 * readers never see a partial entry.
+	 * @return true if the entry was stored
+	 */
+	static bool Store(const FString& File, const FFragmentMeshBuildData& Data);
+
+	/**
+	 * Delete whole model directories, least recently written first, until the cache fits the budget.
+	 * @param MaxBytes Size the cache directory may keep
+	 * @param KeepModelHashes Models whose entries are never deleted (the ones being loaded or drawn)
+	 * @return Bytes deleted
+	 */
+	static int64 Trim(int64 MaxBytes, const TSet<uint64>& KeepModelHashes);
+};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshDescription.h"
+#include "Async/Future.h"
+#include "Utils/TriangulationBackend.h"
+
+class FStaticMeshRenderData;
+
+/**
+ * How much processing a built mesh gets.
+ */
+enum class EFragmentMeshBuildProfile : uint8
+{
+	/** Render buffers written directly: flat normals, no lightmap UVs or reversed indices.
+	 *  No collision unless UFragmentsImporter::bRuntimeMeshCollision is set */
+	Runtime,
+
+	/** Mesh description + editor build settings; required for meshes saved as assets */
+	Full
+};
+
+/**
+ * Options for one mesh build, snapshotted on the game thread before the build is queued.
+ */
+struct FFragmentMeshBuildOptions
+{
+	/** Triangulation backend for shell profiles */
+	ETriangulationBackend Backend = ETriangulationBackend::Auto;
+
+	EFragmentMeshBuildProfile Profile = EFragmentMeshBuildProfile::Runtime;
+
+	/** LODs generated for circle extrusions (1 = LOD0 only) */
+	int32 CircleExtrusionLodCount = 3;
+
+	/** Maximum chord deviation of LOD0 circles and arcs, in cm */
+	float CircleTolerance = 0.5f;
+
+	/**
+	 * On-screen deviation (pixels at ReferenceViewportHeight) a coarser LOD may show
+	 * before the finer one is used. Pixels follow UPerSampleVisibilityController::CalculateScreenSize.
+	 */
+	float LodPixelError = 1.0f;
+
+	/** Viewport height the pixel error refers to */
+	float ReferenceViewportHeight = 1080.0f;
+
+	/** Generate simplified LODs for shells */
+	bool bGenerateShellLods = false;
+
+	/** Shells with fewer LOD0 triangles keep a single LOD */
+	int32 ShellLodMinTriangles = 1000;
+
+	/** Decimated shell LODs before the box proxy */
+	int32 ShellLodCount = 2;
+
+	/**
+	 * On-screen size of the mesh (pixels of its largest extent at ReferenceViewportHeight,
+	 * as measured by the visibility controller) the first decimated LOD's grid is sized for.
+	 * Each further LOD halves it; switch sizes come from the measured deviation.
+	 */
+	float ShellLodPixels = 128.0f;
+
+	/** On-screen size of the mesh below which shells are drawn as their bounding box (0 = no proxy) */
+	float ShellProxyPixels = 16.0f;
+};
+
+/**
+ * Buffers for one LOD.
+ */
+struct FFragmentMeshLodData
+{
+	TArray<FVector3f> Positions;
+	TArray<FVector3f> Normals;
+	TArray<FVector3f> Tangents;
+
+	/** Triangle list, three entries per triangle (Unreal front-face winding) */
+	TArray<uint32> Indices;
+
+	/**
+	 * Engine screen size (projected bounds-sphere diameter over the view size,
+	 * 1 = the bounds fill the view) at and below which this LOD replaces the
+	 * finer one (1 for LOD0)
+	 */
+	float ScreenSize = 1.0f;
+
+	/** Mesh description built from the arrays above (Full profile only) */
+	FMeshDescription MeshDescription;
+
+	void Reset()
+	{
+		Positions.Reset();
+		Normals.Reset();
+		Tangents.Reset();
+		Indices.Reset();
+	}
+
+	bool IsValid() const { return Indices.Num() >= 3; }
+	int32 GetTriangleCount() const { return Indices.Num() / 3; }
+};
+
+/**
+ * Triangle range of one fragment inside a merged mesh.
+ */
+struct FFragmentMeshElementRange
+{
+	int32 LocalId = INDEX_NONE;
+	int32 FirstTriangle = 0;
+	int32 NumTriangles = 0;
+};
+
+/**
+ * One sample to be merged: its geometry and where it sits in the merged mesh.
+ */
+struct FFragmentMergeElement
+{
+	int32 LocalId = INDEX_NONE;
+
+	/** Samples with the same representation are tessellated once per merge */
+	int32 RepresentationId = INDEX_NONE;
+
+	FPreExtractedGeometry Geometry;
+
+	/** Derived mesh cache entry to take LOD0 from when the geometry was not extracted */
+	FString DerivedCacheFile;
+
+	/** Sample transform relative to the merged mesh origin */
+	FTransform Transform;
+};
+
+/**
+ * CPU-side mesh data for one representation, produced off the game thread.
+ * Vertices carry final normals (flat per shell profile, smooth around
+ * extruded circles), so the game thread only has to hand the data to the renderer.
+ */
+struct FFragmentMeshBuildData
+{
+	/** LOD0 first, coarser LODs after it with decreasing screen sizes */
+	TArray<FFragmentMeshLodData> Lods;
+
+	/** Render buffers for all LODs (Runtime profile only, moved out on commit) */
+	TUniquePtr<FStaticMeshRenderData> RenderData;
+
+	/** Bounds of the LOD0 positions */
+	FBox3f Bounds = FBox3f(ForceInit);
+
+	/** Per-fragment triangle ranges of LOD0, sorted by FirstTriangle (merged meshes only) */
+	TArray<FFragmentMeshElementRange> Elements;
+
+	FFragmentMeshBuildData();
+	~FFragmentMeshBuildData();
+
+	bool IsValid() const { return Lods.Num() > 0 && Lods[0].IsValid(); }
+	int32 GetTriangleCount() const { return Lods.Num() > 0 ? Lods[0].GetTriangleCount() : 0; }
+};
+
+using FFragmentMeshBuildDataPtr = TSharedPtr<FFragmentMeshBuildData, ESPMode::ThreadSafe>;
+
+/**
+ * Thread-safe mesh data builders. Nothing here touches UObjects, so every
+ * function may run on a worker thread.
+ */
+class FRAGMENTSUNREAL_API FFragmentMeshBuilder
+{
+public:
+	/**
+	 * Triangulate all profiles of a pre-extracted shell into flat-shaded buffers.
+	 * @param Geometry Pre-extracted shell geometry
+	 * @param Backend Triangulation backend for profiles
+	 * @param OutLod Receives positions, normals, tangents and indices
+	 * @return true if at least one triangle was produced
+	 */
+	static bool BuildShellData(const FPreExtractedGeometry& Geometry, ETriangulationBackend Backend, FFragmentMeshLodData& OutLod);
+
+	/**
+	 * Sweep a circle along every part of a pre-extracted circle extrusion.
+	 * Circle and arc segment counts follow from the radii and Tolerance.
+	 * @param Geometry Pre-extracted circle extrusion geometry
+	 * @param Tolerance Maximum chord deviation in cm
+	 * @param MinSegments Lower bound for segments around the circle
+	 * @param OutLod Receives positions, smooth normals, tangents and indices
+	 * @param OutMaxError Largest chord deviation actually produced, in cm
+	 * @return true if at least one triangle was produced
+	 */
+	static bool BuildCircleExtrusionData(const FPreExtractedGeometry& Geometry, float Tolerance, int32 MinSegments,
+		FFragmentMeshLodData& OutLod, float& OutMaxError);
+
+	/**
+	 * Simplify a LOD by vertex clustering: vertices are snapped to a grid of CellSize,
+	 * collapsed triangles dropped and the rest flat-shaded.
+	 * @param Source LOD to simplify
+	 * @param CellSize Grid spacing in cm
+	 * @param OutLod Receives the simplified buffers
+	 * @param OutMaxError Largest distance a source vertex moved, in cm
+	 * @return true if at least one triangle survived
+	 */
+	static bool BuildDecimatedLod(const FFragmentMeshLodData& Source, float CellSize, FFragmentMeshLodData& OutLod, float& OutMaxError);
+
+	/**
+	 * Flat-shaded box covering Bounds, used as the lowest shell LOD.
+	 */
+	static void BuildBoxProxyLod(const FBox3f& Bounds, FFragmentMeshLodData& OutLod);
+
+	/**
+	 * Build every LOD of a representation into OutData.Lods.
+	 * Circle extrusions get up to Options.CircleExtrusionLodCount LODs; shells get
+	 * decimated LODs and a box proxy when Options.bGenerateShellLods is set.
+	 * @return true if LOD0 has at least one triangle
+	 */
+	static bool BuildGeometryData(const FPreExtractedGeometry& Geometry, const FFragmentMeshBuildOptions& Options, FFragmentMeshBuildData& OutData);
+
+	/**
+	 * Engine screen size at which a deviation of Error cm on a mesh of the given
+	 * bounds diameter reaches PixelError pixels on a viewport ViewportHeight pixels tall.
+	 */
+	static float ComputeLodScreenSize(float Error, float BoundsDiameter, float PixelError, float ViewportHeight);
+
+	/**
+	 * Fill the MeshDescription of every LOD from its arrays (single polygon group, one UV channel).
+	 * The material slot name is assigned on the game thread once the material exists.
+	 */
+	static void BuildMeshDescriptions(FFragmentMeshBuildData& OutData);
+
+	/**
+	 * Fill OutData.RenderData with all LODs straight from their arrays.
+	 * Only CPU-side buffers are written; the game thread attaches them to a mesh
+	 * and initializes the RHI resources.
+	 */
+	static void BuildRenderData(FFragmentMeshBuildData& OutData);
+
+	/** Run the output stage matching Profile on already built arrays */
+	static void BuildForProfile(FFragmentMeshBuildData& OutData, EFragmentMeshBuildProfile Profile);
+
+	/**
+	 * Merge many samples into a single-LOD mesh in the space of their common origin.
+	 * Elements of the same fragment must be adjacent; each fragment gets one range in OutData.Elements.
+	 * Elements with a DerivedCacheFile take their buffers from the cache instead of their geometry;
+	 * an unreadable entry leaves the element out unless its geometry was extracted.
+	 * @param Elements Samples to merge with their relative transforms
+	 * @param Options Backend used for shells; LOD settings are ignored
+	 * @return true if at least one triangle was produced
+	 */
+	static bool BuildMergedData(const TArray<FFragmentMergeElement>& Elements, const FFragmentMeshBuildOptions& Options, FFragmentMeshBuildData& OutData);
+
+	/**
+	 * Run BuildMergedData and the Runtime output stage on a thread pool worker.
+	 * @return Future resolving to the build data (IsValid() false on failure)
+	 */
+	static TFuture<FFragmentMeshBuildDataPtr> BuildMergedAsync(TArray<FFragmentMergeElement>&& Elements, const FFragmentMeshBuildOptions& Options);
+
+	/**
+	 * Run both stages for a representation on a thread pool worker.
+	 * The geometry is copied, so the source may be unloaded while the build runs.
+	 * @param Options Backend, profile and LOD settings for the build
+	 * @param DerivedCacheFile Derived mesh cache entry: read instead of building when present,
+	 *        written after a successful build otherwise (empty = no caching)
+	 * @return Future resolving to the build data (IsValid() false on failure)
+	 */
+	static TFuture<FFragmentMeshBuildDataPtr> BuildAsync(const FPreExtractedGeometry& Geometry, const FFragmentMeshBuildOptions& Options,
+		const FString& DerivedCacheFile = FString());
+};
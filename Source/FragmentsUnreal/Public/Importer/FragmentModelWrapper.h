@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Index/index_generated.h"
+#include "Hash/CityHash.h"
 #include "Utils/FragmentsUtils.h"
 #include "Spatial/FragmentRegistry.h"
 #include "FragmentModelWrapper.generated.h"
@@ -25,21 +26,49 @@ private:
 
 	FFragmentItem ModelItem;
 
+	/** Hash of the decompressed model buffer, identifies the model across sessions */
+	uint64 ContentHash = 0;
+
+	/** Build options hash of the derived cache entries samples were loaded without geometry for (0 = none) */
+	uint32 DerivedCacheOptionsHash = 0;
+
 	/** Fragment registry for per-sample visibility (Phase 1 optimization) */
 	UPROPERTY()
 	UFragmentRegistry* FragmentRegistry = nullptr;
 
+	/** ModelItem's tree flattened depth-first, built on first GetItemIndex() */
+	TArray<const FFragmentItem*> Items;
+
+	/** LocalId -> index into Items */
+	TMap<int32, int32> LocalIdToItemIndex;
+
+	/** Flatten ModelItem's tree into Items */
+	void BuildItemIndex();
+
 
 public:
 	void LoadModel(const TArray<uint8>& InBuffer)
 	{
 		RawBuffer = InBuffer;
 		ParsedModel = GetModel(RawBuffer.GetData());
+		ContentHash = CityHash64(reinterpret_cast<const char*>(RawBuffer.GetData()), RawBuffer.Num());
 	}
 
 	const Model* GetParsedModel() const { return ParsedModel; }
 
-	void SetModelItem(FFragmentItem InModelItem) { ModelItem = InModelItem; }
+	/** Hash of the loaded model buffer (derived mesh cache key) */
+	uint64 GetContentHash() const { return ContentHash; }
+
+	/** Pin the options hash returned by UFragmentsImporter::PreExtractAllGeometry */
+	void SetDerivedCacheOptionsHash(uint32 InOptionsHash) { DerivedCacheOptionsHash = InOptionsHash; }
+	uint32 GetDerivedCacheOptionsHash() const { return DerivedCacheOptionsHash; }
+
+	void SetModelItem(FFragmentItem InModelItem)
+	{
+		ModelItem = InModelItem;
+		Items.Reset();
+		LocalIdToItemIndex.Reset();
+	}
 	FFragmentItem GetModelItem() { return ModelItem; }
 	const FFragmentItem& GetModelItemRef() const { return ModelItem; }
 	FFragmentItem& GetModelItemRef() { return ModelItem; }  // Non-const for geometry extraction
@@ -55,4 +84,17 @@ public:
 	 */
 	UFragmentRegistry* GetFragmentRegistry() const { return FragmentRegistry; }
 
+	/**
+	 * Index of a fragment in the flattened item tree, stable until the model item is replaced.
+	 * @param LocalId Fragment to find
+	 * @return Index for GetItemAt, or INDEX_NONE if the model has no such fragment
+	 */
+	int32 GetItemIndex(int32 LocalId);
+
+	/** Fragment item at an index returned by GetItemIndex (nullptr if out of range) */
+	const FFragmentItem* GetItemAt(int32 ItemIndex) const
+	{
+		return Items.IsValidIndex(ItemIndex) ? Items[ItemIndex] : nullptr;
+	}
+
 };
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Instanced fragments of one model, stored as parallel arrays.
+ *
+ * One row per fragment: the instanced group and HISMC instance index it is picked
+ * and highlighted through, and its index in the model's flattened item tree
+ * (UFragmentModelWrapper::GetItemIndex). GlobalId, category and attributes are
+ * read from the model item when a proxy is requested instead of being copied per
+ * fragment. Rows are swap-removed, so row numbers are only valid until the next removal.
+ */
+class FRAGMENTSUNREAL_API FFragmentProxyTable
+{
+public:
+	/**
+	 * Add a fragment, or return its row if it is already in the table.
+	 * @param LocalId Fragment to add
+	 * @param ItemIndex Index of the fragment's item in the model (UFragmentModelWrapper::GetItemIndex)
+	 * @return Row of the fragment
+	 */
+	int32 AddRow(int32 LocalId, int32 ItemIndex);
+
+	/** @return Row of a fragment, or INDEX_NONE */
+	int32 FindRow(int32 LocalId) const
+	{
+		const int32* Row = LocalIdToRow.Find(LocalId);
+		return Row ? *Row : INDEX_NONE;
+	}
+
+	/**
+	 * Remove a fragment (the last row moves into its place).
+	 * @return false if the fragment was not in the table
+	 */
+	bool RemoveRow(int32 LocalId);
+
+	/** Point a row at an instance (INDEX_NONE while the fragment has none in a HISMC) */
+	void SetInstance(int32 Row, uint64 GroupKey, int32 InstanceIndex)
+	{
+		GroupKeys[Row] = GroupKey;
+		InstanceIndices[Row] = InstanceIndex;
+	}
+
+	int32 GetLocalId(int32 Row) const { return LocalIds[Row]; }
+	uint64 GetGroupKey(int32 Row) const { return GroupKeys[Row]; }
+	int32 GetInstanceIndex(int32 Row) const { return InstanceIndices[Row]; }
+	int32 GetItemIndex(int32 Row) const { return ItemIndices[Row]; }
+	int32 Num() const { return LocalIds.Num(); }
+
+	/** Heap bytes held by the table */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Model the fragments belong to */
+	FString ModelGuid;
+
+private:
+	TArray<int32> LocalIds;
+	TArray<uint64> GroupKeys;
+	TArray<int32> InstanceIndices;
+	TArray<int32> ItemIndices;
+
+	/** LocalId -> row */
+	TMap<int32, int32> LocalIdToRow;
+};
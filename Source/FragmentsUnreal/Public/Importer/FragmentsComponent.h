@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Utils/FragmentsUtils.h"
+#include "Engine/HitResult.h"
 #include "FragmentsComponent.generated.h"
 
 
@@ -43,6 +44,24 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Fragments|Importer")
 	AFragment* GetItemByLocalId(int32 LocalId, const FString& ModelGuid);
 
+	/**
+	 * Fragment under a trace hit, actor or HISMC instance (see UFragmentsImporter::PickFragment)
+	 * @param Hit Trace result
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Selection")
+	FFindResult PickFragment(const FHitResult& Hit);
+
+	/**
+	 * Set or clear the selection flag of many fragments with one update per instanced group
+	 * @return Number of fragments whose state changed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Selection")
+	int32 SetFragmentsSelected(const FString& ModelGuid, const TArray<int32>& LocalIds, bool bSelected);
+
+	/** Clear the selection flag of every selected fragment */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Selection")
+	void ClearFragmentSelection();
+
 	/**
 	 * Load fragment asynchronously with automatic tile streaming
 	 * @param Path Path to .frag file
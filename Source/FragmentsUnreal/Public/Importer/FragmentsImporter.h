@@ -7,9 +7,13 @@
 #include "Index/index_generated.h"
 #include "Utils/FragmentsUtils.h"
 #include "Utils/FrameBudgetCoordinator.h"
+#include "Utils/TriangulationBackend.h"
+#include "Importer/FragmentMeshBuilder.h"
 #include "Importer/DeferredPackageSaveManager.h"
+#include "Importer/FragmentProxyTable.h"
 #include "Importer/FragmentsAsyncLoader.h" // Added for async delegate
 #include "Utils/FragmentsLog.h"
+#include "Engine/HitResult.h"
 #include "FragmentsImporter.generated.h"
 
 // Forward Declarations
@@ -17,6 +21,8 @@ class UFragmentsAsyncLoader;
 class UFragmentTileManager;
 class AFragment;
 class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMeshComponent;
+class UPrimitiveComponent;
 
 // Use FlatBuffers Model type
 using Model = ::Model;
@@ -32,6 +38,160 @@ struct FFragmentSpawnTask
 		: FragmentItem(InItem), ParentActor(InParent) {}
 };
 
+// Sample waiting for its representation mesh to be committed
+struct FMeshBuildWaiter
+{
+	// Actor the sample's component is added to (component samples)
+	TWeakObjectPtr<AFragment> Actor;
+
+	// Index into the fragment's samples
+	int32 SampleIndex = INDEX_NONE;
+
+	// Fragment the sample belongs to (one waiter per fragment and sample, see AddMeshBuildWaiter)
+	FFragmentKey Fragment;
+
+	// Spawn priority of the fragment when it last asked for the mesh (lower builds first)
+	float Priority = 0.0f;
+
+	// Instanced samples: identity of the fragment (model, LocalId and category only) and instance placement
+	bool bInstanced = false;
+	FFragmentItem InstanceItem;
+	FTransform WorldTransform;
+	uint8 R = 255;
+	uint8 G = 255;
+	uint8 B = 255;
+	uint8 A = 255;
+	bool bIsGlass = false;
+};
+
+/** Per-category override of the instancing cost model */
+UENUM(BlueprintType)
+enum class EFragmentInstancingMode : uint8
+{
+	/** Decided by the cost model */
+	Auto,
+	/** Drawn by instanced groups whenever the shape repeats */
+	Always,
+	/** Always drawn as components of the fragment actor */
+	Never
+};
+
+// Samples of one geometry + material combination over all loaded models, and the instancing cost model's verdict
+struct FInstancingGroupStats
+{
+	int32 InstanceCount = 0;
+
+	// Estimated triangles of one instance
+	int32 TriangleCount = 0;
+
+	// Category of the first sample counted (decision table only; overrides apply per fragment)
+	FString Category;
+
+	// Cost model terms, in draw calls saved by instancing the group
+	float DrawCallTerm = 0.0f;
+	float TriangleTerm = 0.0f;
+	float MemoryTerm = 0.0f;
+
+	// Sum of the terms minus the group's fixed cost; instanced when >= 0
+	float Benefit = 0.0f;
+	bool bInstanced = false;
+};
+
+// Representation mesh waiting for (or running) its worker build
+struct FMeshBuildRequest
+{
+	FPreExtractedGeometry Geometry;
+	FFragmentMeshBuildOptions Options;
+
+	// Asset name and package of meshes that may be saved (empty = transient runtime mesh)
+	FString MeshName;
+	FString PackagePath;
+
+	// Derived mesh cache entry read or written by the build (empty = cache disabled).
+	// Cleared when a build produced no mesh, so it is retried once from the geometry
+	FString DerivedCacheFile;
+
+	// Content hash of the model that requested the build first (cross-model sharing statistics)
+	uint64 SourceModelKey = 0;
+
+	// Sample the geometry came from, to extract it again if it was skipped for a cache entry that failed
+	FString SourceModelGuid;
+	int32 SourceLocalId = INDEX_NONE;
+	int32 SourceSampleIndex = INDEX_NONE;
+
+	// Lowest spawn priority of the shown fragments waiting on the mesh (lower builds first).
+	// Lowered as waiters arrive, recomputed from the live waiters while the build is queued
+	float Priority = TNumericLimits<float>::Max();
+
+	// Invalid until the build is started on a worker
+	TFuture<FFragmentMeshBuildDataPtr> Future;
+
+	TArray<FMeshBuildWaiter> Waiters;
+};
+
+// Pending instances of a group in Morton order of their translations, prepared on a worker
+struct FPreparedInstanceBatch
+{
+	// Index into the group's PendingInstances of each sorted instance (covers the first Order.Num())
+	TArray<int32> Order;
+
+	// World transforms in sorted order
+	TArray<FTransform> Transforms;
+};
+
+// Worker preparation of the batch an unfinalized group's HISMC is created with
+struct FInstanceBatchPreparation
+{
+	// FInstancedMeshGroup::PendingRevision when the preparation started
+	uint32 Revision = 0;
+
+	// Pending instances of the group the preparation sorts
+	int32 InstanceCount = 0;
+
+	TFuture<FPreparedInstanceBatch> Future;
+};
+
+// Shared mesh of one geometry content hash
+USTRUCT()
+struct FCachedRepresentationMesh
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UStaticMesh* Mesh = nullptr;
+
+	// Content hash of the model the mesh was built for (cross-model sharing statistics)
+	uint64 SourceModelKey = 0;
+
+	// Sample components and instanced groups drawing the mesh
+	int32 RefCount = 0;
+
+	// Render buffer size, charged against ResourceCacheBudgetMB
+	int64 ResourceBytes = 0;
+
+	// FPlatformTime::Seconds() of the last acquire or release (unreferenced meshes are released oldest first)
+	double LastUsedTime = 0.0;
+};
+
+// Pooled material instance of one color
+USTRUCT()
+struct FPooledMaterial
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	class UMaterialInstanceDynamic* Material = nullptr;
+
+	// Component overrides, instanced groups and cached meshes using the material
+	int32 RefCount = 0;
+
+	// Object and render resource size, charged against ResourceCacheBudgetMB
+	int64 ResourceBytes = 0;
+
+	// FPlatformTime::Seconds() of the last acquire or release
+	double LastUsedTime = 0.0;
+};
+
 UCLASS()
 class FRAGMENTSUNREAL_API UFragmentsImporter :public UObject
 {
@@ -66,64 +226,140 @@ public:
 	FFindResult FindFragmentByLocalIdUnified(int32 LocalId, const FString& ModelGuid);
 
 	/**
-	 * Check if a representation+material combination should use GPU instancing.
-	 * @return true if instance count >= InstancingThreshold
+	 * Fragment under a trace hit: the fragment actor hit, the fragment owning the hit HISMC instance,
+	 * or the fragment owning the hit triangle of a merged tile mesh.
+	 * @param Hit Trace result (Item is the instance index for instanced components; merged meshes need
+	 *            FaceIndex, so trace with FCollisionQueryParams::bReturnFaceIndex). Runtime-built meshes are only
+	 *            hit by traces with bRuntimeMeshCollision set
+	 * @return FFindResult with the actor, or the proxy of an instanced or merged fragment; not found for other components
 	 */
-	bool ShouldUseInstancing(int32 RepresentationId, uint32 MaterialHash) const;
+	UFUNCTION(BlueprintCallable, Category = "Fragments")
+	FFindResult PickFragment(const FHitResult& Hit);
 
 	/**
-	 * Get or create an HISMC for a representation+material combination.
+	 * Fragment drawing one HISMC instance, in constant time.
+	 * Read from the group's instance owners rather than the LocalId custom data float, so it is exact for any LocalId.
+	 * @param Component Instanced component that was hit
+	 * @param InstanceIndex Instance index within the component
+	 * @return FFindResult with the fragment's proxy, or not found if the component is not one of the importer's HISMCs
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Fragments")
+	FFindResult PickInstancedFragment(const UPrimitiveComponent* Component, int32 InstanceIndex);
+
+	/**
+	 * Set or clear the selection flag of many fragments at once.
+	 * Instanced fragments get the flag in their HISMC custom data with one render state update per touched
+	 * group; fragment actors get it in the custom primitive data of their components. The flag follows the
+	 * fragment through hides, streaming eviction and respawn until it is cleared.
+	 * @param ModelGuid Model the fragments belong to
+	 * @param LocalIds Fragments to select or deselect
+	 * @param bSelected New selection state
+	 * @return Number of fragments whose state changed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Fragments")
+	int32 SetFragmentsSelected(const FString& ModelGuid, const TArray<int32>& LocalIds, bool bSelected);
+
+	/** Clear the selection flag of every selected fragment, over all models */
+	UFUNCTION(BlueprintCallable, Category = "Fragments")
+	void ClearFragmentSelection();
+
+	/** @return Whether a fragment's selection flag is set */
+	UFUNCTION(BlueprintCallable, Category = "Fragments")
+	bool IsFragmentSelected(const FString& ModelGuid, int32 LocalId) const;
+
+	/**
+	 * Hide or show fragments regardless of streaming, whether drawn by actors, HISMC instances or merged tile meshes.
+	 * Hidden fragments stay hidden when streaming brings them back into view.
+	 * @param ModelGuid Model the fragments belong to
+	 * @param LocalIds Fragments to hide or show
+	 * @param bHidden true to hide
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Fragments")
+	void SetFragmentsHidden(const FString& ModelGuid, const TArray<int32>& LocalIds, bool bHidden);
+
+	/**
+	 * Check if a geometry+material combination should use GPU instancing.
+	 * Decided by the instancing cost model over the samples of every loaded model,
+	 * unless InstancingCategoryOverrides has an entry for the category.
+	 * @param MeshKey Geometry content hash (FPreExtractedGeometry::GeometryHash)
+	 * @param MaterialHash Hash of material properties
+	 * @param Category Category of the fragment the sample belongs to
+	 * @return true if the sample is drawn by an instanced group
+	 */
+	bool ShouldUseInstancing(uint64 MeshKey, uint32 MaterialHash, const FString& Category) const;
+
+	/**
+	 * Check if a sample is drawn by an instanced group rather than its own component.
+	 * @param Category Category of the fragment the sample belongs to
+	 * @return true if its geometry+material combination uses GPU instancing
+	 */
+	bool IsSampleInstanced(const FFragmentSample& Sample, const FString& Category) const;
+
+	/**
+	 * Get or create an HISMC for a geometry+material combination.
 	 * Uses Hierarchical ISM for per-cluster culling performance.
-	 * @param RepresentationId The FlatBuffers representation ID (unique geometry)
+	 * @param MeshKey Geometry content hash (shared by equal shapes of all models)
 	 * @param MaterialHash Hash of material properties
 	 * @param Mesh The static mesh to use for this HISMC
 	 * @param Material The material instance to apply
 	 * @return The HISMC (existing or newly created), or nullptr on failure
 	 */
-	UHierarchicalInstancedStaticMeshComponent* GetOrCreateISMC(int32 RepresentationId, uint32 MaterialHash,
+	UHierarchicalInstancedStaticMeshComponent* GetOrCreateISMC(uint64 MeshKey, uint32 MaterialHash,
 		UStaticMesh* Mesh, UMaterialInstanceDynamic* Material);
 
 	/**
 	 * Queue an instance to be batch-added later (during spawn phase).
 	 * Instances are collected in PendingInstances arrays and batch-added
 	 * when FinalizeAllISMCs() is called after spawning completes.
-	 * @param MaterialAlpha Alpha value from the material (0-255) for occlusion classification
+	 * @param MaterialColor Color of the sample; its alpha classifies occlusion, and it is written
+	 *        to the instance custom data when the shared color material is active
 	 */
-	void QueueInstanceForBatchAdd(int32 RepresentationId, uint32 MaterialHash,
+	void QueueInstanceForBatchAdd(uint64 MeshKey, uint32 MaterialHash,
 		const FTransform& WorldTransform, const FFragmentItem& Item,
-		UStaticMesh* Mesh, UMaterialInstanceDynamic* Material, uint8 MaterialAlpha);
+		UStaticMesh* Mesh, UMaterialInstanceDynamic* Material, const FColor& MaterialColor);
 
 	/**
 	 * Finalize all ISMCs by batch-adding all pending instances.
-	 * Called once after all fragment spawning is complete.
+	 * Called once after all fragment spawning is complete; waits for batches still preparing on workers.
 	 * This avoids the UE5 performance issue of per-instance GPU buffer rebuilds.
 	 */
 	void FinalizeAllISMCs();
 
+	/**
+	 * Create the HISMCs of unfinalized groups whose batches are prepared, within a time budget.
+	 * Groups without a preparation get one started on a worker; at least one prepared group is
+	 * committed per call so a spent frame budget cannot stall finalization.
+	 * @param BudgetMs Game thread time for AddInstances and component registration
+	 */
+	void FinalizeISMCsWithBudget(float BudgetMs);
+
 	/**
 	 * Finalize a single ISMC group by batch-adding its pending instances.
 	 * Used for incremental finalization when pending count exceeds threshold.
-	 * @param ComboKey The RepresentationId + MaterialHash key
+	 * @param ComboKey The geometry + material group key
 	 * @param Group The ISMC group to finalize
-	 * @return Number of instances added, or -1 on failure
+	 * @param bWaitForBatch Wait for (or sort inline) a batch still preparing on a worker; otherwise such a
+	 *        group is left unfinalized with its preparation (re)started, and nothing blocks the game thread
+	 * @return Number of instances added (0 also when the batch is not prepared yet), or -1 on failure
 	 */
-	int32 FinalizeISMCGroup(int64 ComboKey, FInstancedMeshGroup& Group);
+	int32 FinalizeISMCGroup(uint64 ComboKey, FInstancedMeshGroup& Group, bool bWaitForBatch = false);
 
 	/**
-	 * Add a single instance to an existing (already finalized) ISMC.
-	 * Used by TileManager streaming path for incremental instance addition.
-	 * @param RepresentationId The geometry representation ID
+	 * Stage a single instance for an existing (already finalized) ISMC.
+	 * Used by TileManager streaming path for incremental instance addition; staged instances
+	 * are added with the group's other changes in one batch by FlushInstanceVisibility().
+	 * @param MeshKey Geometry content hash
 	 * @param MaterialHash Hash of material properties
 	 * @param WorldTransform Transform for the new instance
 	 * @param Item Fragment item data for proxy creation
 	 * @param Mesh The static mesh (must match existing ISMC mesh)
 	 * @param Material The material instance
-	 * @param MaterialAlpha Alpha value from the material (0-255) for occlusion classification
-	 * @return true if instance was added successfully
+	 * @param MaterialColor Color of the sample (alpha classifies occlusion)
+	 * @return true if the instance was staged for the existing ISMC
 	 */
-	bool AddInstanceToExistingISMC(int32 RepresentationId, uint32 MaterialHash,
+	bool AddInstanceToExistingISMC(uint64 MeshKey, uint32 MaterialHash,
 		const FTransform& WorldTransform, const FFragmentItem& Item,
-		UStaticMesh* Mesh, UMaterialInstanceDynamic* Material, uint8 MaterialAlpha);
+		UStaticMesh* Mesh, UMaterialInstanceDynamic* Material, const FColor& MaterialColor);
 	FString LoadFragment(const FString& FragPath);
 	void ProcessLoadedFragment(const FString& ModelGuid, AActor* InOwnerRef, bool bInSaveMesh);
 	TArray<int32> GetElementsByCategory(const FString& InCategory, const FString& ModelGuid);
@@ -162,11 +398,142 @@ public:
 		return OwnerRef;
 	}
 
+	/** Pooled material for a flat color (glass when alpha < 255), shared with the instanced groups */
+	UMaterialInstanceDynamic* GetColorMaterial(const FColor& Color)
+	{
+		return GetPooledMaterial(Color.R, Color.G, Color.B, Color.A, Color.A < 255);
+	}
+
+	/** First per-instance / per-primitive custom data float holding the RGBA color in shared color material mode */
+	static constexpr int32 InstanceColorCustomDataIndex = 1;
+
+	/** Custom data floats per instance: LocalId, RGBA when the shared color material is active, and the selection flag */
+	FORCEINLINE int32 GetInstanceCustomDataFloats() const
+	{
+		return GetInstanceSelectionCustomDataIndex() + 1;
+	}
+
+	/** Per-instance / per-primitive custom data float holding the selection flag (1 = selected), after the color if any */
+	FORCEINLINE int32 GetInstanceSelectionCustomDataIndex() const
+	{
+		return bSharedColorMaterialActive ? InstanceColorCustomDataIndex + 4 : 1;
+	}
+
+	/**
+	 * Write an instance's color into its custom data (no-op unless the shared color material is active).
+	 * @param Component Instanced component holding the instance
+	 * @param InstanceIndex Instance to color
+	 * @param Color Flat color of the sample
+	 * @param bMarkRenderStateDirty Forwarded to the last SetCustomDataValue call
+	 */
+	void SetInstanceColor(class UInstancedStaticMeshComponent* Component, int32 InstanceIndex, const FColor& Color, bool bMarkRenderStateDirty) const;
+
+	/**
+	 * Give a non-instanced component its flat color: the pooled per-color material, or the
+	 * shared material plus the color in its custom primitive data.
+	 * @param Component Mesh component to color
+	 * @param Color Flat color (glass when alpha < 255)
+	 */
+	void ApplyColorMaterial(class UMeshComponent* Component, const FColor& Color);
+
+	/**
+	 * Drop the references a fragment actor's components hold on cached meshes and pooled materials.
+	 * Call before the actor is destroyed; the resources stay cached until the budget needs the memory.
+	 * @param FragmentActor Actor about to be destroyed
+	 */
+	void ReleaseFragmentResources(AFragment* FragmentActor);
+
+	/**
+	 * Release a streamed-out fragment actor's resources, drop it from ModelFragmentsMap and destroy it,
+	 * so unloading its model later does not release or destroy it again.
+	 * @param FragmentActor Actor to destroy
+	 */
+	void DestroyFragmentActor(AFragment* FragmentActor);
+
+	/**
+	 * Give a fragment actor's sample components the cull distance of the current view and thresholds.
+	 * Called by its tile manager when the view's cull distance scale changed.
+	 * @param FragmentActor Actor whose components are updated
+	 */
+	void RefreshFragmentCullDistance(AFragment* FragmentActor) const;
+
+	/**
+	 * Drop the references one component holds on a cached mesh and a pooled material.
+	 * @param Component Component about to be destroyed
+	 */
+	void ReleaseComponentResources(class UMeshComponent* Component);
+
+	/** Release unreferenced cached meshes and pooled materials, least recently used first, until under ResourceCacheBudgetMB */
+	void TrimResourceCaches();
+
+	/**
+	 * Hide or show the HISMC instances of a fragment (instanced samples only).
+	 * Hidden instances are swap-removed from their HISMC and re-added when shown;
+	 * changes are applied in one batch per group by FlushInstanceVisibility().
+	 * @param ModelGuid Model of the fragment
+	 * @param LocalId Fragment to hide or show
+	 * @param bHidden true to hide
+	 */
+	void SetInstancedFragmentHidden(const FString& ModelGuid, int32 LocalId, bool bHidden);
+
+	/**
+	 * Drop a fragment's HISMC instances, hidden or queued, and its proxy (streaming eviction).
+	 * Spawning the fragment again adds new instances.
+	 * @param ModelGuid Model of the fragment
+	 * @param LocalId Fragment to remove
+	 */
+	void RemoveInstancedFragment(const FString& ModelGuid, int32 LocalId);
+
+	/** Apply staged instance hides, shows, removals and additions: one HISMC update per changed group */
+	void FlushInstanceVisibility();
+
+	// Mesh building helpers (public for TileMerger access)
+
+	/** Snapshot the importer's mesh build settings for a build with the given profile */
+	FFragmentMeshBuildOptions MakeMeshBuildOptions(EFragmentMeshBuildProfile Profile) const;
+
+	/**
+	 * Derived mesh cache entry of a representation for the current build settings.
+	 * @return File path, or empty if the cache is disabled or the model is not loaded
+	 */
+	FString GetDerivedMeshCacheFile(const FString& ModelGuid, int32 RepresentationIndex) const;
+
+	/**
+	 * Whether the cache entries that let a model's geometry be skipped at load match the current
+	 * build settings. When they do not, skipped samples need RestoreSampleGeometry before a build.
+	 * @param ModelGuid Loaded model
+	 */
+	bool IsDerivedMeshCacheCurrent(const FString& ModelGuid) const;
+
+	/**
+	 * Extract a sample's geometry from the model's FlatBuffer again, for samples loaded without it
+	 * because their mesh was in the derived mesh cache.
+	 * @param ModelGuid Model of the sample
+	 * @param LocalId Fragment of the sample
+	 * @param SampleIndex Index of the sample in the fragment's Samples
+	 * @param OutGeometry Receives the full geometry (geometry hash kept)
+	 * @return false if the model is not loaded or the extraction failed
+	 */
+	bool RestoreSampleGeometry(const FString& ModelGuid, int32 LocalId, int32 SampleIndex, FPreExtractedGeometry& OutGeometry);
+
+	/**
+	 * Give a mesh built from worker render data complex-as-simple query collision, so traces hit its
+	 * LOD0 triangles and report their index. Does nothing unless bRuntimeMeshCollision is set.
+	 * Call after SetRenderData and before InitResources.
+	 * @param Mesh Mesh whose render data is set
+	 */
+	void BuildRuntimeCollision(UStaticMesh* Mesh) const;
+
+	/** Incremented whenever the instancing decisions are re-taken (a model was loaded or unloaded) */
+	uint32 GetInstancingDecisionSerial() const { return InstancingDecisionSerial; }
+
 	// Spawn a single fragment actor with its geometry (public for TileManager access)
 	// @param bOutWasInstanced Optional output - set to true if fragment was handled via GPU instancing (no actor created)
 	// @param RemainingBudgetMs Optional budget - if provided and exceeded, spawning stops early. Pass nullptr for unlimited.
 	// @param OutSamplesProcessed Optional output - number of samples actually processed (for partial spawn tracking)
-	AFragment* SpawnSingleFragment(const FFragmentItem& Item, AActor* ParentActor, const Meshes* MeshesRef, bool bSaveMeshes, bool* bOutWasInstanced = nullptr, float* RemainingBudgetMs = nullptr, int32* OutSamplesProcessed = nullptr);
+	// @param SpawnPriority Priority of meshes this fragment has to wait for (lower builds first)
+	// @param ModelKey Content hash of Item's model (UFragmentModelWrapper::GetContentHash), resolved once by the caller
+	AFragment* SpawnSingleFragment(const FFragmentItem& Item, AActor* ParentActor, const Meshes* MeshesRef, uint64 ModelKey, bool bSaveMeshes, bool* bOutWasInstanced = nullptr, float* RemainingBudgetMs = nullptr, int32* OutSamplesProcessed = nullptr, float SpawnPriority = 0.0f);
 
 	// ==========================================
 	// EAGER GEOMETRY EXTRACTION (Public for AsyncLoader access)
@@ -177,10 +544,155 @@ public:
 	 * Populates FFragmentSample::ExtractedGeometry for all samples in the hierarchy.
 	 * This eliminates FlatBuffer dependencies during the spawn phase.
 	 *
+	 * Representations found in the derived mesh cache only get their material and transform extracted.
+	 *
 	 * @param RootItem The root fragment item to process (recursively processes children)
 	 * @param MeshesRef The FlatBuffers meshes reference
+	 * @param ModelHash Content hash of the model for derived mesh cache lookups (0 = extract everything)
+	 * @return Options hash of the cache entries skipped samples rely on (0 if nothing was skipped),
+	 *         for UFragmentModelWrapper::SetDerivedCacheOptionsHash
+	 */
+	uint32 PreExtractAllGeometry(FFragmentItem& RootItem, const Meshes* MeshesRef, uint64 ModelHash = 0);
+
+	/**
+	 * Time every triangulation backend on the profiles with holes of a loaded model.
+	 * Each unique (representation, profile) pair is prepared once and triangulated
+	 * Iterations times per backend; results are logged and returned.
+	 * @param ModelGuid Model to take the profiles from (must be loaded)
+	 * @param Iterations Number of passes over all profiles per backend
+	 * @return Human-readable report
 	 */
-	void PreExtractAllGeometry(FFragmentItem& RootItem, const Meshes* MeshesRef);
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Debug")
+	FString BenchmarkTriangulation(const FString& ModelGuid, int32 Iterations = 10);
+
+	/** Get number of mesh lookups served by a mesh built for another loaded model */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Debug")
+	int32 GetCrossModelMeshHits() const { return CrossModelMeshHits; }
+
+	/** Get estimated bytes held by cached representation meshes and pooled materials */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Debug")
+	int64 GetCachedResourceBytes() const { return CachedResourceBytes; }
+
+	/** Get number of representations whose mesh build failed (retried after an unload or a build settings change) */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Debug")
+	int32 GetFailedMeshCount() const { return FailedMeshKeys.Num(); }
+
+	/**
+	 * Log the instancing cost model's table: one row per geometry + material combination of the
+	 * loaded models with its instances, triangles, cost terms and decision, most beneficial first.
+	 * @param MaxRows Rows logged and returned (0 = all)
+	 * @return Human-readable report
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Debug")
+	FString DumpInstancingDecisions(int32 MaxRows = 100) const;
+
+	/** Memory (MB) for cached representation meshes and pooled materials. Entries still drawn are never released;
+	 *  above the budget, unreferenced ones are released least recently used first and rebuilt (or reloaded from the
+	 *  derived mesh cache) when needed again. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (ClampMin = "0", ClampMax = "16384"))
+	int32 ResourceCacheBudgetMB = 512;
+
+	/** Fixed cost of one instanced group, in draw calls: its HISMC, cluster tree and per-instance bookkeeping.
+	 *  A shape is instanced when the draw calls, triangles and memory it saves outweigh this.
+	 *  Decisions are made when models load. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (ClampMin = "0.0"))
+	float InstancingGroupCost = 16.0f;
+
+	/** Triangles of a repeated shape worth one draw call: every extra separately drawn copy resubmits its
+	 *  vertices in each mesh pass, one instanced draw submits them once */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (ClampMin = "1.0"))
+	float InstancingTrianglesPerDrawCall = 1000.0f;
+
+	/** Memory saved (bytes) worth one draw call: components of separately drawn copies against per-instance data */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (ClampMin = "1.0"))
+	float InstancingBytesPerDrawCall = 16384.0f;
+
+	/** Categories (e.g. IfcDoor) always or never instanced, whatever the cost model decides */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance")
+	TMap<FString, EFragmentInstancingMode> InstancingCategoryOverrides;
+
+	/** Give instanced groups and sample components engine cull distances at which their fragments fall below the
+	 *  streaming MinScreenSize (UPerSampleVisibilityController::GetCullDistance), so far small objects are culled
+	 *  by the renderer instead of drawn until streaming evicts them. Applies to components created afterwards;
+	 *  distances follow later view and threshold changes (FOV, viewport, GraphicsQuality, MinScreenSize). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance")
+	bool bAutoCullDistances = true;
+
+	/** Backend used to triangulate profiles with holes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance")
+	ETriangulationBackend TriangulationBackend = ETriangulationBackend::Auto;
+
+	/** LODs generated for circle extrusions (1 = LOD0 only) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (ClampMin = "1", ClampMax = "4"))
+	int32 CircleExtrusionLodCount = 3;
+
+	/** Maximum chord deviation of LOD0 circles and arcs (cm); sets the segment count from the radius */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (ClampMin = "0.01", ClampMax = "10.0"))
+	float CircleExtrusionTolerance = 0.5f;
+
+	/** On-screen deviation (pixels at 1080p) tolerated before switching to a finer LOD */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (ClampMin = "0.1", ClampMax = "16.0"))
+	float LodPixelError = 1.0f;
+
+	/** Generate decimated LODs and a bounding box proxy for dense shell meshes */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance")
+	bool bGenerateShellLods = false;
+
+	/** Shells with fewer triangles than this keep a single LOD */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (EditCondition = "bGenerateShellLods", ClampMin = "12"))
+	int32 ShellLodMinTriangles = 1000;
+
+	/** Decimated shell LODs generated before the box proxy */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (EditCondition = "bGenerateShellLods", ClampMin = "0", ClampMax = "6"))
+	int32 ShellLodCount = 2;
+
+	/** Shell mesh size on screen (pixels at 1080p) the first decimated LOD is simplified for; each further LOD halves it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (EditCondition = "bGenerateShellLods", ClampMin = "8.0", ClampMax = "1080.0"))
+	float ShellLodPixels = 128.0f;
+
+	/** Shell mesh size on screen (pixels at 1080p) below which shells are drawn as their bounding box (0 = no proxy) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (EditCondition = "bGenerateShellLods", ClampMin = "0.0", ClampMax = "256.0"))
+	float ShellProxyPixels = 16.0f;
+
+	/** Keep built representation buffers under Saved/FragmentsMeshCache and reuse them when the same model is loaded again.
+	 *  Cached representations skip geometry extraction; it is done on demand if their entry cannot be used after all. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance")
+	bool bUseDerivedMeshCache = true;
+
+	/** Size Saved/FragmentsMeshCache may grow to; least recently written models are deleted at load beyond it */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (EditCondition = "bUseDerivedMeshCache", ClampMin = "64"))
+	int32 DerivedMeshCacheBudgetMB = 2048;
+
+	/** Match shells that are rotated or translated copies of another shell of the same model during
+	 *  pre-extraction and draw them with that shell's mesh, so exporter-baked placements can still be instanced.
+	 *  Needs every shell's vertices: the derived mesh cache no longer skips extraction while this is on. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance")
+	bool bInstanceRigidDuplicates = false;
+
+	/** Largest vertex deviation (cm) between two shells still drawn with the same mesh */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance", meta = (EditCondition = "bInstanceRigidDuplicates", ClampMin = "0.001", ClampMax = "5.0"))
+	float RigidDuplicateTolerance = 0.1f;
+
+	/** Cook complex-as-simple query collision for runtime-profile and merged tile meshes, so line traces hit them
+	 *  (PickFragment). Each unique mesh is cooked on the game thread when it is committed and keeps a CPU copy of its
+	 *  buffers; leave off unless fragments are picked by tracing. Applies to meshes built afterwards. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Performance")
+	bool bRuntimeMeshCollision = false;
+
+	/** Draw all opaque samples with one material and all glass samples with another, passing the color per instance,
+	 *  so instanced groups are split by geometry only instead of geometry and color.
+	 *  The materials must read the color (RGBA) from PerInstanceCustomData 1-4 on instanced meshes and from
+	 *  CustomPrimitiveData 1-4 on single meshes. Fixed when the first model loads. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Materials")
+	bool bUseSharedColorMaterial = false;
+
+	/** Opaque material for the shared color mode */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Materials", meta = (EditCondition = "bUseSharedColorMaterial"))
+	TSoftObjectPtr<UMaterialInterface> SharedColorMaterial;
+
+	/** Translucent material for the shared color mode (samples with alpha < 255) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Fragments|Materials", meta = (EditCondition = "bUseSharedColorMaterial"))
+	TSoftObjectPtr<UMaterialInterface> SharedColorGlassMaterial;
 
 protected:
 	// Call when Async Loading Completes
@@ -269,23 +781,103 @@ private:
 	 * @param Sample The sample to extract geometry for (modified in place)
 	 * @param MeshesRef The FlatBuffers meshes reference
 	 * @param ItemLocalId The local ID of the containing fragment (for logging)
+	 * @param bMeshCached The representation mesh is in the derived mesh cache: skip vertices, profiles and axes
 	 * @return true if geometry was extracted successfully, false otherwise
 	 */
-	bool ExtractSampleGeometry(FFragmentSample& Sample, const Meshes* MeshesRef, int32 ItemLocalId);
+	bool ExtractSampleGeometry(FFragmentSample& Sample, const Meshes* MeshesRef, int32 ItemLocalId, bool bMeshCached = false);
+
+	/**
+	 * Point shells that are rigid copies of an earlier shell at that shell's geometry.
+	 * Each shell representation is brought into its canonical frame (FShellCanonicalForm) and
+	 * compared with the distinct shapes found so far; matched samples take the first shape's
+	 * vertices, geometry hash and representation index, and fold the rigid offset into their
+	 * local transform.
+	 * @param RootItem Root of the model's fragment tree, extracted
+	 * @return Number of samples now drawn with another representation's geometry
+	 */
+	int32 MatchRigidDuplicates(FFragmentItem& RootItem) const;
 
 	/**
-	 * Create a static mesh from pre-extracted shell geometry.
+	 * Create a static mesh from pre-extracted shell or circle extrusion geometry.
 	 * This uses data from FPreExtractedGeometry and never accesses FlatBuffers.
 	 *
 	 * @param Geometry The pre-extracted geometry data
 	 * @param AssetName Name for the created mesh asset
 	 * @param OuterRef Package/outer for the mesh
+	 * @param BuildData Mesh data prepared on a worker; built inline when null
+	 * @param Profile Runtime writes render buffers directly, Full runs the editor-grade build (needed for saving)
 	 * @return Created UStaticMesh or nullptr on failure
 	 */
-	UStaticMesh* CreateStaticMeshFromPreExtractedShell(
+	UStaticMesh* CreateStaticMeshFromPreExtractedGeometry(
 		const FPreExtractedGeometry& Geometry,
 		const FString& AssetName,
-		UObject* OuterRef);
+		UObject* OuterRef,
+		FFragmentMeshBuildDataPtr BuildData = nullptr,
+		EFragmentMeshBuildProfile Profile = EFragmentMeshBuildProfile::Full);
+
+	/**
+	 * Get the shared mesh for a shell or circle extrusion representation.
+	 * On a cache miss the representation is queued for a worker build; ProcessMeshBuildQueue
+	 * commits it later. Callers register the sample with AddMeshBuildWaiter to get it attached.
+	 * The mesh is shared by every sample whose geometry has the same content hash and
+	 * build profile (MakeSampleMeshKey), in any loaded model. Geometry with hash 0 (not hashable) gets a
+	 * key of its own sample, so unrelated samples never share its mesh but respawns reuse it.
+	 *
+	 * A cache hit does no string formatting and no file system access. Asset names, package
+	 * paths and the derived mesh cache entry are only worked out on a miss; runtime meshes
+	 * get no package (transient outer), Full meshes a package under /Game/Buildings.
+	 *
+	 * @param Item Fragment owning the sample (registry size, model and asset name on a miss)
+	 * @param SampleIndex Sample of Item whose pre-extracted geometry is drawn
+	 * @param ModelKey Content hash of Item's model (cross-model statistics)
+	 * @param Profile Build profile; Full when the mesh is saved as an asset
+	 * @return Cached mesh, nullptr while the build is queued or running
+	 */
+	UStaticMesh* GetOrBuildRepresentationMesh(const FFragmentItem& Item, int32 SampleIndex, uint64 ModelKey,
+		EFragmentMeshBuildProfile Profile);
+
+	/**
+	 * Attach a sample to the mesh of a queued representation once it is committed.
+	 * A fragment sample already waiting is replaced (latest actor and priority) rather than queued twice.
+	 * @param MeshKey Geometry content hash of the queued build
+	 * @param Waiter Sample to attach; its priority lowers the build's priority
+	 */
+	void AddMeshBuildWaiter(uint64 MeshKey, FMeshBuildWaiter&& Waiter);
+
+	/**
+	 * Drop the waiters of a build that no longer need its mesh (evicted actors) and recompute its
+	 * priority from the rest; waiters of hidden fragments count as least urgent.
+	 */
+	void RefreshMeshBuildPriority(uint64 MeshKey, FMeshBuildRequest& Request);
+
+	/** Remove a build's waiters from WaitingFragmentMeshes */
+	void UnindexMeshBuildWaiters(uint64 MeshKey, const FMeshBuildRequest& Request);
+
+	/**
+	 * Commit finished mesh builds (most urgent first) within the budget, attach the samples
+	 * waiting on them, and start queued builds while worker slots are free.
+	 * At least one finished build is committed per call.
+	 * @param BudgetMs Game thread time for commits in milliseconds
+	 */
+	void ProcessMeshBuildQueue(float BudgetMs);
+
+	/**
+	 * Create the mesh of a finished build, cache it and save it when built with the Full profile.
+	 * @return Committed mesh, or nullptr if the build produced nothing
+	 */
+	UStaticMesh* CommitMeshBuild(uint64 MeshKey, FMeshBuildRequest& Request);
+
+	/** Add the component or instance of a waiting sample now that its mesh exists */
+	void AttachWaitingSample(uint64 MeshKey, const FMeshBuildWaiter& Waiter, UStaticMesh* Mesh);
+
+	/**
+	 * Add the mesh component of one sample to a fragment actor.
+	 * @param FragmentActor Actor owning the sample (its root component is the attach parent)
+	 * @param Sample Sample providing local transform and material
+	 * @param Mesh Representation mesh of the sample
+	 * @return Registered component
+	 */
+	UStaticMeshComponent* CreateSampleComponent(AFragment* FragmentActor, const FFragmentSample& Sample, UStaticMesh* Mesh);
 
 private:
 
@@ -311,11 +903,164 @@ private:
 	UPROPERTY()
 	TMap<FString, UStaticMesh*> MeshCache;
 
-	// Representation-based mesh cache (Key = RepresentationId)
-	// More reliable than geometry hashing since all instances of the same
-	// RepresentationId share identical geometry in FlatBuffers format
+	// Representation mesh cache (Key = geometry content hash)
+	// Hashed from the FlatBuffers geometry bytes, so equal shapes are built once
+	// even when they come from different models
 	UPROPERTY()
-	TMap<int32, UStaticMesh*> RepresentationMeshCache;
+	TMap<uint64, FCachedRepresentationMesh> RepresentationMeshCache;
+
+	// Representation meshes queued or building on worker threads (Key = geometry content hash)
+	TMap<uint64, FMeshBuildRequest> MeshBuildRequests;
+
+	// Builds each fragment has samples waiting on (fragment -> geometry content hash)
+	TMultiMap<FFragmentKey, uint64> WaitingFragmentMeshes;
+
+	// FPlatformTime::Seconds() of the last priority refresh of the queued builds
+	double LastMeshBuildPriorityRefresh = 0.0;
+
+	// Mesh lookups served by a mesh built for another model
+	int32 CrossModelMeshHits = 0;
+
+	// Cached mesh -> geometry content hash, to release references from components
+	TMap<const UStaticMesh*, uint64> RepresentationMeshKeys;
+
+	// Mesh keys whose build failed; not requested again until a model is unloaded or the build settings change
+	TSet<uint64> FailedMeshKeys;
+
+	// FFragmentDerivedMeshCache::HashOptions of the builds that failed
+	uint32 FailedMeshOptionsHash = 0;
+
+	// Instanced groups holding instances (live, hidden or queued) of each fragment
+	TMap<FFragmentKey, TArray<uint64>> InstancedFragmentGroups;
+
+	// Fragments whose instances are kept out of their HISMCs
+	TSet<FFragmentKey> HiddenInstancedFragments;
+
+	// Finalized groups with staged instance changes for FlushInstanceVisibility
+	TSet<uint64> DirtyInstanceGroups;
+
+	// HISMC of each instanced group -> group key (picking)
+	TMap<const UPrimitiveComponent*, uint64> ISMCGroupKeys;
+
+	// Fragments whose selection flag is set (kept while they are hidden or evicted)
+	TSet<FFragmentKey> SelectedFragments;
+
+	/** Write the selection flag into the custom primitive data of a fragment actor's components */
+	void SetActorSelectionFlag(AFragment* FragmentActor, bool bSelected) const;
+
+	// Groups with queued instances and no HISMC yet (what FinalizeAllISMCs visits)
+	TSet<uint64> UnfinalizedInstanceGroups;
+
+	// Batches of unfinalized groups being sorted on workers (Key = group key)
+	TMap<uint64, FInstanceBatchPreparation> InstanceBatchPreparations;
+
+	// Pending instances covered by InstanceBatchPreparations; the global pending limit only counts the rest
+	int32 PreparingInstances = 0;
+
+	/**
+	 * Engine cull distance of a fragment from its registry MaxDimension and its model's streaming screen size threshold.
+	 * @return Distance in cm, or 0 (never culled) when disabled or the fragment has no registry bounds
+	 */
+	float GetFragmentCullDistance(const FString& ModelGuid, int32 LocalId) const;
+
+	/** Registry MaxDimension of a fragment, or 0 if it has no registry bounds */
+	float GetFragmentMaxDimension(const FString& ModelGuid, int32 LocalId) const;
+
+	/**
+	 * Grow a group's cull distance to cover one more instance, updating its HISMC if it exists.
+	 * @param MaxDimension Registry size of the instance's fragment (0 = no bounds: the group is never culled)
+	 */
+	void WidenGroupCullDistance(FInstancedMeshGroup& Group, float MaxDimension);
+
+	/** Set a group's cull distance from its largest instance at GroupCullDistanceScale, updating its HISMC */
+	void ApplyGroupCullDistance(FInstancedMeshGroup& Group) const;
+
+	/**
+	 * Recompute every group's cull distance when the view's cull distance scale changed since the last
+	 * pass. Groups hold fragments of several models, so they take the largest scale of the tile managers.
+	 */
+	void RefreshGroupCullDistances();
+
+	// Cull distance per cm of instance size applied to the groups (0 = not culled, < 0 = not computed yet)
+	float GroupCullDistanceScale = -1.0f;
+
+	/** Sort a group's pending instances on a worker (no-op if a preparation is already running) */
+	void StartInstanceBatchPreparation(uint64 ComboKey, const FInstancedMeshGroup& Group);
+
+	/** Drop a group's batch preparation (its worker result is discarded) */
+	void RemoveInstanceBatchPreparation(uint64 ComboKey);
+
+	/**
+	 * Take the batch prepared for a group.
+	 * @param bWait Wait for a running worker, and sort here when none was started or instances were removed
+	 *        since. Without it the game thread never sorts: a missing or stale preparation is (re)started
+	 * @param OutBatch Receives the Morton-sorted batch
+	 * @return false if no batch is ready (only without bWait)
+	 */
+	bool TakeInstanceBatch(uint64 ComboKey, const FInstancedMeshGroup& Group, bool bWait, FPreparedInstanceBatch& OutBatch);
+
+	/**
+	 * Move a hidden fragment's pending instance to the group's HiddenInstances.
+	 * @return false if the fragment is visible (the instance is left untouched)
+	 */
+	bool StashHiddenInstance(FInstancedMeshGroup& Group, FPendingInstanceData& Pending);
+
+	/** Fragment key of a loaded model's fragment (model content hash, 0 if the model is not loaded) */
+	FFragmentKey MakeFragmentKey(const FString& ModelGuid, int32 LocalId) const;
+
+	/** Remove a fragment from every group it has instances in (see RemoveInstancedFragment) */
+	void RemoveInstancedFragment(const FFragmentKey& Key);
+
+	/**
+	 * Move a group's pending instances into OutVisible, except those of hidden fragments,
+	 * which go to the group's HiddenInstances instead.
+	 */
+	void TakeVisiblePendingInstances(FInstancedMeshGroup& Group, TArray<FPendingInstanceData>& OutVisible);
+
+	/**
+	 * Record instances just added to a group's HISMC: custom data, owners, lookup maps and proxies.
+	 * @param Group Group whose ISMC received the instances
+	 * @param Instances Added instances, in the order they were added
+	 * @param NewIndices Instance indices returned by AddInstances
+	 */
+	void RegisterGroupInstances(FInstancedMeshGroup& Group, const TArray<FPendingInstanceData>& Instances, const TArray<int32>& NewIndices);
+
+	/** Swap-remove the instances of the group's PendingRemovals, keeping the lookup maps and proxies in step */
+	int32 RemoveGroupInstances(FInstancedMeshGroup& Group);
+
+	// Estimated bytes of RepresentationMeshCache and MaterialPool
+	int64 CachedResourceBytes = 0;
+
+	// An entry was added or lost its last reference since the last TrimResourceCaches pass
+	bool bResourceCachesTrimmable = false;
+
+	/** Add a committed or loaded mesh to RepresentationMeshCache (the mesh holds a reference on its material) */
+	void CacheRepresentationMesh(uint64 MeshKey, UStaticMesh* Mesh, uint64 SourceModelKey);
+
+	/**
+	 * Key of a representation mesh in RepresentationMeshCache, MeshBuildRequests and FailedMeshKeys.
+	 * Runtime meshes are keyed by the geometry hash, the key instanced groups use; Full meshes get a
+	 * key of their own, so a transient runtime mesh never stands in for a mesh that must be saved.
+	 */
+	static uint64 MakeRepresentationMeshKey(uint64 GeometryHash, EFragmentMeshBuildProfile Profile);
+
+	/**
+	 * Representation mesh key of one sample: MakeRepresentationMeshKey of its geometry hash, or of a
+	 * hash of (ModelKey, LocalId, SampleIndex) for geometry with hash 0, which shares a mesh with nothing.
+	 * @param Item Fragment owning the sample
+	 * @param SampleIndex Sample of Item
+	 * @param ModelKey Content hash of Item's model
+	 * @param Profile Build profile of the mesh
+	 */
+	static uint64 MakeSampleMeshKey(const FFragmentItem& Item, int32 SampleIndex, uint64 ModelKey, EFragmentMeshBuildProfile Profile);
+
+	/** Reference counting on RepresentationMeshCache entries (no-op for meshes not in the cache) */
+	void AcquireRepresentationMesh(const UStaticMesh* Mesh);
+	void ReleaseRepresentationMesh(const UStaticMesh* Mesh);
+
+	/** Reference counting on MaterialPool entries (no-op for materials not in the pool) */
+	void AcquirePooledMaterial(const UMaterialInterface* Material);
+	void ReleasePooledMaterial(const UMaterialInterface* Material);
 
 	UPROPERTY()
 	TArray<UPackage*> PackagesToSave;
@@ -336,6 +1081,9 @@ private:
 	// Meshes referencce for spawning
 	const Meshes* CurrentMeshesRef = nullptr;
 
+	// Content hash of the model being spawned
+	uint64 CurrentSpawningModelKey = 0;
+
 	// Save meshes flag
 	bool bCurrentSaveMeshes = false;
 
@@ -380,49 +1128,47 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Fragments|Performance")
 	bool bEnableAdaptiveBudget = true;
 
-	/** Maximum number of NEW mesh creations per frame (cache hits are unlimited).
-	 *  Lower values = smoother frame rate during initial load, but slower overall.
-	 *  Set to 0 for unlimited. */
-	UPROPERTY(EditAnywhere, Category = "Fragments|Performance", meta = (ClampMin = "0", ClampMax = "100"))
-	int32 MaxNewMeshCreationsPerFrame = 1;
-
-	/** Counter for new mesh creations this frame (reset in ProcessAllTileManagerChunks) */
-	int32 NewMeshCreationsThisFrame = 0;
-
-	/** Check if we can create another new mesh this frame */
-	FORCEINLINE bool CanCreateNewMesh() const
-	{
-		return (MaxNewMeshCreationsPerFrame == 0) || (NewMeshCreationsThisFrame < MaxNewMeshCreationsPerFrame);
-	}
-
-	/** Increment the new mesh creation counter */
-	FORCEINLINE void OnNewMeshCreated()
-	{
-		NewMeshCreationsThisFrame++;
-	}
+	/** Maximum number of mesh builds running on worker threads at once (0 = one per pool thread).
+	 *  Queued builds start in spawn priority order; finished builds are committed
+	 *  within the geometry share of the frame budget. */
+	UPROPERTY(EditAnywhere, Category = "Fragments|Performance", meta = (ClampMin = "0", ClampMax = "64"))
+	int32 MaxConcurrentMeshBuilds = 0;
 
 	/** Material pool for CRC-based deduplication */
 	UPROPERTY()
-	TMap<uint32, UMaterialInstanceDynamic*> MaterialPool;
+	TMap<uint32, FPooledMaterial> MaterialPool;
+
+	/** Pooled material -> pool key, to release references from components */
+	TMap<const UMaterialInterface*, uint32> PooledMaterialHashes;
 
 	/** Hash material properties for pooling */
 	uint32 HashMaterialProperties(uint8 R, uint8 G, uint8 B, uint8 A, bool bIsGlass) const;
 
-	/** Get or create pooled material instance */
+	/** Get or create pooled material instance (the shared instance in shared color material mode) */
 	UMaterialInstanceDynamic* GetPooledMaterial(uint8 R, uint8 G, uint8 B, uint8 A, bool bIsGlass);
 
+	/** Material part of an instanced group key: the color hash, or only the blend mode with the shared color material */
+	uint32 GetGroupMaterialHash(uint8 R, uint8 G, uint8 B, uint8 A, bool bIsGlass) const;
+
+	/** Decide once whether the shared color material is used; falls back to per-color materials if it cannot be loaded */
+	void ResolveColorMaterialMode();
+
+	bool bColorMaterialModeResolved = false;
+	bool bSharedColorMaterialActive = false;
+
+	/** Shared opaque [0] and glass [1] instances used in shared color material mode */
+	UPROPERTY()
+	UMaterialInstanceDynamic* SharedColorInstances[2] = {};
+
 	// ==========================================
 	// GPU INSTANCING MEMBERS (Phase 4)
 	// ==========================================
 
-	/** Instancing threshold - use ISMC if >= this many instances share the same representation+material */
-	int32 InstancingThreshold = 10;
-
 	/** Enable/disable GPU instancing (can be toggled for debugging) */
 	bool bEnableGPUInstancing = true;
 
-	/** Threshold for incremental ISMC finalization. When pending instances exceed this,
-	 *  finalize the group immediately to prevent OOM. Set to 0 to disable incremental finalization. */
+	/** Threshold for incremental ISMC finalization. When pending instances exceed this, the group's
+	 *  batch is sorted on a worker and finalized once ready to prevent OOM. Set to 0 to disable incremental finalization. */
 	int32 IncrementalFinalizationThreshold = 500;
 
 	/** Maximum pending instances across all groups before forced finalization.
@@ -432,20 +1178,37 @@ private:
 	/** Current total pending instances across all groups (for memory tracking) */
 	int32 TotalPendingInstances = 0;
 
-	/** Count of instances per RepresentationId + MaterialHash combination.
-	 *  Key = (int64)RepresentationId | ((int64)MaterialHash << 32)
-	 *  Built during PreExtractAllGeometry, used during spawn to decide instancing. */
-	TMap<int64, int32> RepresentationMaterialInstanceCount;
+	/** Instances and instancing decision per geometry + material combination over all loaded models.
+	 *  Key = MakeInstanceGroupKey(GeometryHash, MaterialHash)
+	 *  Added to by PreExtractAllGeometry, subtracted by UnloadFragment, used during spawn to decide instancing. */
+	TMap<uint64, FInstancingGroupStats> InstancingGroupStats;
 
-	/** ISMC groups keyed by RepresentationId + MaterialHash.
+	/** Fill a group's cost model terms and decision from its instance and triangle counts */
+	void EvaluateInstancingCost(FInstancingGroupStats& Stats) const;
+
+	/** Bumped after InstancingGroupStats is re-evaluated; lets callers drop decisions they cached */
+	uint32 InstancingDecisionSerial = 0;
+
+	/** ISMC groups keyed by geometry + material combination.
 	 *  Each group contains one ISMC with all instances sharing that geometry+material. */
 	UPROPERTY()
-	TMap<int64, FInstancedMeshGroup> InstancedMeshGroups;
+	TMap<uint64, FInstancedMeshGroup> InstancedMeshGroups;
 
-	/** Proxy map for instanced fragments (LocalId -> proxy data).
+	/** Add the instance counts (and triangles and category) of a model's valid samples per geometry + material key */
+	void CountInstancesPerGroup(const FFragmentItem& RootItem, TMap<uint64, FInstancingGroupStats>& OutCounts) const;
+
+	/** Instanced fragments per model (model content hash -> proxy table).
 	 *  Used for lookups on fragments that don't have AFragment actors. */
-	UPROPERTY()
-	TMap<int32, FFragmentProxy> LocalIdToProxyMap;
+	TMap<uint64, FFragmentProxyTable> ProxyTables;
+
+	/** Pending instance of a fragment sample; registers the fragment's model with ProxyTables */
+	FPendingInstanceData MakePendingInstance(const FFragmentItem& Item, const FTransform& WorldTransform, const FColor& Color);
+
+	/** Proxy of a proxy table row, with strings and attributes read from the model item */
+	FFragmentProxy MakeFragmentProxy(const FFragmentProxyTable& Table, int32 Row) const;
+
+	/** Proxy of a model item without an instance (transform from the item) */
+	FFragmentProxy MakeItemProxy(const FString& ModelGuid, const FFragmentItem& Item) const;
 
 	/** Host actor for ISMC components.
 	 *  All ISMCs are attached to this single actor for organization. */
@@ -26,7 +26,7 @@ struct FDynamicRenderTile
 	UPROPERTY(BlueprintReadOnly, Category = "Tile")
 	int32 MaterialIndex = 0;
 
-	/** LOD level for this tile's fragments (always Visible since we don't use Wires LOD) */
+	/** LOD level for this tile's fragments (Visible or Wires) */
 	UPROPERTY(BlueprintReadOnly, Category = "Tile")
 	EFragmentLod LodLevel = EFragmentLod::Visible;
 
@@ -107,19 +107,25 @@ public:
 	uint32 FindTileForFragment(int32 LocalId) const;
 
 	/**
-	 * Get fragments that need to be spawned (not yet spawned).
+	 * Get fragments that need to be spawned (in a geometry tile, not yet spawned).
 	 * @param SpawnedFragments Set of already-spawned fragment IDs
 	 * @return Array of fragment IDs that need spawning
 	 */
 	TArray<int32> GetFragmentsToSpawn(const TSet<int32>& SpawnedFragments) const;
 
 	/**
-	 * Get fragments that should be unloaded (no longer in any tile).
+	 * Get fragments that should be unloaded (no longer in any geometry tile).
+	 * Fragments demoted to the Wires tier are included so their geometry is hidden.
 	 * @param SpawnedFragments Set of currently spawned fragment IDs
 	 * @return Array of fragment IDs that should be unloaded
 	 */
 	TArray<int32> GetFragmentsToUnload(const TSet<int32>& SpawnedFragments) const;
 
+	/**
+	 * Get fragments in Wires tiles (drawn as box proxies).
+	 */
+	const TSet<int32>& GetWiresFragments() const { return WiresFragments; }
+
 	// --- Configuration ---
 
 	/** Grid dimension for geometry tiles (cm) - default 320cm = 3.2m */
@@ -141,9 +147,12 @@ private:
 	/** Reverse lookup (fragment ID -> tile ID) */
 	TMap<int32, uint32> FragmentToTileId;
 
-	/** All fragments currently in tiles */
+	/** All fragments currently in geometry (Visible) tiles */
 	TSet<int32> AllTiledFragments;
 
+	/** All fragments currently in Wires tiles */
+	TSet<int32> WiresFragments;
+
 	/**
 	 * Compute CRC-32 tile ID for a fragment.
 	 * Port of engine_fragment's tile ID generation.
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "FragmentProxyBoxRenderer.generated.h"
+
+// Forward declarations
+class UFragmentsImporter;
+class UFragmentRegistry;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Box proxies sharing one material color, drawn by a single instanced component.
+ */
+USTRUCT()
+struct FFragmentProxyBoxBatch
+{
+	GENERATED_BODY()
+
+	/** Instanced cube component drawing the batch */
+	UPROPERTY()
+	UInstancedStaticMeshComponent* Component = nullptr;
+
+	/** Material color shared by the batch */
+	FColor Color = FColor::White;
+
+	/** Fragments drawn by the batch, sorted; instance i draws LocalIds[i] */
+	TArray<int32> LocalIds;
+};
+
+/**
+ * Draws the Wires LOD tier.
+ *
+ * Fragments whose screen size falls between the cull threshold and the geometry
+ * threshold are shown as colored boxes built from their registry bounds instead
+ * of spawning their real geometry. Boxes are batched into one instanced cube
+ * component per material color; a batch is only rebuilt when its fragment set
+ * changes, so a steady camera costs nothing.
+ */
+UCLASS()
+class FRAGMENTSUNREAL_API UFragmentProxyBoxRenderer : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFragmentProxyBoxRenderer();
+
+	/**
+	 * Initialize the renderer.
+	 * @param InImporter Importer providing the world, owner actor and pooled materials
+	 * @param InRegistry Registry providing bounds and colors
+	 */
+	void Initialize(UFragmentsImporter* InImporter, UFragmentRegistry* InRegistry);
+
+	/**
+	 * Show exactly the given fragments as boxes.
+	 * @param BoxFragments LocalIds to draw as boxes this update
+	 */
+	void UpdateBoxes(const TSet<int32>& BoxFragments);
+
+	/**
+	 * Set the selection flag of a fragment's box, now if it is drawn, or when it is added later.
+	 * @param LocalId Fragment selected or deselected
+	 * @param bSelected true if selected
+	 */
+	void SetFragmentSelected(int32 LocalId, bool bSelected);
+
+	/** Remove all boxes and destroy the batch components */
+	void Clear();
+
+	/** Get number of fragments currently drawn as boxes */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
+	int32 GetBoxCount() const;
+
+private:
+	/** Importer reference for world and material access */
+	UPROPERTY()
+	UFragmentsImporter* Importer = nullptr;
+
+	/** Fragment registry for bounds and colors */
+	UPROPERTY()
+	UFragmentRegistry* Registry = nullptr;
+
+	/** Unit cube drawn for every box */
+	UPROPERTY()
+	UStaticMesh* BoxMesh = nullptr;
+
+	/** Actor holding the batch components */
+	UPROPERTY()
+	AActor* HostActor = nullptr;
+
+	/** Batches keyed by packed material color */
+	UPROPERTY()
+	TMap<uint32, FFragmentProxyBoxBatch> Batches;
+
+	/** Selected fragments, flagged in their box's custom data */
+	TSet<int32> SelectedFragments;
+
+	/**
+	 * Create the instanced component for a batch.
+	 * @param Color Material color of the batch
+	 * @return Registered component, or nullptr on failure
+	 */
+	UInstancedStaticMeshComponent* CreateBatchComponent(const FColor& Color);
+};
@@ -56,12 +56,53 @@ struct FFragmentVisibilityData
 	UPROPERTY(BlueprintReadOnly, Category = "Fragment")
 	uint8 MaterialAlpha = 255;
 
+	/** Material color, used to draw the fragment as a box proxy (Wires LOD) */
+	UPROPERTY(BlueprintReadOnly, Category = "Fragment")
+	FColor MaterialColor = FColor::White;
+
 	FFragmentVisibilityData()
 		: WorldBounds(ForceInit)
 	{
 	}
 };
 
+/** Bits of FFragmentCullingData::Flags */
+enum class EFragmentCullFlags : uint8
+{
+	None = 0,
+	/** FFragmentVisibilityData::bIsSmallObject */
+	SmallObject = 1 << 0,
+};
+ENUM_CLASS_FLAGS(EFragmentCullFlags)
+
+/**
+ * Hot part of the registry: what the per-sample visibility loop reads, as
+ * parallel arrays indexed like UFragmentRegistry::GetAllFragments().
+ *
+ * Bounds are float32 and rounded outwards from the double FBox, so a culling
+ * pass touches 37 bytes per fragment instead of a whole FFragmentVisibilityData
+ * (two FStrings and a double FBox).
+ */
+struct FRAGMENTSUNREAL_API FFragmentCullingData
+{
+	TArray<FVector3f> BoundsMin;
+	TArray<FVector3f> BoundsMax;
+	TArray<float> MaxDimensions;
+	TArray<int32> LocalIds;
+	TArray<int32> MaterialIndices;
+	TArray<EFragmentCullFlags> Flags;
+
+	/** Append the hot fields of a fragment */
+	void Add(const FFragmentVisibilityData& Data);
+
+	void Reset();
+
+	int32 Num() const { return LocalIds.Num(); }
+
+	/** Heap bytes held by the arrays */
+	SIZE_T GetAllocatedSize() const;
+};
+
 /**
  * Fragment Registry - flat array of all fragments with pre-computed visibility data.
  *
@@ -71,7 +112,8 @@ struct FFragmentVisibilityData
  * inside a tile causes the entire tile to disappear.
  *
  * Key differences from octree approach:
- * - Flat array for cache-friendly iteration (64 bytes per entry)
+ * - Hot/cold split: culling iterates float32 structure-of-arrays (FFragmentCullingData),
+ *   everything else lives in the FFragmentVisibilityData table
  * - Individual fragment bounds, not tile bounds
  * - LocalId lookup for fast access when grouping
  * - Pre-computed MaxDimension for screen size calculation
@@ -92,12 +134,21 @@ public:
 	 */
 	void BuildFromModel(const UFragmentModelWrapper* ModelWrapper, const FString& ModelGuid);
 
+	/** Rebuilds the culling arrays, which are not serialized */
+	virtual void PostLoad() override;
+
 	/**
 	 * Get all fragments in the registry (const reference for iteration).
 	 * @return Array of fragment visibility data
 	 */
 	const TArray<FFragmentVisibilityData>& GetAllFragments() const { return Fragments; }
 
+	/**
+	 * Get the hot culling arrays (same indexing as GetAllFragments).
+	 * @return Bounds, sizes and flags of all fragments
+	 */
+	const FFragmentCullingData& GetCullingData() const { return CullingData; }
+
 	/**
 	 * Get fragment count.
 	 * @return Number of registered fragments
@@ -145,10 +196,13 @@ public:
 	float SmallObjectSize = 200.0f;
 
 private:
-	/** Flat array of all fragment visibility data */
+	/** Flat array of all fragment visibility data (cold: looked up by LocalId) */
 	UPROPERTY()
 	TArray<FFragmentVisibilityData> Fragments;
 
+	/** Culling fields of Fragments, rebuilt with it (not serialized: PostLoad rebuilds it) */
+	FFragmentCullingData CullingData;
+
 	/** Fast lookup from LocalId to array index */
 	UPROPERTY()
 	TMap<int32, int32> LocalIdToIndex;
@@ -168,4 +222,7 @@ private:
 	 * @param ParsedModel FlatBuffers model for bounding box extraction
 	 */
 	void CollectFragmentData(const struct FFragmentItem& Item, const struct Model* ParsedModel);
+
+	/** Refill CullingData from Fragments */
+	void RebuildCullingData();
 };
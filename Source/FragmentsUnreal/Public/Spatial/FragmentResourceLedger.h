@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AActor;
+class UStaticMesh;
+class UMaterialInterface;
+
+/**
+ * Memory held by the spawned fragment actors of one model.
+ *
+ * Meshes and materials are shared between fragments, so each is charged once while at
+ * least one tracked fragment uses it. Actors and components are charged their object size,
+ * instanced fragments the per-instance data of their HISMC instances (their shared mesh is not charged).
+ * Resources are only used as keys after they are charged, so the ledger never keeps them alive.
+ */
+class FRAGMENTSUNREAL_API FFragmentResourceLedger
+{
+public:
+	/**
+	 * Charge a fragment actor's components, meshes and materials.
+	 * Calling it again for the same fragment replaces the previous charge (components added later).
+	 * @param LocalId Fragment the actor belongs to
+	 * @param Actor Spawned fragment actor (null for fragments drawn only as HISMC instances)
+	 * @param InstanceBytes Bytes of the fragment's HISMC instances (see GetInstanceBytes)
+	 */
+	void AddFragment(int32 LocalId, const AActor* Actor, int64 InstanceBytes = 0);
+
+	/**
+	 * Remove a fragment's charge. Meshes and materials stay charged while other fragments use them.
+	 * @param LocalId Fragment to remove
+	 * @return Bytes no longer charged
+	 */
+	int64 RemoveFragment(int32 LocalId);
+
+	/** Forget all fragments */
+	void Reset();
+
+	/** Total charged bytes: unique meshes and materials plus actor and component objects */
+	int64 GetTotalBytes() const { return ResourceBytes + ObjectBytes; }
+
+	int32 GetFragmentCount() const { return Fragments.Num(); }
+	int32 GetComponentCount() const { return ComponentCount; }
+	int32 GetUniqueMeshCount() const { return MeshCount; }
+	int32 GetUniqueMaterialCount() const { return MaterialCount; }
+
+	/** CPU and GPU buffer bytes of a mesh's render data, over all LODs */
+	static int64 GetMeshBytes(const UStaticMesh* Mesh);
+
+	/** Object and render resource bytes of a material instance */
+	static int64 GetMaterialBytes(const UMaterialInterface* Material);
+
+	/** Bytes of one HISMC instance: its transform and custom data, in the component and in the instance buffer */
+	static int64 GetInstanceBytes(int32 NumCustomDataFloats);
+
+private:
+	struct FResourceEntry
+	{
+		int64 Bytes = 0;
+		int32 RefCount = 0;
+		bool bIsMesh = false;
+	};
+
+	struct FFragmentEntry
+	{
+		/** Meshes and materials the fragment holds one reference on each */
+		TArray<const UObject*> Resources;
+		int64 ObjectBytes = 0;
+		int32 ComponentCount = 0;
+	};
+
+	/** Take one reference on a mesh or material, charging it on the first */
+	void AddResource(FFragmentEntry& Fragment, const UObject* Resource, bool bIsMesh);
+
+	TMap<const UObject*, FResourceEntry> Resources;
+	TMap<int32, FFragmentEntry> Fragments;
+
+	int64 ResourceBytes = 0;
+	int64 ObjectBytes = 0;
+	int32 ComponentCount = 0;
+	int32 MeshCount = 0;
+	int32 MaterialCount = 0;
+};
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
+#include "Spatial/FragmentResourceLedger.h"
 #include "FragmentTileManager.generated.h"
 
 // Forward declarations
@@ -10,6 +11,9 @@ class UFragmentRegistry;
 class UPerSampleVisibilityController;
 class UDynamicTileGenerator;
 class UOcclusionSpawnController;
+class UFragmentProxyBoxRenderer;
+class UFragmentTileMerger;
+class UPrimitiveComponent;
 class UFragmentModelWrapper;
 struct FFragmentItem;
 
@@ -38,6 +42,16 @@ public:
 	 */
 	void InitializePerSampleVisibility(UFragmentRegistry* InRegistry);
 
+	/**
+	 * Tear down everything the manager draws outside fragment actors (box proxies, merged tile meshes)
+	 * and drop its per-sample state. Called by the importer when the model is unloaded; fragment actors
+	 * and instances are destroyed by the importer itself.
+	 */
+	void Shutdown();
+
+	/** Per-sample visibility controller (null until InitializePerSampleVisibility) */
+	const UPerSampleVisibilityController* GetSampleVisibility() const { return SampleVisibility; }
+
 	/**
 	 * Update visible fragments based on camera frustum (per-sample visibility)
 	 * @param CameraLocation Camera world position
@@ -111,6 +125,14 @@ public:
 	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "0.5", ClampMax = "2.0"))
 	float GraphicsQuality = 1.0f;
 
+	/** Screen size (pixels) below which fragments are drawn as box proxies instead of geometry (0 = off) */
+	UPROPERTY(EditAnywhere, Category = "Streaming", meta = (ClampMin = "0.0", ClampMax = "256.0"))
+	float GeometryScreenSize = 16.0f;
+
+	/** Merge the non-instanced fragments of each render tile into one mesh per material (built off-thread) */
+	UPROPERTY(EditAnywhere, Category = "Streaming")
+	bool bMergeTileFragments = false;
+
 	/** Enable occlusion-based spawn deferral (fragments behind walls spawn later) */
 	UPROPERTY(EditAnywhere, Category = "Streaming|Occlusion")
 	bool bEnableOcclusionDeferral = true;
@@ -137,7 +159,7 @@ public:
 
 	/** Get current cache usage in megabytes */
 	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
-	float GetCacheUsageMB() const { return PerSampleCacheBytes / (1024.0f * 1024.0f); }
+	float GetCacheUsageMB() const { return ResourceLedger.GetTotalBytes() / (1024.0f * 1024.0f); }
 
 	/** Get cache limit in megabytes */
 	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
@@ -148,7 +170,7 @@ public:
 	float GetCacheUsagePercent() const
 	{
 		if (MaxCachedBytes == 0) return 0.0f;
-		return (PerSampleCacheBytes * 100.0f) / MaxCachedBytes;
+		return (ResourceLedger.GetTotalBytes() * 100.0f) / MaxCachedBytes;
 	}
 
 	/** Get number of visible fragments */
@@ -159,11 +181,57 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
 	int32 GetHiddenFragmentCount() const { return HiddenFragments.Num(); }
 
+	/** Get number of fragments drawn as box proxies */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
+	int32 GetProxyBoxCount() const;
+
+	/** Get number of merged tile meshes currently drawn */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
+	int32 GetMergedMeshCount() const;
+
+	/**
+	 * Hide or show a fragment regardless of streaming. A hidden fragment's actor and instances are
+	 * hidden and never shown or spawned by streaming, and its merged tile meshes are rebuilt without it.
+	 * Instance changes are applied at the importer's next FlushInstanceVisibility().
+	 * @param LocalId Fragment to hide or show
+	 * @param bHidden true to hide
+	 */
+	void SetFragmentHidden(int32 LocalId, bool bHidden);
+
+	/**
+	 * Show or clear the selection highlight on the fragment's box proxy, and keep a selected
+	 * fragment out of the merged tile meshes so its actor, which carries the highlight, draws it.
+	 * @param LocalId Fragment selected or deselected
+	 * @param bSelected true if selected
+	 */
+	void SetFragmentSelected(int32 LocalId, bool bSelected);
+
+	/**
+	 * Resolve a hit on a merged tile mesh to the fragment that was hit.
+	 * @param Component Component that was hit
+	 * @param FaceIndex Hit triangle index
+	 * @return LocalId, or INDEX_NONE if the component is not a merged tile mesh
+	 */
+	int32 FindMergedFragmentAtFace(const UPrimitiveComponent* Component, int32 FaceIndex) const;
+
 	/** Get total cached fragments (visible + hidden) */
 	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
 	int32 GetTotalCachedFragmentCount() const { return SpawnedFragmentActors.Num(); }
 
+	/** Get memory held by spawned fragment actors (unique meshes and materials counted once) */
+	const FFragmentResourceLedger& GetResourceLedger() const { return ResourceLedger; }
+
+	/**
+	 * Recharge a spawned fragment after components were added to it (meshes that finished building later).
+	 * @param LocalId Fragment the actor belongs to
+	 * @param Actor The fragment's actor
+	 */
+	void RefreshFragmentResources(int32 LocalId, const AActor* Actor);
+
 private:
+	/** Per-instance bytes of the samples drawn as HISMC instances */
+	int64 GetInstanceBytes(const TArray<struct FFragmentSample>& Samples, const FString& Category) const;
+
 	// --- State ---
 
 	/** Model identifier */
@@ -189,6 +257,14 @@ private:
 	UPROPERTY()
 	UOcclusionSpawnController* OcclusionController = nullptr;
 
+	/** Box proxy renderer for the Wires LOD tier */
+	UPROPERTY()
+	UFragmentProxyBoxRenderer* ProxyBoxes = nullptr;
+
+	/** Merged tile meshes for non-instanced fragments */
+	UPROPERTY()
+	UFragmentTileMerger* TileMerger = nullptr;
+
 	/** Set of currently spawned (visible) fragments */
 	TSet<int32> SpawnedFragments;
 
@@ -199,8 +275,14 @@ private:
 	UPROPERTY()
 	TMap<int32, class AFragment*> SpawnedFragmentActors;
 
-	/** Current memory used by per-sample cached fragments (bytes) */
-	int64 PerSampleCacheBytes = 0;
+	/** Spawned fragments with samples drawn as HISMC instances (with or without an actor); hidden and evicted through the importer */
+	TSet<int32> InstancedFragments;
+
+	/** Fragments hidden through SetFragmentHidden; streaming leaves them hidden */
+	TSet<int32> ForcedHiddenFragments;
+
+	/** Memory held by spawned fragments: unique meshes and materials, components, actors, HISMC instances */
+	FFragmentResourceLedger ResourceLedger;
 
 	/** Last used time for each fragment (for LRU eviction) */
 	TMap<int32, double> FragmentLastUsedTime;
@@ -217,6 +299,9 @@ private:
 	/** Time of last significant camera movement (for deferring eviction/unload) */
 	double LastCameraMovementTime = 0.0;
 
+	/** Cull distance scale the spawned actors' components were given (< 0 = not computed yet) */
+	float AppliedCullDistanceScale = -1.0f;
+
 	/** Last camera location for priority sorting */
 	FVector LastPriorityCameraLocation = FVector::ZeroVector;
 
@@ -248,6 +333,12 @@ private:
 	 */
 	void UpdateSpawnProgress();
 
+	/**
+	 * Hide the spawned actors of fragments now drawn by committed merged meshes.
+	 * Actors stay visible while their merged mesh is still building.
+	 */
+	void HideMergedFragmentActors();
+
 	/**
 	 * Find the parent FFragmentItem for a given fragment in the hierarchy
 	 * @param Root Root of hierarchy to search
@@ -259,10 +350,12 @@ private:
 private:
 	/**
 	 * Spawn a single fragment (per-sample mode).
+	 * Samples whose mesh is still building are attached by the importer once it is committed.
 	 * @param LocalId Fragment local ID to spawn
+	 * @param SpawnPriority Spawn priority of the fragment (lower first), used for its mesh builds
 	 * @return true if fragment was spawned successfully
 	 */
-	bool SpawnFragmentById(int32 LocalId);
+	bool SpawnFragmentById(int32 LocalId, float SpawnPriority = 0.0f);
 
 	/**
 	 * Hide a single fragment (per-sample mode) - keeps in cache.
@@ -278,6 +371,12 @@ private:
 	 */
 	bool ShowFragmentById(int32 LocalId);
 
+	/**
+	 * Re-apply the cull distances of the spawned actors when the view's cull distance scale changed
+	 * (FOV, viewport height, GraphicsQuality, MinScreenSize or the importer's bAutoCullDistances).
+	 */
+	void RefreshCullDistances();
+
 	/**
 	 * Destroy and unload a single fragment (per-sample mode).
 	 * Only called during memory pressure eviction.
@@ -285,13 +384,6 @@ private:
 	 */
 	void UnloadFragmentById(int32 LocalId);
 
-	/**
-	 * Calculate approximate memory usage of a single fragment actor.
-	 * @param Actor Fragment actor to measure
-	 * @return Memory usage in bytes
-	 */
-	int64 CalculateFragmentMemoryUsage(class AFragment* Actor) const;
-
 	/**
 	 * Evict least recently used fragments to fit under memory budget (per-sample mode).
 	 * Matches engine_fragment: only evict when memory overflow AND fragment invisible.
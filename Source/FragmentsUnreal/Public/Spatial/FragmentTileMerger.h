@@ -0,0 +1,204 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Async/Future.h"
+#include "Importer/FragmentMeshBuilder.h"
+#include "FragmentTileMerger.generated.h"
+
+// Forward declarations
+class UFragmentsImporter;
+class UPrimitiveComponent;
+class UStaticMeshComponent;
+struct FDynamicRenderTile;
+struct FFragmentItem;
+
+/**
+ * Fragments of one render tile sharing a material color, drawn as a single mesh.
+ */
+USTRUCT()
+struct FFragmentMergedMesh
+{
+	GENERATED_BODY()
+
+	/** Component drawing the last committed mesh */
+	UPROPERTY()
+	UStaticMeshComponent* Component = nullptr;
+
+	/** Material color shared by the group */
+	FColor Color = FColor::White;
+
+	/** Fragments currently in the tile, sorted */
+	TArray<int32> LocalIds;
+
+	/** World position merged vertices are stored relative to (tile center) */
+	FVector Origin = FVector::ZeroVector;
+
+	/** Triangle ranges of the committed mesh, sorted by FirstTriangle */
+	TArray<FFragmentMeshElementRange> Elements;
+
+	/** Drawn fragments of the committed mesh, sorted */
+	TArray<int32> BuiltLocalIds;
+};
+
+/**
+ * Merges the non-instanced fragments of each visible render tile into combined meshes.
+ *
+ * Every fragment whose samples all fall below the instancing threshold is taken
+ * out of the actor path: the samples of a tile are grouped by material color and
+ * merged off-thread into one mesh per group. Each merged mesh keeps the triangle
+ * range of every fragment, so hit faces map back to a LocalId and single
+ * fragments can be hidden (which rebuilds their group without them). A group
+ * keeps drawing its previous mesh until the rebuilt one is committed, and is
+ * destroyed with its mesh once its tile is gone.
+ */
+UCLASS()
+class FRAGMENTSUNREAL_API UFragmentTileMerger : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFragmentTileMerger();
+
+	/**
+	 * Initialize the merger.
+	 * @param InImporter Importer providing models, instancing decisions and pooled materials
+	 * @param InModelGuid Model whose fragments are merged
+	 */
+	void Initialize(UFragmentsImporter* InImporter, const FString& InModelGuid);
+
+	/**
+	 * Regroup the mergeable fragments of the current tiles and queue builds for changed groups.
+	 * Groups whose tile is gone are destroyed.
+	 * @param Tiles Current render tiles
+	 */
+	void UpdateTiles(const TMap<uint32, FDynamicRenderTile>& Tiles);
+
+	/**
+	 * Commit finished builds to their components.
+	 * At least one build is committed per call when ready, the rest only while time is left.
+	 * @param Deadline FPlatformTime::Seconds() after which no further build is committed
+	 * @return Number of builds committed
+	 */
+	int32 CommitFinishedBuilds(double Deadline);
+
+	/**
+	 * Hide or show one merged fragment; its groups are rebuilt without it.
+	 * @param LocalId Fragment to hide or show
+	 * @param bHidden true to hide
+	 */
+	void SetFragmentHidden(int32 LocalId, bool bHidden);
+
+	/**
+	 * Keep a selected fragment out of the merged meshes from the next update on: a merged mesh
+	 * cannot highlight one of its fragments, the fragment's own actor can.
+	 * @param LocalId Fragment selected or deselected
+	 * @param bSelected true if selected
+	 */
+	void SetFragmentSelected(int32 LocalId, bool bSelected);
+
+	/**
+	 * Map a triangle of a merged mesh back to its fragment.
+	 * @param Component Component that was hit
+	 * @param TriangleIndex Triangle (face) index within the mesh
+	 * @return LocalId of the fragment, or INDEX_NONE if the component is not a merged mesh
+	 */
+	int32 FindLocalIdForTriangle(const UPrimitiveComponent* Component, int32 TriangleIndex) const;
+
+	/** Fragments currently handled by merged meshes (drawn or waiting for their build) */
+	const TSet<int32>& GetMergedFragments() const { return MergedFragments; }
+
+	/** Fragments drawn by committed, visible merged meshes; their actors can be hidden */
+	const TSet<int32>& GetDrawnFragments() const { return DrawnFragments; }
+
+	/** Remove all merged meshes and drop pending builds */
+	void Clear();
+
+	/** Get number of merged meshes currently drawn */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
+	int32 GetMergedMeshCount() const;
+
+	/** Get number of merge builds in flight */
+	UFUNCTION(BlueprintCallable, Category = "Fragments|Streaming")
+	int32 GetPendingBuildCount() const { return PendingBuilds.Num(); }
+
+private:
+	/** A merge running on a worker */
+	struct FPendingMerge
+	{
+		TFuture<FFragmentMeshBuildDataPtr> Future;
+
+		/** Drawn fragments the build was started for, sorted */
+		TArray<int32> LocalIds;
+
+		/** World position of the merged mesh origin */
+		FVector Origin = FVector::ZeroVector;
+	};
+
+	/** Importer reference for models, world and materials */
+	UPROPERTY()
+	UFragmentsImporter* Importer = nullptr;
+
+	/** Model identifier */
+	FString ModelGuid;
+
+	/** Actor holding the merged mesh components */
+	UPROPERTY()
+	AActor* HostActor = nullptr;
+
+	/** Groups keyed by tile ID (low 32 bits) and packed material color (high 32 bits) */
+	UPROPERTY()
+	TMap<uint64, FFragmentMergedMesh> Groups;
+
+	/** Builds in flight, same keys as Groups (at most one per group) */
+	TMap<uint64, FPendingMerge> PendingBuilds;
+
+	/** Fragment items by LocalId (owned by the model wrapper) */
+	TMap<int32, const FFragmentItem*> Items;
+
+	/** Whether a fragment may be merged, cached per LocalId */
+	TMap<int32, bool> MergeableCache;
+
+	/** Importer instancing decision serial MergeableCache was filled with */
+	uint32 MergeableCacheSerial = 0;
+
+	/** Fragments assigned to a group by the last update */
+	TSet<int32> MergedFragments;
+
+	/** Fragments drawn by committed, visible merged meshes */
+	TSet<int32> DrawnFragments;
+
+	/** Fragments left out of their merged meshes */
+	TSet<int32> HiddenFragments;
+
+	/** Selected fragments, not mergeable while selected */
+	TSet<int32> SelectedFragments;
+
+	/** Index the fragment items of the model (once, on first use) */
+	void BuildItemIndex();
+
+	/** @return true if every valid sample of the fragment stays below the instancing threshold */
+	bool IsMergeable(int32 LocalId);
+
+	/**
+	 * Collect the fragments of a group that are not hidden.
+	 * @param Group Group to read
+	 * @param OutLocalIds Receives the drawn LocalIds, sorted
+	 */
+	void GetDrawnLocalIds(const FFragmentMergedMesh& Group, TArray<int32>& OutLocalIds) const;
+
+	/** Recollect DrawnFragments from the committed meshes of the visible groups */
+	void RefreshDrawnFragments();
+
+	/** Release the resources of a group's component and destroy it */
+	void DestroyGroupComponent(FFragmentMergedMesh& Group);
+
+	/** Queue a build if the drawn set of a group differs from its committed and pending meshes */
+	void RequestBuild(uint64 Key, const FFragmentMergedMesh& Group);
+
+	/**
+	 * Create the component for a group.
+	 * @return Registered component, or nullptr on failure
+	 */
+	UStaticMeshComponent* CreateGroupComponent();
+};
@@ -6,7 +6,6 @@
 
 /**
  * LOD levels for fragment visibility.
- * Simplified to just Visible/Invisible since we don't use wire LOD.
  */
 UENUM(BlueprintType)
 enum class EFragmentLod : uint8
@@ -14,7 +13,9 @@ enum class EFragmentLod : uint8
 	/** Fragment is not visible (culled) */
 	Invisible,
 	/** Fragment is visible and should be rendered */
-	Visible
+	Visible,
+	/** Fragment is too small on screen for geometry; drawn as a colored box from its bounds */
+	Wires
 };
 
 /**
@@ -118,7 +119,7 @@ struct FFragmentVisibilityResult
  * 1. Iterate all fragments in registry
  * 2. Test EACH fragment's bounds against frustum
  * 3. Calculate screen size for fragments in frustum
- * 4. Determine LOD level (Geometry, Wires, Invisible)
+ * 4. Determine LOD level (Visible, Wires, Invisible)
  * 5. Output visible samples with LOD info for tile grouping
  *
  * Performance notes:
@@ -179,6 +180,31 @@ public:
 	 */
 	bool NeedsUpdate(const FVector& NewPosition, const FRotator& NewRotation) const;
 
+	/**
+	 * Distance beyond which a fragment is smaller than MinScreenSize (scaled by GraphicsQuality), for engine cull distances.
+	 * Inverse of the screen size test at the view of the last update (90 degrees, 1080 pixels before the first one),
+	 * measured from the bounds center instead of their closest point.
+	 * @param MaxDimension Fragment size (FFragmentVisibilityData::MaxDimension)
+	 * @return Cull distance in cm, or 0 if the fragment is never culled by size (orthographic view, show-all debug mode)
+	 */
+	float GetCullDistance(float MaxDimension) const;
+
+	/**
+	 * Cull distance per cm of fragment size at the view and thresholds GetCullDistance uses, which changes
+	 * with FOV, viewport height, GraphicsQuality and MinScreenSize. Cull distances applied earlier are stale
+	 * once it changes.
+	 * @return Scale, or 0 if nothing is culled by size
+	 */
+	float GetCullDistanceScale() const;
+
+	/**
+	 * Cull distance of a fragment at a given GetCullDistanceScale result.
+	 * @param MaxDimension Largest world-space extent of the fragment in cm
+	 * @param Scale Cull distance per cm of fragment size
+	 * @return Distance in cm, or 0 if not culled
+	 */
+	static float GetCullDistanceAtScale(float MaxDimension, float Scale);
+
 	// --- Configuration ---
 
 	/** Show all fragments regardless of frustum (debug mode) */
@@ -203,6 +229,11 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Visibility|Thresholds")
 	float MinScreenSize = 2.0f;
 
+	/** Screen size (pixels) below which a fragment is drawn as a box proxy (Wires LOD) instead of
+	 *  geometry. Fragments between MinScreenSize and this are boxes; 0 disables the tier. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Visibility|Thresholds")
+	float GeometryScreenSize = 16.0f;
+
 	/** Minimum camera movement to trigger update (cm) */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Visibility|Update")
 	float MinCameraMovement = 100.0f;  // 1 meter - matches FragmentTileManager
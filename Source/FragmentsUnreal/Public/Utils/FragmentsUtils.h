@@ -104,6 +104,38 @@ struct FTriangulationResult
 	TArray<int32> TriangleIndices;
 };
 
+/**
+ * Path a circle extrusion part sweeps its circle along.
+ */
+enum class EExtrusionPartType : uint8
+{
+	Wire,
+	WireSet,
+	CircleCurve
+};
+
+/**
+ * One part of a circle extrusion axis, extracted at load time.
+ * Positions are in Unreal coordinates (Z-up, cm).
+ */
+struct FPreExtractedExtrusionPart
+{
+	EExtrusionPartType Type = EExtrusionPartType::Wire;
+
+	// Wire: start and end point; WireSet: polyline points
+	TArray<FVector> Points;
+
+	// CircleCurve: arc center, in-plane axes, aperture (radians) and arc radius
+	FVector ArcCenter = FVector::ZeroVector;
+	FVector ArcXDirection = FVector::XAxisVector;
+	FVector ArcYDirection = FVector::YAxisVector;
+	float ArcAperture = 0.0f;
+	float ArcRadius = 0.0f;
+
+	// Radius of the swept circle
+	float Radius = 0.0f;
+};
+
 /**
  * Pre-extracted geometry data for a fragment sample.
  * Contains all geometry data extracted from FlatBuffers at load time,
@@ -126,6 +158,9 @@ struct FPreExtractedGeometry
 	// Holes per profile - ProfileHoles[i] contains holes for profile i
 	TArray<TArray<TArray<int32>>> ProfileHoles;
 
+	// Circle extrusion parts (only filled when bIsShell is false)
+	TArray<FPreExtractedExtrusionPart> ExtrusionParts;
+
 	// Local transform for this sample
 	FTransform LocalTransform;
 
@@ -142,9 +177,24 @@ struct FPreExtractedGeometry
 	// Validation flag - if false, geometry should be skipped during spawn
 	bool bIsValid = false;
 
+	// Vertices, profiles and extrusion parts were not extracted because the
+	// derived mesh cache holds the built mesh of this representation
+	bool bFromDerivedCache = false;
+
 	// Representation ID (for debugging/logging)
 	int32 RepresentationId = -1;
 
+	// Representation whose vertices this geometry holds; differs from the sample's own
+	// when it was matched to a rigidly transformed copy (derived mesh cache entries use it)
+	int32 SourceRepresentationIndex = -1;
+
+	// Content hash of the representation's FlatBuffers geometry (0 = not hashed).
+	// Equal shapes share one mesh and one instanced group across all loaded models
+	uint64 GeometryHash = 0;
+
+	// Estimated triangle count of the built mesh (instancing cost model)
+	int32 TriangleCount = 0;
+
 	FPreExtractedGeometry() = default;
 };
 
@@ -268,6 +318,7 @@ class AFragment;
  * Lightweight proxy for instanced BIM elements.
  * ~200 bytes vs ~5KB for AFragment actor.
  * Used for fragments rendered via UHierarchicalInstancedStaticMeshComponent.
+ * Built on request from the model's FFragmentProxyTable row and fragment item; not stored.
  */
 USTRUCT(BlueprintType)
 struct FFragmentProxy
@@ -317,6 +368,30 @@ struct FFragmentProxy
 	FFragmentProxy() = default;
 };
 
+/**
+ * A fragment of one loaded model: the model's content hash and the fragment's LocalId.
+ * LocalIds alone repeat between models.
+ */
+struct FFragmentKey
+{
+	uint64 ModelKey = 0;
+	int32 LocalId = INDEX_NONE;
+
+	FFragmentKey() = default;
+	FFragmentKey(uint64 InModelKey, int32 InLocalId)
+		: ModelKey(InModelKey), LocalId(InLocalId) {}
+
+	bool operator==(const FFragmentKey& Other) const
+	{
+		return ModelKey == Other.ModelKey && LocalId == Other.LocalId;
+	}
+
+	friend uint32 GetTypeHash(const FFragmentKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.ModelKey), GetTypeHash(Key.LocalId));
+	}
+};
+
 /**
  * Pending instance data collected during spawn phase.
  * Used for batch instance addition after spawning completes.
@@ -325,20 +400,21 @@ struct FPendingInstanceData
 {
 	FTransform WorldTransform;
 	int32 LocalId = INDEX_NONE;
-	FString GlobalId;
-	FString Category;
-	FString ModelGuid;
-	TArray<FItemAttribute> Attributes;
+	/** Index of the fragment's item in its model (UFragmentModelWrapper::GetItemIndex); strings and attributes are read from there */
+	int32 ItemIndex = INDEX_NONE;
+	/** Content hash of the fragment's model (FFragmentKey::ModelKey) */
+	uint64 ModelKey = 0;
+	/** Sample color, written to the instance custom data in shared color material mode */
+	FColor Color = FColor::White;
 
 	FPendingInstanceData() = default;
-	FPendingInstanceData(const FTransform& InTransform, int32 InLocalId, const FString& InGlobalId,
-		const FString& InCategory, const FString& InModelGuid, const TArray<FItemAttribute>& InAttributes)
-		: WorldTransform(InTransform), LocalId(InLocalId), GlobalId(InGlobalId),
-		  Category(InCategory), ModelGuid(InModelGuid), Attributes(InAttributes) {}
+	FPendingInstanceData(const FTransform& InTransform, int32 InLocalId, int32 InItemIndex, uint64 InModelKey,
+		const FColor& InColor = FColor::White)
+		: WorldTransform(InTransform), LocalId(InLocalId), ItemIndex(InItemIndex), ModelKey(InModelKey), Color(InColor) {}
 };
 
 /**
- * HISMC group for a RepresentationId + Material combination.
+ * HISMC group for a geometry + Material combination.
  * Each unique geometry+material pair gets one HISMC containing all instances.
  * Uses Hierarchical ISM for per-cluster culling performance.
  */
@@ -351,11 +427,11 @@ struct FInstancedMeshGroup
 	UPROPERTY()
 	class UHierarchicalInstancedStaticMeshComponent* ISMC = nullptr;
 
-	/** RepresentationId from FlatBuffers (unique geometry ID) */
+	/** Geometry content hash shared by all instances (FPreExtractedGeometry::GeometryHash) */
 	UPROPERTY()
-	int32 RepresentationId = INDEX_NONE;
+	uint64 MeshKey = 0;
 
-	/** Hash of material properties (color + glass flag) */
+	/** Hash of material properties (color + glass flag; only the glass flag in shared color material mode) */
 	UPROPERTY()
 	uint32 MaterialHash = 0;
 
@@ -369,9 +445,33 @@ struct FInstancedMeshGroup
 	/** Map from BIM LocalId to ISMC instance index */
 	TMap<int32, int32> LocalIdToInstance;
 
-	/** Pending instances to be batch-added (collected during spawn phase) */
+	/** Fragment owning each HISMC instance, in instance order (kept in step with swap-removes) */
+	TArray<FFragmentKey> InstanceOwners;
+
+	/** Instances of hidden fragments, out of the HISMC until their fragment is shown */
+	TMap<FFragmentKey, TArray<FPendingInstanceData>> HiddenInstances;
+
+	/** Fragments whose instances leave the HISMC at the next flush (true = keep them as hidden, false = drop) */
+	TMap<FFragmentKey, bool> PendingRemovals;
+
+	/** Hidden fragments whose instances return to the HISMC at the next flush */
+	TSet<FFragmentKey> PendingShows;
+
+	/** Pending instances to be batch-added (collected during spawn phase, or staged for a finalized HISMC) */
 	TArray<FPendingInstanceData> PendingInstances;
 
+	/** Bumped when pending instances are removed; batches prepared on workers before that are discarded */
+	uint32 PendingRevision = 0;
+
+	/** Instance end cull distance applied to the HISMC (0 = not culled), from MaxInstanceDimension */
+	float CullDistance = 0.0f;
+
+	/** Largest registry size (MaxDimension) among the instances added so far */
+	float MaxInstanceDimension = 0.0f;
+
+	/** An instance without registry bounds was added: the group is never culled by distance */
+	bool bNeverCull = false;
+
 	/** Cached mesh for batch creation */
 	UPROPERTY()
 	class UStaticMesh* CachedMesh = nullptr;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FPreExtractedGeometry;
+
+/**
+ * Pose-independent description of a shell: the rigid frame that moves the shell's
+ * centroid to the origin and its principal axes onto X/Y/Z, and the shell's vertices
+ * in that frame.
+ *
+ * Two shells whose canonical forms match differ only by a rotation and translation,
+ * so one can be drawn with the other's mesh: OtherFrame.Inverse() * Frame maps the
+ * other shell's vertices onto this one.
+ */
+struct FShellCanonicalForm
+{
+	/** Maps canonical coordinates to the shell's own coordinates (rotation and translation only) */
+	FTransform Frame = FTransform::Identity;
+
+	/**
+	 * Bucket key: vertex count, loop sizes and canonical extents rounded to a coarse step.
+	 * Independent of vertex, profile and hole order. Matching shapes share it; shapes
+	 * sharing it still need Matches() (0 = not computed).
+	 */
+	uint64 ShapeHash = 0;
+
+	/** Vertices in canonical coordinates, same order as the source geometry */
+	TArray<FVector> CanonicalVertices;
+
+	/**
+	 * Compute the canonical form of an extracted shell.
+	 *
+	 * Isolated principal axes are taken from the vertex covariance, their sign from the
+	 * third moment. Axes in a degenerate plane (square columns, cubes) are taken from the
+	 * vertex farthest from the fixed axis instead; for symmetric shapes any of the tied
+	 * candidates gives the same canonical shape.
+	 *
+	 * @param Geometry Shell with extracted vertices and profiles
+	 * @param Tolerance Largest vertex deviation (cm) still considered the same shape
+	 * @param OutForm Receives the frame, key and canonical vertices
+	 * @return false if the shell has no vertices or profiles, or has no stable frame
+	 */
+	static bool Compute(const FPreExtractedGeometry& Geometry, double Tolerance, FShellCanonicalForm& OutForm);
+
+	/**
+	 * Check that two shells are the same shape: every vertex lies within Tolerance of a
+	 * vertex of the other in canonical coordinates, and the profiles and holes connect
+	 * matching vertices in the same winding.
+	 * @param Geometry Shell this form was computed from
+	 * @param Other Form of the candidate shell
+	 * @param OtherGeometry Shell Other was computed from
+	 * @param Tolerance Same tolerance both forms were computed with
+	 * @return true if Geometry can be drawn with OtherGeometry's mesh
+	 */
+	bool Matches(const FPreExtractedGeometry& Geometry, const FShellCanonicalForm& Other,
+		const FPreExtractedGeometry& OtherGeometry, double Tolerance) const;
+};
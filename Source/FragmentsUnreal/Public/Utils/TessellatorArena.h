@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "tesselator.h"
+
+/**
+ * Per-thread bump allocator for libtess2.
+ *
+ * libtess2 builds its mesh, edge dictionary and priority queue from many small
+ * allocations. Routing them through a TESSalloc that bumps into blocks owned by
+ * the calling thread turns each polygon into a handful of pointer increments;
+ * frees are no-ops and the whole arena is rewound before the next polygon.
+ *
+ * Also owns the scratch buffer used to feed contours into the tesselator so
+ * triangulating a wall with openings does not touch the heap once warmed up.
+ *
+ * Not thread-safe by design: always go through Get() to obtain the instance
+ * owned by the current thread.
+ */
+class FRAGMENTSUNREAL_API FTessellatorArena
+{
+public:
+	FTessellatorArena();
+	~FTessellatorArena();
+
+	FTessellatorArena(const FTessellatorArena&) = delete;
+	FTessellatorArena& operator=(const FTessellatorArena&) = delete;
+
+	/** Arena owned by the calling thread (created on first use) */
+	static FTessellatorArena& Get();
+
+	/**
+	 * Rewind the arena and return a fresh tesselator living inside it.
+	 * The previous tesselator returned by this arena becomes invalid.
+	 * Never call tessDeleteTess on the result; the next Acquire() reclaims it.
+	 * @return Tesselator ready for tessAddContour, or nullptr on failure
+	 */
+	TESStesselator* Acquire();
+
+	/** Bytes currently reserved by the arena blocks */
+	int64 GetReservedBytes() const;
+
+	/** Interleaved XY floats handed to tessAddContour */
+	TArray<float> ContourScratch;
+
+private:
+	struct FBlock
+	{
+		uint8* Data = nullptr;
+		SIZE_T Size = 0;
+		SIZE_T Used = 0;
+	};
+
+	/** Rewind all blocks; coalesce into one block if the last polygon overflowed */
+	void Reset();
+
+	void* Allocate(SIZE_T Size);
+
+	static void* TessAlloc(void* UserData, unsigned int Size);
+	static void* TessRealloc(void* UserData, void* Ptr, unsigned int Size);
+	static void TessFree(void* UserData, void* Ptr);
+
+	TArray<FBlock> Blocks;
+	int32 CurrentBlock = 0;
+	TESSalloc AllocDesc;
+
+	/** Default block size; grows to the high-water mark of previous polygons */
+	static constexpr SIZE_T DefaultBlockSize = 64 * 1024;
+};
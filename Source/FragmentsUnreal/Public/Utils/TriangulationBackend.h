@@ -0,0 +1,140 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Utils/FragmentsUtils.h"
+#include "TriangulationBackend.generated.h"
+
+/**
+ * Triangulation backend used for profiles with holes.
+ */
+UENUM(BlueprintType)
+enum class ETriangulationBackend : uint8
+{
+	/** Pick per polygon: ear clipping for small polygons, libtess2 otherwise or on failure */
+	Auto,
+
+	/** Always use the libtess2 sweep-line tesselator */
+	LibTess2,
+
+	/** Always use ear clipping with hole bridging (falls back to libtess2 on failure) */
+	EarClipping
+};
+
+/**
+ * A profile with holes projected to its 2D plane, ready to be triangulated.
+ * Contours are deduplicated, non-degenerate and wound outer CCW / holes CW.
+ */
+struct FTriangulationPolygon
+{
+	/** Plane used to project the source points */
+	FPlaneProjection Projection;
+
+	/** Projected points of all contours, outer first */
+	TArray<FVector2D> Points2D;
+
+	/** Index into the caller's point array for each entry of Points2D */
+	TArray<int32> SourceIndices;
+
+	/** Start offset in Points2D of each contour; the last entry is Points2D.Num() */
+	TArray<int32> ContourStarts;
+
+	/** True if the outer contour was authored clockwise around the projection normal and reversed */
+	bool bOuterReversed = false;
+
+	int32 GetContourCount() const { return ContourStarts.Num() - 1; }
+	int32 GetContourStart(int32 Contour) const { return ContourStarts[Contour]; }
+	int32 GetContourNum(int32 Contour) const { return ContourStarts[Contour + 1] - ContourStarts[Contour]; }
+
+	/** Normal of the projection plane; triangulated output is CCW around it */
+	FVector GetPlaneNormal() const { return FVector::CrossProduct(Projection.AxisX, Projection.AxisY); }
+
+	void Reset()
+	{
+		bOuterReversed = false;
+		Points2D.Reset();
+		SourceIndices.Reset();
+		ContourStarts.Reset();
+		ContourStarts.Add(0);
+	}
+};
+
+/**
+ * Triangulates a prepared polygon with holes.
+ * Backends append the polygon's points to OutVertices as one ring (in Points2D
+ * order, so every triangle shares them), followed by any vertex the backend had
+ * to create. Triangles are CCW around the projection plane normal.
+ */
+class FRAGMENTSUNREAL_API ITriangulationBackend
+{
+public:
+	virtual ~ITriangulationBackend() = default;
+
+	/**
+	 * @param Polygon Prepared polygon (outer contour plus holes)
+	 * @param Points Source points the polygon was built from
+	 * @param OutVertices Receives the point ring plus created vertices
+	 * @param OutIndices Receives triangle indices into OutVertices
+	 * @return false if the backend could not triangulate the polygon
+	 */
+	virtual bool Triangulate(const FTriangulationPolygon& Polygon, const TArray<FVector>& Points,
+		TArray<FVector>& OutVertices, TArray<int32>& OutIndices) = 0;
+
+	virtual const TCHAR* GetName() const = 0;
+};
+
+/**
+ * Entry point for polygon-with-holes triangulation.
+ * Prepares contours once and dispatches to the selected backend.
+ */
+class FRAGMENTSUNREAL_API FTriangulation
+{
+public:
+	/**
+	 * Triangulate a profile with holes.
+	 * @param Mode Backend to use (Auto selects per polygon)
+	 * @param Points Shell points
+	 * @param Profile Indices of the outer contour
+	 * @param Holes Indices of each hole contour
+	 * @param OutVertices Receives the output vertex positions
+	 * @param OutIndices Receives triangle indices into OutVertices
+	 * @return true if triangles were produced
+	 */
+	static bool Triangulate(ETriangulationBackend Mode,
+		const TArray<FVector>& Points,
+		const TArray<int32>& Profile,
+		const TArray<TArray<int32>>& Holes,
+		TArray<FVector>& OutVertices,
+		TArray<int32>& OutIndices);
+
+	/**
+	 * Triangulate an already prepared polygon.
+	 * Ear clipping failures fall back to libtess2.
+	 * @return true if triangles were produced
+	 */
+	static bool TriangulatePrepared(ETriangulationBackend Mode,
+		const FTriangulationPolygon& Polygon,
+		const TArray<FVector>& Points,
+		TArray<FVector>& OutVertices,
+		TArray<int32>& OutIndices);
+
+	/**
+	 * Project, clean and orient the contours of a profile.
+	 * @return false if the outer contour is degenerate
+	 */
+	static bool PreparePolygon(const TArray<FVector>& Points,
+		const TArray<int32>& Profile,
+		const TArray<TArray<int32>>& Holes,
+		FTriangulationPolygon& OutPolygon);
+
+	/** Backend Auto would pick for a prepared polygon */
+	static ETriangulationBackend SelectBackend(const FTriangulationPolygon& Polygon);
+
+	/** Backend instance for an explicit mode (Auto maps to libtess2) */
+	static ITriangulationBackend& GetBackend(ETriangulationBackend Mode);
+
+	/** Polygons with more points than this (holes included) go to libtess2 in Auto mode */
+	static constexpr int32 EarClippingMaxPoints = 64;
+
+	/** Polygons with more holes than this go to libtess2 in Auto mode */
+	static constexpr int32 EarClippingMaxHoles = 8;
+};